@@ -0,0 +1,504 @@
+#include "benchmark.h"
+#include "deviation.h"
+#include "ledger.h"
+#include "options.h"
+#include "simulator.h"
+#include "strategy.h"
+#include "table.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+
+// ==================== СЧЕТЧИК ВЫДЕЛЕНИЙ ====================
+
+namespace {
+    thread_local uint64_t allocationCount = 0; ///< Выделений в потоке
+    thread_local uint64_t allocationBytes = 0; ///< Байт выделено в потоке
+
+    /// Приемник результатов, чтобы компилятор не выбросил измеряемый код
+    volatile uint64_t benchmarkSink = 0;
+}
+
+#ifdef BLACKJACK_COUNT_ALLOCATIONS
+
+namespace {
+    void* countedAlloc(std::size_t size) noexcept {
+        ++allocationCount;
+        allocationBytes += size;
+        return std::malloc(size ? size : 1);
+    }
+
+    void* countedAlignedAlloc(std::size_t size, std::align_val_t alignment) noexcept {
+        ++allocationCount;
+        allocationBytes += size;
+        size_t align = static_cast<size_t>(alignment);
+#ifdef _MSC_VER
+        return _aligned_malloc(size ? size : 1, align);
+#else
+        // aligned_alloc требует размер, кратный выравниванию
+        size_t rounded = (size + align - 1) / align * align;
+        return std::aligned_alloc(align, rounded ? rounded : align);
+#endif
+    }
+
+    void alignedFree(void* memory) noexcept {
+#ifdef _MSC_VER
+        _aligned_free(memory);
+#else
+        std::free(memory);
+#endif
+    }
+}
+
+void* operator new(std::size_t size) {
+    if (void* memory = countedAlloc(size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    if (void* memory = countedAlignedAlloc(size, alignment)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return countedAlignedAlloc(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return countedAlignedAlloc(size, alignment);
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+
+void operator delete(void* memory, std::align_val_t) noexcept { alignedFree(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { alignedFree(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { alignedFree(memory); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept { alignedFree(memory); }
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept { alignedFree(memory); }
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept { alignedFree(memory); }
+
+bool allocationsCounted() {
+    return true;
+}
+
+#else
+
+bool allocationsCounted() {
+    return false;
+}
+
+#endif
+
+AllocationCounters currentAllocations() {
+    AllocationCounters counters;
+    counters.count = allocationCount;
+    counters.bytes = allocationBytes;
+    return counters;
+}
+
+// ==================== НАБОР БЕНЧМАРКОВ ====================
+
+/**
+ * @brief Набор рук для бенчмарков подсчета очков: от 2 до 5 карт из перемешанных колод
+ */
+template <typename Hand>
+static std::vector<Hand> makeHands(std::mt19937& generator, size_t count) {
+    std::vector<Hand> hands;
+    for (size_t i = 0; i < count; ++i) {
+        Deck deck;
+        deck.shuffle(generator);
+        hands.emplace_back();
+        size_t cards = 2 + i % 4;
+        for (size_t c = 0; c < cards; ++c) {
+            hands.back().addCard(deck.drawCard());
+        }
+    }
+    return hands;
+}
+
+/**
+ * @brief Игрок с именем по умолчанию (для makeHands)
+ */
+struct BenchPlayer : Player {
+    BenchPlayer() : Player("Bench") {}
+};
+
+BenchmarkSuite::BenchmarkSuite(uint32_t seed) {
+    std::mt19937 generator(seed);
+
+    auto cards = std::make_shared<std::vector<Card>>(Deck().getCards());
+    auto players = std::make_shared<std::vector<BenchPlayer>>(makeHands<BenchPlayer>(generator, 64));
+    auto dealers = std::make_shared<std::vector<Dealer>>(makeHands<Dealer>(generator, 64));
+
+    // ---------- Карты ----------
+    add("card.getValue", [cards](uint64_t iterations) {
+        uint64_t sum = 0;
+        size_t index = 0;
+        for (uint64_t i = 0; i < iterations; ++i) {
+            sum += (*cards)[index].getValue();
+            if (++index == cards->size()) index = 0;
+        }
+        benchmarkSink = sum;
+    });
+
+    add("card.toString", [cards](uint64_t iterations) {
+        uint64_t sum = 0;
+        size_t index = 0;
+        for (uint64_t i = 0; i < iterations; ++i) {
+            sum += (*cards)[index].toString().size();
+            if (++index == cards->size()) index = 0;
+        }
+        benchmarkSink = sum;
+    });
+
+    add("card.getAsASCII", [cards](uint64_t iterations) {
+        uint64_t sum = 0;
+        size_t index = 0;
+        for (uint64_t i = 0; i < iterations; ++i) {
+            sum += (*cards)[index].getAsASCII().size();
+            if (++index == cards->size()) index = 0;
+        }
+        benchmarkSink = sum;
+    });
+
+    // ---------- Колода ----------
+    auto deckGenerator = std::make_shared<std::mt19937>(seed);
+    auto shuffled = std::make_shared<Deck>();
+    add("deck.shuffle", [deckGenerator, shuffled](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            shuffled->shuffle(*deckGenerator);
+        }
+        benchmarkSink = shuffled->getCards().back().getValue();
+    });
+
+    // Операция - одна карта; пустая колода восстанавливается копией без выделений
+    auto fullDeck = std::make_shared<Deck>();
+    fullDeck->shuffle(generator);
+    auto drawDeck = std::make_shared<Deck>(*fullDeck);
+    add("deck.drawCard", [fullDeck, drawDeck](uint64_t iterations) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < iterations; ++i) {
+            if (drawDeck->isEmpty()) {
+                *drawDeck = *fullDeck;
+            }
+            sum += drawDeck->drawCard().getValue();
+        }
+        benchmarkSink = sum;
+    });
+
+    // То же с шансами побочных ставок: выдача и запрос преимущества 21+3 на каждую карту
+    auto trackedFull = std::make_shared<Deck>(*fullDeck);
+    trackedFull->trackSideBets(true);
+    auto trackedDeck = std::make_shared<Deck>(*trackedFull);
+    add("deck.drawCard+sideBets", [trackedFull, trackedDeck](uint64_t iterations) {
+        double sum = 0.0;
+        for (uint64_t i = 0; i < iterations; ++i) {
+            if (trackedDeck->size() < 3) {
+                *trackedDeck = *trackedFull;
+            }
+            trackedDeck->drawCard();
+            sum += trackedDeck->getSideBets().twentyOnePlusThree().houseEdge;
+        }
+        benchmarkSink = static_cast<uint64_t>(sum);
+    });
+
+    // ---------- Игрок и дилер ----------
+    add("player.calculateScore", [players](uint64_t iterations) {
+        uint64_t sum = 0;
+        size_t index = 0;
+        for (uint64_t i = 0; i < iterations; ++i) {
+            sum += (*players)[index].calculateScore();
+            if (++index == players->size()) index = 0;
+        }
+        benchmarkSink = sum;
+    });
+
+    add("player.isBusted", [players](uint64_t iterations) {
+        uint64_t sum = 0;
+        size_t index = 0;
+        for (uint64_t i = 0; i < iterations; ++i) {
+            sum += (*players)[index].isBusted() ? 1 : 0;
+            if (++index == players->size()) index = 0;
+        }
+        benchmarkSink = sum;
+    });
+
+    add("player.getLegalActions", [players](uint64_t iterations) {
+        uint64_t sum = 0;
+        size_t index = 0;
+        for (uint64_t i = 0; i < iterations; ++i) {
+            sum += (*players)[index].getLegalActions().getMask();
+            if (++index == players->size()) index = 0;
+        }
+        benchmarkSink = sum;
+    });
+
+    add("dealer.mustDrawCard", [dealers](uint64_t iterations) {
+        uint64_t sum = 0;
+        size_t index = 0;
+        for (uint64_t i = 0; i < iterations; ++i) {
+            sum += (*dealers)[index].mustDrawCard() ? 1 : 0;
+            if (++index == dealers->size()) index = 0;
+        }
+        benchmarkSink = sum;
+    });
+
+    // ---------- Ставки ----------
+    // Операция - прием ставок и расчет одной пачкой 1024 столов по 4 места.
+    // Счета пополнены с запасом, чтобы проигрышные места не разорились за замер
+    constexpr size_t LEDGER_TABLES = 1024;
+    auto ledger = std::make_shared<ChipLedger>();
+    auto results = std::make_shared<std::vector<WagerResult>>();
+    for (size_t i = 0; i < LEDGER_TABLES * Table::MAX_SEATS; ++i) {
+        ledger->openAccount(Chips(1) << 50);
+        results->push_back(static_cast<WagerResult>(generator() % 4));
+    }
+    add("ledger.settle/" + std::to_string(LEDGER_TABLES) + "x4", [ledger, results](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            for (uint32_t account = 0; account < results->size(); ++account) {
+                size_t wager = 0;
+                ledger->placeBet(account, DEFAULT_BET, wager);
+                ledger->setResult(wager, (*results)[account]);
+            }
+            ledger->settle();
+        }
+        benchmarkSink = static_cast<uint64_t>(ledger->getHouse());
+    });
+
+    // ---------- Полный раунд ----------
+    // Неинтерактивный раунд сервера: раздача, базовая стратегия, ход дилера, итоги
+    for (size_t seats : { static_cast<size_t>(1), Table::MAX_SEATS }) {
+        auto table = std::make_shared<Table>(1, seats, seed);
+        add("table.round/" + std::to_string(seats), [table](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; ++i) {
+                table->startRound();
+                while (!table->isRoundOver()) {
+                    uint8_t seat = table->getActiveSeat();
+                    PlayerAction action = basicStrategyAction(table->getSeats()[seat],
+                        table->getDealer().getHand()[0]);
+                    table->applyDecision(seat, static_cast<uint8_t>(action));
+                }
+            }
+            benchmarkSink = table->getRoundId();
+        });
+    }
+
+    // Раунд симулятора из 6-колодного шуза, перемешивание по отрезной карте входит в замер
+    auto simulator = std::make_shared<RoundSimulator>(SimulationRules());
+    auto simulatorGenerator = std::make_shared<std::mt19937>(seed);
+    simulator->shuffle(*simulatorGenerator);
+    add("simulator.round", [simulator, simulatorGenerator](uint64_t iterations) {
+        Chips sum = 0;
+        for (uint64_t i = 0; i < iterations; ++i) {
+            if (simulator->needsShuffle()) {
+                simulator->shuffle(*simulatorGenerator);
+            }
+            sum += simulator->playRound(CHIP_SCALE, 8 * CHIP_SCALE, *simulatorGenerator);
+        }
+        benchmarkSink = static_cast<uint64_t>(sum);
+    });
+
+    // Шуз с истинным счетом +2 и 16 против 10: Stand и Hit на одних картах
+    auto conditioned = std::make_shared<CountConditionedShoe>(SimulationRules(), 3.0);
+    auto decisionSimulator = std::make_shared<RoundSimulator>(SimulationRules());
+    auto decisionGenerator = std::make_shared<std::mt19937>(seed);
+    auto decisionSeed = std::make_shared<uint64_t>(seed);
+    add("deviation.deal", [conditioned, decisionSimulator, decisionGenerator, decisionSeed](uint64_t iterations) {
+        const Card known[3] = { Card(Suit::Hearts, Rank::Ten), Card(Suit::Spades, Rank::Six), Card(Suit::Clubs, Rank::Ten) };
+        Chips sum = 0;
+        for (uint64_t i = 0; i < iterations; ++i) {
+            conditioned->build(known, 3, 2, (*decisionSeed)++);
+            sum += decisionSimulator->playDecision(conditioned->getShoe(), known[0], known[1], known[2],
+                PlayerAction::Stand, CHIP_SCALE, *decisionGenerator);
+            sum -= decisionSimulator->playDecision(conditioned->getShoe(), known[0], known[1], known[2],
+                PlayerAction::Hit, CHIP_SCALE, *decisionGenerator);
+        }
+        benchmarkSink = static_cast<uint64_t>(sum);
+    });
+}
+
+void BenchmarkSuite::add(const std::string& name, Body body) {
+    benchmarks_.emplace_back(name, std::move(body));
+}
+
+// ==================== ЗАМЕРЫ ====================
+
+BenchmarkResult BenchmarkSuite::measure(const std::string& name, const Body& body,
+    const BenchmarkConfig& config) const {
+    using Clock = std::chrono::steady_clock;
+
+    auto timeRun = [&body](uint64_t iterations) {
+        auto start = Clock::now();
+        body(iterations);
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    };
+
+    // Подбор числа операций: растем, пока замер не займет minTimeMs
+    double targetNs = config.minTimeMs * 1e6;
+    uint64_t iterations = 1;
+    while (true) {
+        double elapsed = timeRun(iterations);
+        if (elapsed >= targetNs || iterations >= (1ull << 40)) {
+            break;
+        }
+        double scale = (elapsed > 0.0) ? targetNs * 1.2 / elapsed : 100.0;
+        scale = std::min(std::max(scale, 2.0), 100.0);
+        iterations = static_cast<uint64_t>(iterations * scale);
+    }
+
+    BenchmarkResult result;
+    result.name = name;
+    result.iterations = iterations;
+
+    // Выделения - по всем повторам: разовое выделение в одном повторе не теряется
+    int repetitions = std::max(config.repetitions, 1);
+    std::vector<double> samples;
+    samples.reserve(repetitions); // Выделение до замера - не в счет
+    AllocationCounters before = currentAllocations();
+    for (int rep = 0; rep < repetitions; ++rep) {
+        samples.push_back(timeRun(iterations) / iterations);
+    }
+    AllocationCounters after = currentAllocations();
+    double operations = static_cast<double>(iterations) * repetitions;
+    result.allocsPerOp = static_cast<double>(after.count - before.count) / operations;
+    result.bytesPerOp = static_cast<double>(after.bytes - before.bytes) / operations;
+
+    std::sort(samples.begin(), samples.end());
+    result.nsPerOp = samples[samples.size() / 2];
+    result.minNsPerOp = samples.front();
+    return result;
+}
+
+std::vector<BenchmarkResult> BenchmarkSuite::run(const BenchmarkConfig& config) const {
+    std::vector<BenchmarkResult> results;
+    for (const auto& benchmark : benchmarks_) {
+        if (!config.filter.empty() && benchmark.first.find(config.filter) == std::string::npos) {
+            continue;
+        }
+        results.push_back(measure(benchmark.first, benchmark.second, config));
+    }
+    return results;
+}
+
+// ==================== ОТЧЕТЫ ====================
+
+void BenchmarkSuite::printReport(std::ostream& os, const std::vector<BenchmarkResult>& results) {
+    os << "\n=== MICROBENCHMARKS ===\n";
+    os << std::left << std::setw(30) << "Benchmark"
+        << std::right << std::setw(12) << "ns/op"
+        << std::setw(12) << "min ns/op"
+        << std::setw(12) << "allocs/op"
+        << std::setw(12) << "bytes/op"
+        << std::setw(14) << "iterations" << "\n";
+
+    os << std::fixed;
+    for (const auto& result : results) {
+        os << std::left << std::setw(30) << result.name << std::right
+            << std::setprecision(2) << std::setw(12) << result.nsPerOp
+            << std::setw(12) << result.minNsPerOp;
+        if (allocationsCounted()) {
+            os << std::setw(12) << result.allocsPerOp
+                << std::setprecision(1) << std::setw(12) << result.bytesPerOp;
+        }
+        else {
+            os << std::setw(12) << "-" << std::setw(12) << "-";
+        }
+        os << std::setw(14) << result.iterations << "\n";
+    }
+    if (!allocationsCounted()) {
+        os << "(allocations are counted only in a build with BLACKJACK_COUNT_ALLOCATIONS)\n";
+    }
+}
+
+void BenchmarkSuite::writeJson(std::ostream& os, const BenchmarkConfig& config,
+    const std::vector<BenchmarkResult>& results) {
+    os << std::setprecision(6) << std::defaultfloat;
+    os << "{\n";
+    os << "  \"min_time_ms\": " << config.minTimeMs << ",\n";
+    os << "  \"repetitions\": " << config.repetitions << ",\n";
+    os << "  \"seed\": " << config.seed << ",\n";
+    os << "  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& result = results[i];
+        os << "    {\"name\": \"" << result.name << "\""
+            << ", \"iterations\": " << result.iterations
+            << ", \"ns_per_op\": " << result.nsPerOp
+            << ", \"min_ns_per_op\": " << result.minNsPerOp
+            << ", \"allocs_per_op\": ";
+        // null - выделения не считались, чтобы сравнение релизов не приняло их за ноль
+        if (allocationsCounted()) {
+            os << result.allocsPerOp << ", \"bytes_per_op\": " << result.bytesPerOp;
+        }
+        else {
+            os << "null, \"bytes_per_op\": null";
+        }
+        os << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n";
+    os << "}\n";
+}
+
+// ==================== ТОЧКА ВХОДА ====================
+
+int runBenchmarks(int argc, char* argv[]) {
+    CommandLine options(argc, argv);
+
+    BenchmarkConfig config;
+    config.filter = options.getString("filter", "");
+    config.minTimeMs = options.getDouble("min-time", config.minTimeMs);
+    config.repetitions = static_cast<int>(options.getInt("repetitions", config.repetitions));
+    config.seed = static_cast<uint32_t>(options.getInt("seed", config.seed));
+    config.jsonPath = options.getString("json", "");
+
+    BenchmarkSuite suite(config.seed);
+    std::vector<BenchmarkResult> results = suite.run(config);
+    if (results.empty()) {
+        std::cerr << "No benchmarks match filter \"" << config.filter << "\".\n";
+        return 1;
+    }
+
+    BenchmarkSuite::printReport(std::cout, results);
+
+    if (!config.jsonPath.empty()) {
+        std::ofstream file(config.jsonPath);
+        if (!file) {
+            std::cerr << "Failed to write " << config.jsonPath << ".\n";
+            return 1;
+        }
+        BenchmarkSuite::writeJson(file, config, results);
+        std::cout << "JSON report written to " << config.jsonPath << "\n";
+    }
+    return 0;
+}
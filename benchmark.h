@@ -0,0 +1,112 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Счетчики выделений памяти текущего потока
+ *
+ * Считаются заменой глобального operator new (benchmark.cpp) только
+ * в сборке с BLACKJACK_COUNT_ALLOCATIONS: замена действует во всей
+ * программе (сервер, симуляции) и под санитайзером прячет его проверки
+ * new/delete, поэтому в обычной сборке ее нет, а счетчики нулевые.
+ */
+struct AllocationCounters {
+    uint64_t count = 0; ///< Число выделений
+    uint64_t bytes = 0; ///< Выделено байт
+};
+
+/**
+ * @brief Счетчики выделений памяти текущего потока с начала работы
+ */
+AllocationCounters currentAllocations();
+
+/**
+ * @brief Считаются ли выделения (сборка с BLACKJACK_COUNT_ALLOCATIONS)
+ */
+bool allocationsCounted();
+
+/**
+ * @brief Параметры прогона микробенчмарков
+ */
+struct BenchmarkConfig {
+    std::string filter;        ///< Подстрока имени (пусто - все)
+    double minTimeMs = 200.0;  ///< Минимальное время одного замера
+    int repetitions = 5;       ///< Повторов замера (в отчет идет медиана)
+    uint32_t seed = 42;        ///< Зерно данных и перемешиваний
+    std::string jsonPath;      ///< Файл JSON-отчета (пусто - без файла)
+};
+
+/**
+ * @brief Результат одного микробенчмарка
+ */
+struct BenchmarkResult {
+    std::string name;          ///< Имя
+    uint64_t iterations = 0;   ///< Операций в одном замере
+    double nsPerOp = 0.0;      ///< Медиана наносекунд на операцию
+    double minNsPerOp = 0.0;   ///< Лучший замер
+    double allocsPerOp = 0.0;  ///< Выделений памяти на операцию (по всем повторам)
+    double bytesPerOp = 0.0;   ///< Байт выделено на операцию (по всем повторам)
+};
+
+/**
+ * @brief Набор микробенчмарков горячих путей игры
+ *
+ * Каждый бенчмарк - функция, выполняющая заданное число операций.
+ * Число операций подбирается так, чтобы замер длился не меньше
+ * minTimeMs; замер повторяется, в отчет идет медиана и минимум.
+ * Подготовка данных делается до замера и в результат не входит.
+ */
+class BenchmarkSuite {
+public:
+    using Body = std::function<void(uint64_t iterations)>; ///< Тело бенчмарка
+
+    /**
+     * @brief Конструктор регистрирует стандартные бенчмарки
+     * @param seed Зерно данных и перемешиваний
+     */
+    explicit BenchmarkSuite(uint32_t seed);
+
+    /**
+     * @brief Зарегистрировать бенчмарк
+     * @param name Имя вида "модуль.операция"
+     * @param body Тело, выполняющее iterations операций
+     */
+    void add(const std::string& name, Body body);
+
+    /**
+     * @brief Выполнить бенчмарки, подходящие под фильтр
+     * @param config Параметры прогона
+     * @return Результаты в порядке регистрации
+     */
+    std::vector<BenchmarkResult> run(const BenchmarkConfig& config) const;
+
+    /**
+     * @brief Вывести таблицу результатов
+     */
+    static void printReport(std::ostream& os, const std::vector<BenchmarkResult>& results);
+
+    /**
+     * @brief Записать результаты в JSON для сравнения между релизами
+     */
+    static void writeJson(std::ostream& os, const BenchmarkConfig& config,
+        const std::vector<BenchmarkResult>& results);
+
+private:
+    /**
+     * @brief Замерить один бенчмарк
+     */
+    BenchmarkResult measure(const std::string& name, const Body& body, const BenchmarkConfig& config) const;
+
+    std::vector<std::pair<std::string, Body>> benchmarks_; ///< Имя и тело
+};
+
+/**
+ * @brief Точка входа режима микробенчмарков (--bench)
+ * @param argc Число аргументов
+ * @param argv Аргументы: --filter, --min-time (мс), --repetitions, --seed, --json (файл)
+ * @return Код завершения
+ */
+int runBenchmarks(int argc, char* argv[]);
@@ -0,0 +1,359 @@
+#include "compare.h"
+#include "options.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+// ==================== КОНТРОЛЬНЫЕ ПЕРЕМЕННЫЕ ====================
+
+void ControlRegression::add(int64_t response, const int64_t* controls) {
+    ++count_;
+    sumY_ += response;
+    sumYY_ += static_cast<uint64_t>(response * response);
+    for (size_t i = 0; i < CONTROLS; ++i) {
+        sumX_[i] += controls[i];
+        sumXY_[i] += controls[i] * response;
+        for (size_t j = 0; j < CONTROLS; ++j) {
+            sumXX_[i][j] += controls[i] * controls[j];
+        }
+    }
+}
+
+void ControlRegression::merge(const ControlRegression& other) {
+    count_ += other.count_;
+    sumY_ += other.sumY_;
+    sumYY_ += other.sumYY_;
+    for (size_t i = 0; i < CONTROLS; ++i) {
+        sumX_[i] += other.sumX_[i];
+        sumXY_[i] += other.sumXY_[i];
+        for (size_t j = 0; j < CONTROLS; ++j) {
+            sumXX_[i][j] += other.sumXX_[i][j];
+        }
+    }
+}
+
+bool ControlRegression::estimate(const double* means, double& estimate, double& standardError, double* beta) const {
+    if (count_ <= CONTROLS + 1) {
+        return false;
+    }
+    double n = static_cast<double>(count_);
+    double meanY = sumY_ / n;
+    double meanX[CONTROLS];
+    for (size_t i = 0; i < CONTROLS; ++i) {
+        meanX[i] = sumX_[i] / n;
+    }
+
+    // Центрированные суммы: нормальные уравнения Sxx * beta = Sxy
+    double system[CONTROLS][CONTROLS + 1];
+    for (size_t i = 0; i < CONTROLS; ++i) {
+        for (size_t j = 0; j < CONTROLS; ++j) {
+            system[i][j] = sumXX_[i][j] - n * meanX[i] * meanX[j];
+        }
+        system[i][CONTROLS] = sumXY_[i] - n * meanX[i] * meanY;
+    }
+    double sumSquaresY = static_cast<double>(sumYY_) - n * meanY * meanY;
+
+    // Гаусс-Жордан без перестановок: матрица неотрицательно определена.
+    // Крошечный ведущий элемент - переменная постоянна или выражается через прежние
+    double coefficients[CONTROLS];
+    size_t active = 0;
+    for (size_t k = 0; k < CONTROLS; ++k) {
+        double scale = sumXX_[k][k] > 0 ? static_cast<double>(sumXX_[k][k]) : 1.0;
+        if (system[k][k] <= 1e-9 * scale) {
+            for (size_t i = 0; i < CONTROLS; ++i) {
+                system[i][k] = 0.0;
+                system[k][i] = 0.0;
+            }
+            system[k][k] = 1.0;
+            system[k][CONTROLS] = 0.0;
+            continue;
+        }
+        ++active;
+        for (size_t i = 0; i < CONTROLS; ++i) {
+            if (i == k) continue;
+            double factor = system[i][k] / system[k][k];
+            for (size_t j = k; j <= CONTROLS; ++j) {
+                system[i][j] -= factor * system[k][j];
+            }
+        }
+    }
+
+    double residual = sumSquaresY;
+    estimate = meanY;
+    for (size_t i = 0; i < CONTROLS; ++i) {
+        coefficients[i] = system[i][CONTROLS] / system[i][i];
+        double centeredXY = sumXY_[i] - n * meanX[i] * meanY;
+        residual -= coefficients[i] * centeredXY;
+        estimate -= coefficients[i] * (meanX[i] - means[i]);
+        if (beta) beta[i] = coefficients[i];
+    }
+
+    double variance = std::max(residual, 0.0) / (n - static_cast<double>(active) - 1.0);
+    standardError = std::sqrt(variance / n);
+    return true;
+}
+
+// ==================== СРАВНЕНИЕ СТРАТЕГИЙ ====================
+
+namespace {
+    /**
+     * @brief Зеркальное достоинство: 2<->A, 3<->K, 4<->Q, 5<->J, 6<->10, 7<->9, 8<->8
+     */
+    Rank mirrorRank(Rank rank) {
+        return static_cast<Rank>(static_cast<int>(Rank::Two) + static_cast<int>(Rank::Ace) - static_cast<int>(rank));
+    }
+
+    bool isTen(const Card& card) { return card.getValue() == 10; }
+}
+
+bool ComparisonArm::parse(const std::string& text, ComparisonArm& arm) {
+    ComparisonArm parsed;
+    size_t slash = text.find('/');
+    if (!parseDealerStrategy(text.substr(0, slash), parsed.dealer)) {
+        return false;
+    }
+
+    if (slash != std::string::npos && !parsePlayerPolicy(text.substr(slash + 1), parsed.player)) {
+        return false;
+    }
+    arm = parsed;
+    return true;
+}
+
+std::string ComparisonArm::describe() const {
+    return std::string("dealer ") + dealerStrategyName(dealer) + ", player " + playerPolicyName(player);
+}
+
+void ComparisonTotals::merge(const ComparisonTotals& other) {
+    first.merge(other.first);
+    second.merge(other.second);
+    difference.merge(other.difference);
+    pairDifference.merge(other.pairDifference);
+    controlled.merge(other.controlled);
+}
+
+StrategyComparison::StrategyComparison(const ComparisonConfig& config)
+    : config_(config), shoe_(config.deckCount), mirrorShoe_(config.deckCount) {
+    if (config_.threads == 0) {
+        config_.threads = std::thread::hardware_concurrency();
+    }
+    if (config_.threads == 0) config_.threads = 1;
+
+    mirrorShoe_.clear();
+    for (const Card& card : shoe_.getCards()) {
+        mirrorShoe_.addCard(Card(card.getSuit(), mirrorRank(card.getRank())));
+    }
+
+    // Первые карты полного шуза равновероятны по составу: средние считаются точно
+    double cards = static_cast<double>(shoe_.size());
+    double aces = static_cast<double>(shoe_.getRemaining(Rank::Ace));
+    double tens = static_cast<double>(shoe_.getRemainingTens());
+    double points = 0.0;
+    for (const Card& card : shoe_.getCards()) {
+        points += card.getValue();
+    }
+    double natural = 2.0 * aces * tens / (cards * (cards - 1.0));
+    double perRound[ControlRegression::CONTROLS] = {
+        aces / cards,          // Туз у дилера
+        tens / cards,          // Десятка у дилера
+        2.0 * points / cards,  // Очки двух карт игрока (туз = 1)
+        natural,               // Блэкджек дилера
+        natural                // Блэкджек игрока
+    };
+    for (size_t i = 0; i < ControlRegression::CONTROLS; ++i) {
+        controlMeans_[i] = perRound[i] * (config_.antithetic ? 2.0 : 1.0);
+    }
+}
+
+void StrategyComparison::collectControls(const Card* initialCards, int64_t* controls) {
+    const Card& up = initialCards[2];
+    const Card& hole = initialCards[3];
+    controls[0] += up.isAce() ? 1 : 0;
+    controls[1] += isTen(up) ? 1 : 0;
+    controls[2] += initialCards[0].getValue() + initialCards[1].getValue();
+    controls[3] += ((up.isAce() && isTen(hole)) || (isTen(up) && hole.isAce())) ? 1 : 0;
+    controls[4] += ((initialCards[0].isAce() && isTen(initialCards[1])) ||
+        (isTen(initialCards[0]) && initialCards[1].isAce())) ? 1 : 0;
+}
+
+void StrategyComparison::run() {
+    // Повторения раздаются пачками; пачка засеяна от (seed, номер пачки)
+    constexpr uint64_t CHUNK = 256;
+    std::atomic<uint64_t> next(0);
+    std::vector<ComparisonTotals> partial(config_.threads);
+
+    SimulationRules firstRules, secondRules;
+    firstRules.deckCount = secondRules.deckCount = config_.deckCount;
+    firstRules.dealerStrategy = config_.first.dealer;
+    firstRules.playerPolicy = config_.first.player;
+    secondRules.dealerStrategy = config_.second.dealer;
+    secondRules.playerPolicy = config_.second.player;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < config_.threads; ++t) {
+        workers.emplace_back([this, &next, &partial, &firstRules, &secondRules, t]() {
+            RoundSimulator first(firstRules);
+            RoundSimulator second(secondRules);
+            CardStream stream;
+            ComparisonTotals& totals = partial[t];
+
+            uint64_t begin;
+            while ((begin = next.fetch_add(CHUNK)) < config_.replications) {
+                uint64_t chunk = begin / CHUNK;
+                std::seed_seq sequence{ config_.seed, static_cast<uint32_t>(chunk), static_cast<uint32_t>(chunk >> 32) };
+                std::mt19937 generator(sequence);
+                uint64_t end = std::min(begin + CHUNK, config_.replications);
+
+                for (uint64_t index = begin; index < end; ++index) {
+                    int64_t controls[ControlRegression::CONTROLS] = {};
+                    stream.fill(generator);
+                    Chips a = first.playFreshRound(shoe_, CHIP_SCALE, stream, generator);
+                    collectControls(first.getInitialCards(), controls);
+                    stream.rewind();
+                    Chips b = second.playFreshRound(shoe_, CHIP_SCALE, stream, generator);
+
+                    totals.first.add(a);
+                    totals.second.add(b);
+                    totals.difference.add(a - b);
+                    Chips response = a - b;
+
+                    if (config_.antithetic) {
+                        stream.rewind();
+                        Chips mirrorA = first.playFreshRound(mirrorShoe_, CHIP_SCALE, stream, generator);
+                        collectControls(first.getInitialCards(), controls);
+                        stream.rewind();
+                        Chips mirrorB = second.playFreshRound(mirrorShoe_, CHIP_SCALE, stream, generator);
+                        response += mirrorA - mirrorB;
+                        totals.pairDifference.add(response);
+                    }
+                    totals.controlled.add(response, controls);
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    totals_ = ComparisonTotals();
+    for (const auto& totals : partial) {
+        totals_.merge(totals);
+    }
+}
+
+void StrategyComparison::printReport(std::ostream& os) const {
+    const ComparisonTotals& t = totals_;
+    double scale = static_cast<double>(CHIP_SCALE);
+    double replications = static_cast<double>(t.difference.getCount());
+    if (replications < 2.0) {
+        os << "Not enough replications\n";
+        return;
+    }
+
+    // Раундов каждой стороны - база сравнения методов при равной работе
+    double roundsPerReplication = config_.antithetic ? 2.0 : 1.0;
+    double rounds = replications * roundsPerReplication;
+    double unitsPer100 = 100.0 / scale;
+
+    os << "\n=== STRATEGY COMPARISON ===\n";
+    os << "A: " << config_.first.describe() << "\n";
+    os << "B: " << config_.second.describe() << "\n";
+    os << std::fixed << std::setprecision(2);
+    os << "Shoe: " << config_.deckCount << " decks, freshly shuffled for each round | Replications: "
+        << t.difference.getCount() << (config_.antithetic ? " (with mirrored shoe)" : "")
+        << " | Rounds per strategy: " << static_cast<uint64_t>(rounds) << "\n";
+    os << "Time: " << seconds_ << " s (" << std::setprecision(0)
+        << 2.0 * rounds / (seconds_ > 0.0 ? seconds_ : 1.0) << " rounds/sec) | Threads: " << config_.threads << "\n";
+
+    os << std::setprecision(3);
+    os << "\nEV A: " << t.first.getMean() * unitsPer100 << " +/- " << 1.96 * t.first.getStdError() * unitsPer100
+        << " per 100 hands (direct rounds)\n";
+    os << "EV B: " << t.second.getMean() * unitsPer100 << " +/- " << 1.96 * t.second.getStdError() * unitsPer100
+        << " per 100 hands (direct rounds)\n";
+
+    // Стандартная ошибка разницы при одинаковом числе раундов каждой стороны
+    struct Method {
+        const char* name;
+        double estimate;
+        double perRoundVariance; ///< Дисперсия разницы в пересчете на один раунд стороны
+    };
+    std::vector<Method> methods;
+    double independentVariance = t.first.getVariance() + t.second.getVariance();
+    methods.push_back({ "Independent runs", t.difference.getMean(), independentVariance });
+    methods.push_back({ "Common random numbers", t.difference.getMean(), t.difference.getVariance() });
+
+    double estimate = 0.0, standardError = 0.0;
+    double beta[ControlRegression::CONTROLS] = {};
+    bool controlled = t.controlled.estimate(controlMeans_, estimate, standardError, beta);
+    if (config_.antithetic) {
+        // Отклик пары - сумма двух раундов: делим на 2, дисперсия на раунд - Var(пары) / 2
+        methods.push_back({ "+ antithetic shoes", t.pairDifference.getMean() / 2.0, t.pairDifference.getVariance() / 2.0 });
+        if (controlled) {
+            double variance = standardError * standardError * replications;
+            methods.push_back({ "+ control variates", estimate / 2.0, variance / 2.0 });
+        }
+    }
+    else if (controlled) {
+        methods.push_back({ "+ control variates", estimate, standardError * standardError * replications });
+    }
+
+    os << "\nDifference A - B per 100 hands, 95% interval at " << static_cast<uint64_t>(rounds)
+        << " rounds per strategy:\n";
+    os << std::left << std::setw(26) << "Method" << std::right << std::setw(11) << "Estimate"
+        << std::setw(11) << "+/-" << std::setw(13) << "Efficiency" << std::setw(18) << "Rounds for target" << "\n";
+    for (const Method& method : methods) {
+        double width = 1.96 * std::sqrt(method.perRoundVariance / rounds) * unitsPer100;
+        double efficiency = method.perRoundVariance > 0.0 ? independentVariance / method.perRoundVariance : 0.0;
+        double needed = method.perRoundVariance * std::pow(1.96 / (config_.target * scale), 2.0);
+        os << std::left << std::setw(26) << method.name << std::right
+            << std::setprecision(4) << std::setw(11) << method.estimate * unitsPer100
+            << std::setw(11) << width
+            << std::setprecision(1) << std::setw(12) << efficiency << "x"
+            << std::setprecision(0) << std::setw(18) << needed << "\n";
+    }
+    os << std::setprecision(3) << "Target: +/- " << config_.target * 100.0 << " per 100 hands (95%)\n";
+
+    if (controlled) {
+        static const char* CONTROL_NAMES[] = { "dealer ace", "dealer ten", "player points", "dealer blackjack", "player blackjack" };
+        os << "Control coefficients (chips per unit):";
+        for (size_t i = 0; i < ControlRegression::CONTROLS; ++i) {
+            os << " " << CONTROL_NAMES[i] << " " << std::setprecision(2) << beta[i] << (i + 1 < ControlRegression::CONTROLS ? "," : "\n");
+        }
+    }
+}
+
+// ==================== ТОЧКА ВХОДА ====================
+
+int runStrategyComparison(int argc, char* argv[]) {
+    CommandLine options(argc, argv);
+
+    ComparisonConfig config;
+    std::string first = options.getString("a", "standard/basic");
+    std::string second = options.getString("b", "cautious/basic");
+    config.replications = static_cast<uint64_t>(options.getInt("replications", static_cast<long long>(config.replications)));
+    config.antithetic = options.getInt("antithetic", 1) != 0;
+    config.target = options.getDouble("target", config.target * 100.0) / 100.0;
+    config.deckCount = static_cast<size_t>(options.getInt("decks", static_cast<long long>(config.deckCount)));
+    config.threads = static_cast<size_t>(options.getInt("threads", 0));
+    config.seed = static_cast<uint32_t>(options.getInt("seed", config.seed));
+
+    if (!ComparisonArm::parse(first, config.first) || !ComparisonArm::parse(second, config.second) ||
+        config.replications < 2 || config.deckCount == 0 || config.target <= 0.0) {
+        std::cerr << "Usage: --compare [--a dealer/player] [--b dealer/player] [--replications N]"
+            " [--antithetic 0|1] [--target per-100-hands] [--decks N] [--threads N] [--seed N]\n"
+            "Dealer: standard, aggressive, cautious. Player: basic, mimic, never-bust\n";
+        return 1;
+    }
+
+    StrategyComparison comparison(config);
+    comparison.run();
+    comparison.printReport(std::cout);
+    return 0;
+}
@@ -0,0 +1,163 @@
+#pragma once
+#include "dealer.h"
+#include "deck.h"
+#include "simulator.h"
+#include "strategy.h"
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+// ==================== КОНТРОЛЬНЫЕ ПЕРЕМЕННЫЕ ====================
+
+/**
+ * @brief Регрессия отклика на контрольные переменные с известным средним
+ *
+ * Копятся точные целые суммы и суммы произведений, как в RunningStats:
+ * накопители потоков сливаются в любом порядке в один результат.
+ * Оценка среднего с поправкой: y - beta * (x - mu), beta - решение
+ * нормальных уравнений по выборке. Вырожденные переменные (постоянные
+ * или линейно зависимые) получают beta = 0.
+ */
+class ControlRegression {
+public:
+    static constexpr size_t CONTROLS = 5; ///< Контрольных переменных
+
+    /**
+     * @brief Добавить наблюдение
+     * @param response Отклик
+     * @param controls Контрольные переменные (CONTROLS штук)
+     */
+    void add(int64_t response, const int64_t* controls);
+
+    /**
+     * @brief Добавить накопитель другого потока
+     */
+    void merge(const ControlRegression& other);
+
+    /**
+     * @brief Среднее отклика с поправкой на контрольные переменные
+     * @param means Известные средние контрольных переменных
+     * @param estimate [out] Среднее с поправкой
+     * @param standardError [out] Стандартная ошибка (по остаткам регрессии)
+     * @param beta [out] Коэффициенты (CONTROLS штук) или nullptr
+     * @return false если наблюдений меньше, чем нужно для оценки
+     */
+    bool estimate(const double* means, double& estimate, double& standardError, double* beta) const;
+
+    uint64_t getCount() const { return count_; }
+
+private:
+    uint64_t count_ = 0;                              ///< Наблюдений
+    int64_t sumY_ = 0;                                ///< Сумма отклика
+    uint64_t sumYY_ = 0;                              ///< Сумма квадратов отклика
+    int64_t sumX_[CONTROLS] = {};                     ///< Суммы переменных
+    int64_t sumXX_[CONTROLS][CONTROLS] = {};          ///< Суммы произведений переменных
+    int64_t sumXY_[CONTROLS] = {};                    ///< Суммы произведений переменной и отклика
+};
+
+// ==================== СРАВНЕНИЕ СТРАТЕГИЙ ====================
+
+/**
+ * @brief Сторона сравнения: стратегия дилера и стратегия игрока
+ */
+struct ComparisonArm {
+    DealerStrategy dealer = DealerStrategy::Standard; ///< Стратегия дилера
+    PlayerPolicy player = PlayerPolicy::Basic;        ///< Стратегия игрока
+
+    /**
+     * @brief Разобрать "dealer/player", например "cautious/basic" или "standard/mimic"
+     * @return false если имя неизвестно
+     */
+    static bool parse(const std::string& text, ComparisonArm& arm);
+
+    /**
+     * @brief Описание для отчета
+     */
+    std::string describe() const;
+};
+
+/**
+ * @brief Параметры сравнения
+ */
+struct ComparisonConfig {
+    size_t deckCount = 6;            ///< Колод в шузе
+    ComparisonArm first;             ///< Сторона A
+    ComparisonArm second;            ///< Сторона B
+    uint64_t replications = 1000000; ///< Повторений (пара раундов A и B, с антитетикой - две пары)
+    bool antithetic = true;          ///< Играть зеркальный шуз в каждом повторении
+    double target = 0.001;           ///< Целевая полуширина 95% интервала разницы, единиц за раунд
+    size_t threads = 0;              ///< Рабочих потоков (0 - по числу ядер)
+    uint32_t seed = 1;               ///< Зерно (пачка повторений i - свой поток чисел от seed и i)
+};
+
+/**
+ * @brief Итоги потока (или всего прогона после слияния)
+ */
+struct ComparisonTotals {
+    RunningStats first;            ///< Выигрыш A в прямом раунде
+    RunningStats second;           ///< Выигрыш B в прямом раунде
+    RunningStats difference;       ///< A - B в прямом раунде (общие случайные числа)
+    RunningStats pairDifference;   ///< A - B, сумма прямого и зеркального раунда
+    ControlRegression controlled;  ///< Разность повторения против контрольных переменных
+
+    void merge(const ComparisonTotals& other);
+};
+
+/**
+ * @brief Сравнение двух стратегий с уменьшением дисперсии
+ *
+ * Каждое повторение - раунд из свежеперетасованного полного шуза
+ * (как при непрерывной перетасовке), сыгранный обеими сторонами:
+ * - общие случайные числа: стороны получают одинаковые карты
+ *   по порядку выдачи (RoundSimulator::playFreshRound() с одним CardStream);
+ * - антитетические шузы: те же позиции карт в зеркальном шузе, где
+ *   достоинства переставлены 2<->A, 3<->K, ..., 7<->9. Перестановка
+ *   сохраняет состав полного шуза, поэтому зеркальный раунд распределен
+ *   так же, а мелкие и крупные карты меняются ролями;
+ * - контрольные переменные: функции первых четырех карт с точно
+ *   известным по составу шуза средним (туз и десятка у дилера, очки
+ *   двух карт игрока, блэкджеки игрока и дилера).
+ *
+ * Отчет сравнивает ширину 95% интервала разницы при одинаковом числе
+ * раундов: независимые прогоны, общие числа, плюс антитетика, плюс
+ * контрольные переменные. Повторения независимы, итог не зависит
+ * от числа потоков.
+ */
+class StrategyComparison {
+public:
+    explicit StrategyComparison(const ComparisonConfig& config);
+
+    /**
+     * @brief Сыграть все повторения
+     */
+    void run();
+
+    /**
+     * @brief Отчет: выигрыш сторон, разница и ее интервалы по методам
+     */
+    void printReport(std::ostream& os) const;
+
+    const ComparisonTotals& getTotals() const { return totals_; }
+
+private:
+    /**
+     * @brief Контрольные переменные по начальной раздаче
+     */
+    static void collectControls(const Card* initialCards, int64_t* controls);
+
+    ComparisonConfig config_;                              ///< Параметры
+    Deck shoe_;                                            ///< Полный шуз
+    Deck mirrorShoe_;                                      ///< Зеркальный шуз
+    double controlMeans_[ControlRegression::CONTROLS] = {}; ///< Средние контрольных переменных повторения
+    ComparisonTotals totals_;                              ///< Итоги после слияния потоков
+    double seconds_ = 0.0;                                 ///< Время прогона
+};
+
+/**
+ * @brief Точка входа режима сравнения стратегий (--compare)
+ * @param argc Число аргументов
+ * @param argv Аргументы: --a, --b (dealer/player), --replications, --antithetic (0/1),
+ *             --target, --decks, --threads, --seed
+ * @return 0 при успехе
+ */
+int runStrategyComparison(int argc, char* argv[]);
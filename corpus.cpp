@@ -0,0 +1,249 @@
+#include "corpus.h"
+#include "options.h"
+#include "protocol.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+ShoeCorpus::~ShoeCorpus() {
+    close();
+}
+
+// ==================== ЗАПИСЬ ====================
+
+bool ShoeCorpus::generate(const std::string& path, size_t deckCount, uint64_t shoes, uint32_t seed,
+    std::string& error) {
+    if (deckCount < 1 || deckCount > CORPUS_MAX_DECKS || shoes == 0) {
+        error = "invalid deck or shoe count";
+        return false;
+    }
+
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            error = "cannot create " + temporary;
+            return false;
+        }
+
+        CorpusHeader header = {};
+        header.magic = CORPUS_MAGIC;
+        header.version = CORPUS_VERSION;
+        header.deckCount = static_cast<uint16_t>(deckCount);
+        header.cardsPerShoe = static_cast<uint32_t>(52 * deckCount);
+        header.seed = seed;
+        header.shoeCount = shoes;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        // Шуз i - свежий шуз, перемешанный генератором от (seed, i), как в --solve
+        const Deck fresh(deckCount);
+        Deck shoe(deckCount);
+        std::vector<uint8_t> codes(header.cardsPerShoe);
+        for (uint64_t i = 0; i < shoes && file; ++i) {
+            std::seed_seq sequence{ seed, static_cast<uint32_t>(i), static_cast<uint32_t>(i >> 32) };
+            std::mt19937 generator(sequence);
+            shoe = fresh;
+            shoe.shuffle(generator);
+
+            const std::vector<Card>& cards = shoe.getCards();
+            for (size_t c = 0; c < cards.size(); ++c) {
+                codes[c] = encodeCard(cards[c]);
+            }
+            file.write(reinterpret_cast<const char*>(codes.data()), static_cast<std::streamsize>(codes.size()));
+        }
+        file.flush();
+        if (!file) {
+            error = "cannot write " + temporary;
+            return false;
+        }
+    }
+
+    // Читатели никогда не видят недописанный файл: замена одним вызовом, как у контрольных точек
+    if (MoveFileExA(temporary.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) == 0) {
+        error = "cannot replace " + path;
+        return false;
+    }
+    return true;
+}
+
+// ==================== ОТОБРАЖЕНИЕ ====================
+
+bool ShoeCorpus::open(const std::string& path, std::string& error) {
+    close();
+
+    file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file_, &size) || static_cast<uint64_t>(size.QuadPart) < sizeof(CorpusHeader)) {
+        error = "file is too short for a header";
+        close();
+        return false;
+    }
+
+    // Только чтение: страницы файла в кэше системы общие для всех процессов
+    mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_ != nullptr) {
+        view_ = static_cast<const uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (view_ == nullptr) {
+        error = "cannot map " + path;
+        close();
+        return false;
+    }
+
+    // Таблица кодов вместо decodeCard() на каждую карту
+    if (cardByCode_.empty()) {
+        for (uint8_t code = 0; code < CODES; ++code) {
+            Card card(Suit::Hearts, Rank::Two);
+            if (decodeCard(code, card)) {
+                validCodes_ |= uint64_t(1) << code;
+            }
+            cardByCode_.push_back(card);
+        }
+    }
+
+    std::memcpy(&header_, view_, sizeof(header_));
+    uint64_t body = static_cast<uint64_t>(size.QuadPart) - sizeof(CorpusHeader);
+    if (header_.magic != CORPUS_MAGIC || header_.version != CORPUS_VERSION) {
+        error = "not a shoe corpus file (or another format version)";
+    }
+    else if (header_.deckCount < 1 || header_.deckCount > CORPUS_MAX_DECKS ||
+        header_.cardsPerShoe != 52u * header_.deckCount) {
+        error = "invalid deck count in header";
+    }
+    else if (header_.shoeCount == 0 || body / header_.cardsPerShoe != header_.shoeCount ||
+        body % header_.cardsPerShoe != 0) {
+        error = "file size does not match the shoe count (truncated?)";
+    }
+    else {
+        return true;
+    }
+    close();
+    return false;
+}
+
+void ShoeCorpus::close() {
+    if (view_ != nullptr) {
+        UnmapViewOfFile(view_);
+        view_ = nullptr;
+    }
+    if (mapping_ != nullptr) {
+        CloseHandle(mapping_);
+        mapping_ = nullptr;
+    }
+    if (file_ != INVALID_HANDLE_VALUE) {
+        CloseHandle(file_);
+        file_ = INVALID_HANDLE_VALUE;
+    }
+    header_ = CorpusHeader();
+}
+
+// ==================== ШУЗЫ ====================
+
+bool ShoeCorpus::loadShoe(uint64_t index, Deck& shoe) const {
+    if (index >= header_.shoeCount || shoe.getDeckCount() != header_.deckCount) {
+        return false;
+    }
+
+    // Буфер потока: после первого шуза раскладка не выделяет память
+    thread_local std::vector<Card> cards;
+    cards.clear();
+    uint16_t counts[CODES] = {};
+    const uint8_t* codes = getShoeCodes(index);
+    for (size_t c = 0; c < header_.cardsPerShoe; ++c) {
+        uint8_t code = codes[c];
+        if (code >= CODES || !(validCodes_ >> code & 1)) {
+            return false;
+        }
+        ++counts[code];
+        cards.push_back(cardByCode_[code]);
+    }
+    // --solve берет шузы без verify(): состав проверяется здесь же
+    for (uint8_t code = 0; code < CODES; ++code) {
+        if ((validCodes_ >> code & 1) && counts[code] != header_.deckCount) {
+            return false;
+        }
+    }
+    return shoe.restoreFullShoe(cards);
+}
+
+uint64_t ShoeCorpus::verify(uint64_t shoes) const {
+    shoes = std::min(shoes, header_.shoeCount);
+
+    uint32_t counts[CODES];
+    for (uint64_t i = 0; i < shoes; ++i) {
+        std::memset(counts, 0, sizeof(counts));
+        const uint8_t* codes = getShoeCodes(i);
+        for (size_t c = 0; c < header_.cardsPerShoe; ++c) {
+            uint8_t code = codes[c];
+            if (code >= CODES || !(validCodes_ >> code & 1)) {
+                return i;
+            }
+            ++counts[code];
+        }
+        for (uint8_t code = 0; code < CODES; ++code) {
+            if ((validCodes_ >> code & 1) && counts[code] != header_.deckCount) {
+                return i;
+            }
+        }
+    }
+    return shoes;
+}
+
+// ==================== ТОЧКА ВХОДА ====================
+
+int runShoeCorpus(int argc, char* argv[]) {
+    CommandLine options(argc, argv);
+    std::string error;
+
+    // Проверка готового файла: заголовок и состав каждого шуза
+    if (options.has("info")) {
+        std::string path = options.getString("info", "");
+        ShoeCorpus corpus;
+        if (!corpus.open(path, error)) {
+            std::cerr << "Cannot open corpus " << path << ": " << error << "\n";
+            return 1;
+        }
+        std::cout << "Corpus: " << path << " | Shoes: " << corpus.getShoeCount() << " | Decks: "
+            << corpus.getDeckCount() << " | Seed: " << corpus.getSeed() << "\n";
+        uint64_t bad = corpus.verify(corpus.getShoeCount());
+        if (bad != corpus.getShoeCount()) {
+            std::cout << "Shoe " << bad << " is corrupt\n";
+            return 1;
+        }
+        std::cout << "All shoes verified\n";
+        return 0;
+    }
+
+    std::string path = options.getString("output", "");
+    long long decks = options.getInt("decks", 6);
+    long long shoes = options.getInt("shoes", 100000);
+    uint32_t seed = static_cast<uint32_t>(options.getInt("seed", 1));
+    if (path.empty() || decks < 1 || decks > static_cast<long long>(CORPUS_MAX_DECKS) || shoes < 1) {
+        std::cerr << "Usage: --corpus --output file [--decks 6] [--shoes 100000] [--seed N]\n"
+            "       --corpus --info file\n";
+        return 1;
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    if (!ShoeCorpus::generate(path, static_cast<size_t>(decks), static_cast<uint64_t>(shoes), seed, error)) {
+        std::cerr << "Cannot write corpus: " << error << "\n";
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    uint64_t bytes = sizeof(CorpusHeader) + static_cast<uint64_t>(shoes) * 52 * static_cast<uint64_t>(decks);
+    std::cout << "Wrote " << shoes << " shoes of " << decks << " deck(s) to " << path << " ("
+        << bytes << " bytes) in " << std::fixed << std::setprecision(2) << seconds << " s\n";
+    return 0;
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include "deck.h"
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+constexpr uint32_t CORPUS_MAGIC = 0x53484A42;  ///< "BJHS" - файл перемешанных шузов
+constexpr uint16_t CORPUS_VERSION = 1;         ///< Версия формата файла
+constexpr size_t CORPUS_MAX_DECKS = 16;        ///< Наибольшее число колод в шузе файла
+
+/**
+ * @brief Заголовок файла шузов
+ *
+ * За заголовком подряд идут shoeCount шузов по cardsPerShoe байт: коды
+ * карт encodeCard() в порядке Deck::getCards() (последняя - верхняя).
+ * Шуз i начинается со смещения sizeof(CorpusHeader) + i * cardsPerShoe.
+ */
+struct CorpusHeader {
+    uint32_t magic;        ///< CORPUS_MAGIC
+    uint16_t version;      ///< CORPUS_VERSION
+    uint16_t deckCount;    ///< Колод в шузе
+    uint32_t cardsPerShoe; ///< Карт в шузе (52 * deckCount)
+    uint32_t seed;         ///< Зерно: шуз i перемешан генератором от (seed, i)
+    uint64_t shoeCount;    ///< Шузов в файле
+};
+
+static_assert(std::is_trivially_copyable<CorpusHeader>::value, "CorpusHeader must be trivially copyable");
+static_assert(sizeof(CorpusHeader) == 24, "CorpusHeader layout must not depend on the compiler");
+
+/**
+ * @brief Файл заранее перемешанных шузов, отображенный в память только для чтения
+ *
+ * Файл пишется один раз (generate()), а дальше любое число процессов
+ * симуляций и проверок открывает его (open()) и раздает шузы без
+ * перетасовки: все видят одни и те же последовательности карт, а страницы
+ * файла в системном кэше общие, поэтому память не растет с числом
+ * процессов. Шуз i перемешан тем же генератором от (seed, i), что и в
+ * --solve, поэтому решатель с файлом и без него видит одни и те же шузы.
+ *
+ * Отображение только читается, поэтому потоки одного процесса берут шузы
+ * из одного объекта без блокировок.
+ */
+class ShoeCorpus {
+public:
+    ShoeCorpus() = default;
+    ~ShoeCorpus();
+
+    ShoeCorpus(const ShoeCorpus&) = delete;
+    ShoeCorpus& operator=(const ShoeCorpus&) = delete;
+
+    /**
+     * @brief Записать файл шузов (во временный файл, затем атомарная замена)
+     * @param path Путь к файлу
+     * @param deckCount Колод в шузе (1..CORPUS_MAX_DECKS)
+     * @param shoes Число шузов
+     * @param seed Зерно
+     * @param error [out] Причина отказа
+     * @return false при ошибке записи
+     */
+    static bool generate(const std::string& path, size_t deckCount, uint64_t shoes, uint32_t seed,
+        std::string& error);
+
+    /**
+     * @brief Отобразить файл в память
+     * @param error [out] Причина отказа
+     * @return false если файл не открывается, поврежден или обрезан
+     */
+    bool open(const std::string& path, std::string& error);
+
+    /**
+     * @brief Снять отображение и закрыть файл
+     */
+    void close();
+
+    bool isOpen() const { return view_ != nullptr; }
+    uint64_t getShoeCount() const { return header_.shoeCount; }
+    size_t getDeckCount() const { return header_.deckCount; }
+    size_t getCardsPerShoe() const { return header_.cardsPerShoe; }
+    uint32_t getSeed() const { return header_.seed; }
+
+    /**
+     * @brief Коды карт шуза прямо из отображения (getCardsPerShoe() байт)
+     */
+    const uint8_t* getShoeCodes(uint64_t index) const {
+        return view_ + sizeof(CorpusHeader) + index * header_.cardsPerShoe;
+    }
+
+    /**
+     * @brief Разложить шуз в колоду (Deck::restoreFullShoe(), счет верен сразу)
+     * @param index Номер шуза
+     * @param shoe [out] Колода из getDeckCount() колод
+     * @return false (колода не меняется), если номер вне файла или шуз поврежден:
+     *         недопустимый код карты или не ровно getDeckCount() копий каждой карты
+     */
+    bool loadShoe(uint64_t index, Deck& shoe) const;
+
+    /**
+     * @brief Проверить состав шузов (ровно getDeckCount() копий каждой карты)
+     * @param shoes Сколько первых шузов проверить (больше getShoeCount() - все)
+     * @return Номер первого неверного шуза или min(shoes, getShoeCount()), если все верны
+     */
+    uint64_t verify(uint64_t shoes) const;
+
+private:
+    HANDLE file_ = INVALID_HANDLE_VALUE; ///< Файл
+    HANDLE mapping_ = nullptr;           ///< Объект отображения
+    const uint8_t* view_ = nullptr;      ///< Начало отображения (заголовок)
+    CorpusHeader header_ = {};           ///< Копия заголовка
+
+    static constexpr uint8_t CODES = 64; ///< Кодов карт: (масть << 4) | достоинство
+    std::vector<Card> cardByCode_;       ///< Карта по коду
+    uint64_t validCodes_ = 0;            ///< Допустимые коды (бит на код)
+};
+
+/**
+ * @brief Точка входа режима --corpus (запись файла шузов и проверка)
+ * @return Код завершения
+ */
+int runShoeCorpus(int argc, char* argv[]);
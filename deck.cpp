@@ -1,74 +1,207 @@
-#include "deck.h"
-#include <algorithm>
-#include <iostream>
-#include <random>
-#include <stdexcept>
-
-/**
- * @brief Конструктор создает полную колоду из 52 карт
- *
- * Создает все комбинации мастей и достоинств:
- * - 4 масти: Hearts, Diamonds, Clubs, Spades
- * - 13 достоинств: от Two до Ace
- */
-Deck::Deck() {
-    // Создаем все 52 карты: 4 масти × 13 достоинств
-    for (int suit = static_cast<int>(Suit::Hearts); suit <= static_cast<int>(Suit::Spades); ++suit) {
-        for (int rank = static_cast<int>(Rank::Two); rank <= static_cast<int>(Rank::Ace); ++rank) {
-            cards_.emplace_back(static_cast<Suit>(suit), static_cast<Rank>(rank));
-        }
-    }
-}
-
-/**
- * @brief Тщательно перемешивает колоду используя Mersenne Twister
- */
-void Deck::shuffle() {
-    std::random_device rd;  // Источник энтропии
-    std::mt19937 generator(rd());  // Генератор Mersenne Twister
-
-    std::shuffle(cards_.begin(), cards_.end(), generator);
-
-    std::cout << "The deck is shuffled!\n";
-}
-
-/**
- * @brief Взятие верхней карты из колоды
- * @return Карта с вершины колоды
- * @throws std::runtime_error если колода пуста
- */
-Card Deck::drawCard() {
-    if (cards_.empty()) {
-        throw std::runtime_error("Cannot draw card: deck is empty!");
-    }
-
-    Card topCard = cards_.back();
-    cards_.pop_back();
-    return topCard;
-}
-
-/**
- * @brief Проверяет пуста ли колода
- * @return true если колода пуста, иначе false
- */
-bool Deck::isEmpty() const {
-    return cards_.empty();
-}
-
-/**
- * @brief Выводит все карты в колоде (для отладки)
- *
- * Формат вывода: "2H 3H 4H ... AS"
- * Полезно для тестирования и отладки
- */
-void Deck::printDeck() const {
-    std::cout << "Deck contents (" << cards_.size() << " cards): ";
-
-    for (size_t i = 0; i < cards_.size(); ++i) {
-        std::cout << cards_[i];
-        if (i < cards_.size() - 1) {
-            std::cout << " ";
-        }
-    }
-    std::cout << "\n";
+#include "deck.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+/**
+ * @brief Конструктор создает полную колоду из 52 карт
+ *
+ * Создает все комбинации мастей и достоинств:
+ * - 4 масти: Hearts, Diamonds, Clubs, Spades
+ * - 13 достоинств: от Two до Ace
+ */
+Deck::Deck() : Deck(1) {}
+
+/**
+ * @brief Конструктор создает шуз из нескольких колод
+ * @param deckCount Число колод
+ *
+ * Колоды идут подряд в том же порядке, что и одиночная колода
+ */
+Deck::Deck(size_t deckCount) {
+    if (deckCount == 0) deckCount = 1;
+    deckCount_ = deckCount;
+    cards_.reserve(deckCount * 52);
+
+    for (size_t deck = 0; deck < deckCount; ++deck) {
+        // Создаем все 52 карты: 4 масти × 13 достоинств
+        for (int suit = static_cast<int>(Suit::Hearts); suit <= static_cast<int>(Suit::Spades); ++suit) {
+            for (int rank = static_cast<int>(Rank::Two); rank <= static_cast<int>(Rank::Ace); ++rank) {
+                cards_.emplace_back(static_cast<Suit>(suit), static_cast<Rank>(rank));
+            }
+        }
+    }
+
+    // Полный шуз: по 4 карты достоинства на колоду, счет нулевой
+    for (auto& count : remaining_) {
+        count = static_cast<uint16_t>(4 * deckCount);
+    }
+}
+
+/**
+ * @brief Тщательно перемешивает колоду используя Mersenne Twister
+ */
+void Deck::shuffle() {
+    std::random_device rd;  // Источник энтропии
+    std::mt19937 generator(rd());  // Генератор Mersenne Twister
+
+    shuffle(generator);
+
+    std::cout << "The deck is shuffled!\n";
+}
+
+/**
+ * @brief Перемешивает колоду заданным генератором без вывода сообщений
+ * @param generator Генератор случайных чисел
+ *
+ * Используется сервером и симуляциями, где генератор создается один раз
+ */
+void Deck::shuffle(std::mt19937& generator) {
+    std::shuffle(cards_.begin(), cards_.end(), generator);
+}
+
+/**
+ * @brief Взятие верхней карты из колоды
+ * @return Карта с вершины колоды
+ * @throws std::runtime_error если колода пуста
+ */
+Card Deck::drawCard() {
+    if (cards_.empty()) {
+        throw std::runtime_error("Cannot draw card: deck is empty!");
+    }
+
+    Card topCard = cards_.back();
+    cards_.pop_back();
+
+    size_t index = rankIndex(topCard.getRank());
+    --remaining_[index];
+    runningCount_ += countSystem_.tags[index];
+    if (sideBetsTracked_) {
+        sideBets_.remove(topCard);
+    }
+    return topCard;
+}
+
+/**
+ * @brief Убрать все карты
+ *
+ * Счет становится таким, как если бы весь шуз был роздан
+ */
+void Deck::clear() {
+    cards_.clear();
+    runningCount_ = 0;
+    for (size_t i = 0; i < RANK_COUNT; ++i) {
+        remaining_[i] = 0;
+        runningCount_ += countSystem_.tags[i] * static_cast<int>(4 * deckCount_);
+    }
+    sideBets_.clear();
+}
+
+/**
+ * @brief Положить карту на вершину колоды
+ * @param card Карта
+ *
+ * Карта возвращается в шуз - ее вес уходит из бегущего счета
+ */
+void Deck::addCard(const Card& card) {
+    cards_.push_back(card);
+    size_t index = rankIndex(card.getRank());
+    ++remaining_[index];
+    runningCount_ -= countSystem_.tags[index];
+    if (sideBetsTracked_) {
+        sideBets_.add(card);
+    }
+}
+
+bool Deck::restoreFullShoe(const std::vector<Card>& cards) {
+    if (cards.size() != 52 * deckCount_) {
+        return false;
+    }
+    // Остаток по достоинствам беззнаковый: чужой состав увел бы его ниже нуля при раздаче
+    uint16_t ranks[RANK_COUNT] = {};
+    for (const auto& card : cards) {
+        ++ranks[rankIndex(card.getRank())];
+    }
+    for (uint16_t count : ranks) {
+        if (count != 4 * deckCount_) {
+            return false;
+        }
+    }
+
+    cards_ = cards; // Емкость сохраняется - без выделений
+    runningCount_ = 0;
+    for (auto& count : remaining_) {
+        count = static_cast<uint16_t>(4 * deckCount_);
+    }
+    if (sideBetsTracked_) {
+        trackSideBets(true);
+    }
+    return true;
+}
+
+void Deck::trackSideBets(bool enabled) {
+    sideBetsTracked_ = enabled;
+    sideBets_.clear();
+    if (enabled) {
+        for (const auto& card : cards_) {
+            sideBets_.add(card);
+        }
+    }
+}
+
+// ==================== СЧЕТ КАРТ ====================
+
+const CountSystem* findCountSystem(const std::string& name) {
+    if (name == "hi-lo") return &HI_LO_COUNT;
+    if (name == "hi-opt-1") return &HI_OPT_I_COUNT;
+    if (name == "omega-2") return &OMEGA_II_COUNT;
+    if (name == "zen") return &ZEN_COUNT;
+    return nullptr;
+}
+
+void Deck::setCountSystem(const CountSystem& system) {
+    countSystem_ = system;
+    runningCount_ = 0;
+    for (size_t i = 0; i < RANK_COUNT; ++i) {
+        int dealt = static_cast<int>(4 * deckCount_) - static_cast<int>(remaining_[i]);
+        runningCount_ += countSystem_.tags[i] * dealt;
+    }
+}
+
+double Deck::getDecksRemaining() const {
+    // Меньше половины колоды не делим - иначе счет в конце шуза взлетает
+    size_t cards = cards_.size() > 26 ? cards_.size() : 26;
+    return cards / 52.0;
+}
+
+size_t Deck::getRemainingTens() const {
+    return remaining_[rankIndex(Rank::Ten)] + remaining_[rankIndex(Rank::Jack)] +
+        remaining_[rankIndex(Rank::Queen)] + remaining_[rankIndex(Rank::King)];
+}
+
+/**
+ * @brief Проверяет пуста ли колода
+ * @return true если колода пуста, иначе false
+ */
+bool Deck::isEmpty() const {
+    return cards_.empty();
+}
+
+/**
+ * @brief Выводит все карты в колоде (для отладки)
+ *
+ * Формат вывода: "2H 3H 4H ... AS"
+ * Полезно для тестирования и отладки
+ */
+void Deck::printDeck() const {
+    std::cout << "Deck contents (" << cards_.size() << " cards): ";
+
+    for (size_t i = 0; i < cards_.size(); ++i) {
+        std::cout << cards_[i];
+        if (i < cards_.size() - 1) {
+            std::cout << " ";
+        }
+    }
+    std::cout << "\n";
 }
\ No newline at end of file
@@ -1,41 +1,201 @@
-#pragma once
-#include "card.h"
-#include <vector>
-#include <random>
-
-/**
- * @brief Класс представляющий колоду игральных карт
- */
-class Deck {
-public:
-    /**
-     * @brief Конструктор создает полную колоду из 52 карт
-     */
-    Deck();
-
-    /**
-     * @brief Тщательно перемешивает колоду
-     */
-    void shuffle();
-
-    /**
-     * @brief Взятие верхней карты из колоды
-     * @return Карта с вершины колоды
-     * @throws std::runtime_error если колода пуста
-     */
-    Card drawCard();
-
-    /**
-     * @brief Проверяет пуста ли колода
-     * @return true если колода пуста, иначе false
-     */
-    bool isEmpty() const;
-
-    /**
-     * @brief Выводит все карты в колоде (для отладки)
-     */
-    void printDeck() const;
-
-private:
-    std::vector<Card> cards_;  ///< Вектор карт в колоде
+#pragma once
+#include "card.h"
+#include "sidebet.h"
+#include <cstdint>
+#include <vector>
+#include <random>
+#include <string>
+#include <utility>
+
+constexpr size_t RANK_COUNT = 13; ///< Достоинств в колоде (Two..Ace)
+
+/**
+ * @brief Система счета карт: вес каждого достоинства
+ *
+ * Веса индексируются от Rank::Two (индекс 0) до Rank::Ace (индекс 12).
+ * Можно задать свою систему - колода хранит копию весов
+ */
+struct CountSystem {
+    const char* name;            ///< Название для отчетов
+    int8_t tags[RANK_COUNT];     ///< Вес достоинства: 2, 3, ..., 10, J, Q, K, A
+};
+
+/// @name Готовые системы счета (все сбалансированные: сумма по колоде равна 0)
+/// @{
+constexpr CountSystem HI_LO_COUNT    = { "Hi-Lo",    { 1, 1, 1, 1, 1, 0, 0, 0, -1, -1, -1, -1, -1 } };
+constexpr CountSystem HI_OPT_I_COUNT = { "Hi-Opt I", { 0, 1, 1, 1, 1, 0, 0, 0, -1, -1, -1, -1, 0 } };
+constexpr CountSystem OMEGA_II_COUNT = { "Omega II", { 1, 1, 2, 2, 2, 1, 0, -1, -2, -2, -2, -2, 0 } };
+constexpr CountSystem ZEN_COUNT      = { "Zen",      { 1, 1, 2, 2, 2, 1, 0, 0, -2, -2, -2, -2, -1 } };
+/// @}
+
+/**
+ * @brief Найти готовую систему счета по имени ("hi-lo", "hi-opt-1", "omega-2", "zen")
+ * @return nullptr если имя неизвестно
+ */
+const CountSystem* findCountSystem(const std::string& name);
+
+/**
+ * @brief Номер достоинства в таблицах счета (Two = 0, Ace = 12)
+ */
+inline size_t rankIndex(Rank rank) {
+    return static_cast<size_t>(rank) - static_cast<size_t>(Rank::Two);
+}
+
+/**
+ * @brief Класс представляющий колоду игральных карт
+ *
+ * Колода (или шуз из нескольких колод) сама ведет бегущий счет, остаток
+ * карт по достоинствам, а по запросу (trackSideBets()) и остаток по
+ * достоинствам и мастям с шансами побочных ставок (SideBetOdds):
+ * drawCard(), addCard() и clear() обновляют их за O(1), поэтому стратегии
+ * и интерфейс спрашивают счет, не пересматривая карты.
+ * Карта учитывается в момент выдачи из колоды - в том числе закрытая
+ * карта дилера, которую игроки еще не видели.
+ *
+ * Инвариант: бегущий счет = сумма весов карт, которых нет в колоде
+ * относительно полного шуза из getDeckCount() колод. Поэтому после
+ * восстановления снимка (clear() + addCard()) счет сразу верен.
+ */
+class Deck {
+public:
+    /**
+     * @brief Конструктор создает полную колоду из 52 карт
+     */
+    Deck();
+
+    /**
+     * @brief Конструктор создает шуз из нескольких колод
+     * @param deckCount Число колод по 52 карты (0 считается как 1)
+     */
+    explicit Deck(size_t deckCount);
+
+    /**
+     * @brief Тщательно перемешивает колоду
+     */
+    void shuffle();
+
+    /**
+     * @brief Перемешивает колоду заданным генератором без вывода сообщений
+     * @param generator Генератор случайных чисел (для сервера и симуляций)
+     */
+    void shuffle(std::mt19937& generator);
+
+    /**
+     * @brief Взятие верхней карты из колоды
+     * @return Карта с вершины колоды
+     * @throws std::runtime_error если колода пуста
+     *
+     * Обновляет бегущий счет, остаток достоинства и шансы побочных ставок (если ведутся)
+     */
+    Card drawCard();
+
+    /**
+     * @brief Проверяет пуста ли колода
+     * @return true если колода пуста, иначе false
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief Число оставшихся карт
+     */
+    size_t size() const { return cards_.size(); }
+
+    /**
+     * @brief Оставшиеся карты (последняя - верхняя, будет взята первой)
+     */
+    const std::vector<Card>& getCards() const { return cards_; }
+
+    /**
+     * @brief Убрать все карты (для восстановления снимков)
+     */
+    void clear();
+
+    /**
+     * @brief Положить карту на вершину колоды (для восстановления снимков)
+     * @param card Карта
+     */
+    void addCard(const Card& card);
+
+    /**
+     * @brief Начать полный шуз в готовом порядке (например, из файла шузов)
+     * @param cards Карты в порядке getCards(): ровно getDeckCount() полных колод
+     * @return false (колода не меняется), если карт или достоинств не столько, сколько в полном шузе
+     *
+     * Состав полного шуза известен заранее, поэтому после проверки
+     * достоинств счет и остаток просто сбрасываются - дешевле clear() и addCard().
+     */
+    bool restoreFullShoe(const std::vector<Card>& cards);
+
+    /**
+     * @brief Поменять местами карту и карту на глубине depth от вершины
+     * @param index Позиция карты (как в getCards())
+     * @param depth Глубина от вершины (0 - верхняя карта)
+     *
+     * Состав и счет не меняются. Случайная позиция на вершине перед
+     * каждой выдачей - ленивая перетасовка Фишера-Йетса.
+     */
+    void swapToTop(size_t index, size_t depth = 0) {
+        std::swap(cards_[index], cards_[cards_.size() - 1 - depth]);
+    }
+
+    /// @name Счет и состав оставшихся карт (все за O(1))
+    /// @{
+
+    /**
+     * @brief Сменить систему счета (бегущий счет пересчитывается по составу)
+     * @param system Система счета
+     */
+    void setCountSystem(const CountSystem& system);
+
+    const CountSystem& getCountSystem() const { return countSystem_; }
+    size_t getDeckCount() const { return deckCount_; }     ///< Колод в полном шузе
+    int getRunningCount() const { return runningCount_; }  ///< Бегущий счет
+
+    /**
+     * @brief Оставшихся колод (не меньше половины колоды)
+     */
+    double getDecksRemaining() const;
+
+    /**
+     * @brief Истинный счет: бегущий на оставшиеся колоды
+     */
+    double getTrueCount() const { return runningCount_ / getDecksRemaining(); }
+
+    /**
+     * @brief Осталось карт достоинства
+     */
+    size_t getRemaining(Rank rank) const { return remaining_[rankIndex(rank)]; }
+
+    /**
+     * @brief Осталось карт со значением 10 (десятки и картинки)
+     */
+    size_t getRemainingTens() const;
+
+    /**
+     * @brief Вести шансы побочных ставок (пересчитываются по оставшимся картам)
+     * @param enabled false - не вести: симуляциям они не нужны, а выдачу замедляют вдвое
+     */
+    void trackSideBets(bool enabled);
+
+    bool isTrackingSideBets() const { return sideBetsTracked_; }
+
+    /**
+     * @brief Точные шансы побочных ставок по оставшимся картам (пусто, если не ведутся)
+     */
+    const SideBetOdds& getSideBets() const { return sideBets_; }
+    /// @}
+
+    /**
+     * @brief Выводит все карты в колоде (для отладки)
+     */
+    void printDeck() const;
+
+private:
+    std::vector<Card> cards_;  ///< Вектор карт в колоде
+    size_t deckCount_ = 1;     ///< Колод в полном шузе
+    CountSystem countSystem_ = HI_LO_COUNT;  ///< Система счета
+    int runningCount_ = 0;     ///< Бегущий счет
+    uint16_t remaining_[RANK_COUNT] = {};    ///< Остаток по достоинствам
+    bool sideBetsTracked_ = false;         ///< Ведутся ли шансы побочных ставок
+    SideBetOdds sideBets_;     ///< Остаток по достоинству и масти, шансы побочных ставок
 };
\ No newline at end of file
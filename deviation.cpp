@@ -0,0 +1,429 @@
+#include "deviation.h"
+#include "options.h"
+#include "strategy.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+namespace {
+    const char* actionName(PlayerAction action) {
+        switch (action) {
+        case PlayerAction::Hit:        return "Hit";
+        case PlayerAction::Stand:      return "Stand";
+        case PlayerAction::DoubleDown: return "Double";
+        default:                       return "Split";
+        }
+    }
+
+    const char* verdictName(CellVerdict verdict) {
+        switch (verdict) {
+        case CellVerdict::AlternativeBetter: return "deviate";
+        case CellVerdict::BasicBetter:       return "basic";
+        case CellVerdict::Indifferent:       return "equal";
+        case CellVerdict::Unreachable:       return "unreachable";
+        default:                             return "unresolved";
+        }
+    }
+
+    /**
+     * @brief Поток splitmix64: дешевое засевание и хорошее перемешивание битов
+     */
+    class SplitMix64 {
+    public:
+        explicit SplitMix64(uint64_t seed) : state_(seed) {}
+
+        uint64_t next() {
+            uint64_t x = (state_ += 0x9E3779B97F4A7C15ull);
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+            return x ^ (x >> 31);
+        }
+
+        /**
+         * @brief Число в [0, bound): умножение и сдвиг вместо деления
+         *
+         * Смещение порядка bound / 2^32 - для шуза в сотни карт незаметно
+         */
+        size_t below(size_t bound) {
+            return static_cast<size_t>(((next() >> 32) * static_cast<uint64_t>(bound)) >> 32);
+        }
+
+    private:
+        uint64_t state_; ///< Состояние
+    };
+
+    /**
+     * @brief Зерно раздачи: одинаково для всех ячеек с тем же номером раздачи
+     */
+    uint64_t trialSeed(uint32_t seed, uint64_t trial) {
+        return SplitMix64((static_cast<uint64_t>(seed) << 40) ^ trial).next();
+    }
+}
+
+// ==================== ШУЗ С ЗАДАННЫМ СЧЕТОМ ====================
+
+CountConditionedShoe::CountConditionedShoe(const SimulationRules& rules, double decksRemaining)
+    : shoe_(rules.deckCount) {
+    size_t fullCards = shoe_.size();
+    double cards = std::round(decksRemaining * 52.0);
+    remainingCards_ = static_cast<size_t>(std::min(std::max(cards, 1.0), static_cast<double>(fullCards)));
+    shoe_.setCountSystem(rules.countSystem);
+    pool_.reserve(fullCards);
+}
+
+bool CountConditionedShoe::build(const Card* known, size_t knownCount, int trueCount, uint64_t seed) {
+    SplitMix64 generator(seed);
+    const int8_t* tags = shoe_.getCountSystem().tags;
+    size_t perRank[RANK_COUNT];
+    for (auto& count : perRank) {
+        count = 4 * shoe_.getDeckCount();
+    }
+
+    int runningCount = 0;
+    for (size_t i = 0; i < knownCount; ++i) {
+        size_t index = rankIndex(known[i].getRank());
+        if (perRank[index] == 0) {
+            return false;
+        }
+        --perRank[index];
+        runningCount += tags[index];
+    }
+
+    pool_.clear();
+    for (size_t rank = 0; rank < RANK_COUNT; ++rank) {
+        pool_.insert(pool_.end(), perRank[rank], static_cast<uint8_t>(rank));
+    }
+    size_t total = pool_.size();
+    if (remainingCards_ >= total) {
+        return false; // Нечего убирать - счет не сдвинуть
+    }
+    size_t dealt = total - remainingCards_;
+
+    // Случайные вышедшие карты - частичная перетасовка в начало буфера
+    for (size_t i = 0; i < dealt; ++i) {
+        size_t j = i + generator.below(total - i);
+        std::swap(pool_[i], pool_[j]);
+        runningCount += tags[pool_[i]];
+    }
+
+    // Счет как у Deck::getTrueCount(): меньше половины колоды не делим
+    double decks = std::max<size_t>(remainingCards_, 26) / 52.0;
+    int target = static_cast<int>(std::lround(trueCount * decks));
+
+    // Меняем вышедшую и оставшуюся карту, если обмен приближает счет, не перескакивая
+    for (size_t attempts = 64 * total; runningCount != target; --attempts) {
+        if (attempts == 0) {
+            return false;
+        }
+        size_t i = generator.below(dealt);
+        size_t j = dealt + generator.below(remainingCards_);
+        int step = tags[pool_[j]] - tags[pool_[i]];
+        int need = target - runningCount;
+        if (step != 0 && (step > 0) == (need > 0) && std::abs(step) <= std::abs(need)) {
+            std::swap(pool_[i], pool_[j]);
+            runningCount += step;
+        }
+    }
+
+    // Оставшиеся карты - перетасовка Фишера-Йетса
+    for (size_t i = total - 1; i > dealt; --i) {
+        size_t j = dealt + generator.below(i - dealt + 1);
+        std::swap(pool_[i], pool_[j]);
+    }
+    shoe_.clear();
+    for (size_t i = dealt; i < total; ++i) {
+        shoe_.addCard(Card(static_cast<Suit>(i % 4), static_cast<Rank>(2 + pool_[i])));
+    }
+    return true;
+}
+
+// ==================== ОТКЛОНЕНИЯ ====================
+
+const std::vector<DeviationPlay>& illustriousDeviations() {
+    static const std::vector<DeviationPlay> plays = {
+        { "insurance", Rank::Ten,  Rank::Seven, Rank::Ace,   PlayerAction::Stand,      true },
+        { "16v10",     Rank::Ten,  Rank::Six,   Rank::Ten,   PlayerAction::Stand,      false },
+        { "15v10",     Rank::Ten,  Rank::Five,  Rank::Ten,   PlayerAction::Stand,      false },
+        { "TTv5",      Rank::Ten,  Rank::Ten,   Rank::Five,  PlayerAction::Split,      false },
+        { "TTv6",      Rank::Ten,  Rank::Ten,   Rank::Six,   PlayerAction::Split,      false },
+        { "10v10",     Rank::Six,  Rank::Four,  Rank::Ten,   PlayerAction::DoubleDown, false },
+        { "12v3",      Rank::Ten,  Rank::Two,   Rank::Three, PlayerAction::Stand,      false },
+        { "12v2",      Rank::Ten,  Rank::Two,   Rank::Two,   PlayerAction::Stand,      false },
+        { "11vA",      Rank::Six,  Rank::Five,  Rank::Ace,   PlayerAction::DoubleDown, false },
+        { "9v2",       Rank::Five, Rank::Four,  Rank::Two,   PlayerAction::DoubleDown, false },
+        { "10vA",      Rank::Six,  Rank::Four,  Rank::Ace,   PlayerAction::DoubleDown, false },
+        { "9v7",       Rank::Five, Rank::Four,  Rank::Seven, PlayerAction::DoubleDown, false },
+        { "16v9",      Rank::Ten,  Rank::Six,   Rank::Nine,  PlayerAction::Stand,      false },
+        { "13v2",      Rank::Ten,  Rank::Three, Rank::Two,   PlayerAction::Hit,        false },
+        { "12v4",      Rank::Ten,  Rank::Two,   Rank::Four,  PlayerAction::Hit,        false },
+        { "12v5",      Rank::Ten,  Rank::Two,   Rank::Five,  PlayerAction::Hit,        false },
+        { "12v6",      Rank::Ten,  Rank::Two,   Rank::Six,   PlayerAction::Hit,        false },
+        { "13v3",      Rank::Ten,  Rank::Three, Rank::Three, PlayerAction::Hit,        false },
+    };
+    return plays;
+}
+
+DeviationGenerator::DeviationGenerator(const DeviationConfig& config)
+    : config_(config) {
+    if (config_.threads == 0) {
+        config_.threads = std::thread::hardware_concurrency();
+    }
+    if (config_.threads == 0) config_.threads = 1;
+    if (config_.batch == 0) config_.batch = 1;
+
+    std::vector<std::string> names;
+    std::istringstream stream(config_.only);
+    std::string name;
+    while (std::getline(stream, name, ',')) {
+        if (!name.empty()) names.push_back(name);
+    }
+
+    for (const DeviationPlay& play : illustriousDeviations()) {
+        if (!names.empty() && std::find(names.begin(), names.end(), play.name) == names.end()) {
+            continue;
+        }
+        std::vector<Card> hand = { Card(Suit::Hearts, play.first), Card(Suit::Spades, play.second) };
+        plays_.push_back(play);
+        basicActions_.push_back(play.insurance ? PlayerAction::Stand
+            : basicStrategyAction(summarizeHand(hand), upcardValue(Card(Suit::Clubs, play.upcard)),
+                LegalActions(LegalActions::ALL_MASK)));
+    }
+
+    for (size_t play = 0; play < plays_.size(); ++play) {
+        for (int count = config_.minCount; count <= config_.maxCount; ++count) {
+            DeviationCell cell;
+            cell.play = play;
+            cell.trueCount = count;
+            cells_.push_back(cell);
+        }
+    }
+}
+
+void DeviationGenerator::run() {
+    // Ячейки крупные и разной длины - раздаются по одной
+    std::atomic<size_t> next(0);
+    size_t threads = std::min(config_.threads, std::max<size_t>(cells_.size(), 1));
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([this, &next]() {
+            RoundSimulator simulator(config_.rules);
+            CountConditionedShoe shoe(config_.rules, config_.decksRemaining);
+            size_t index;
+            while ((index = next.fetch_add(1)) < cells_.size()) {
+                resolveCell(cells_[index], simulator, shoe);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void DeviationGenerator::resolveCell(DeviationCell& cell, RoundSimulator& simulator, CountConditionedShoe& shoe) const {
+    const DeviationPlay& play = plays_[cell.play];
+    PlayerAction basic = basicActions_[cell.play];
+    const Card known[3] = { Card(Suit::Hearts, play.first), Card(Suit::Spades, play.second), Card(Suit::Clubs, play.upcard) };
+    double scale = static_cast<double>(CHIP_SCALE);
+
+    std::mt19937 generator(config_.seed); // Только для аварийной перетасовки внутри раунда
+    uint64_t trial = 0;
+    while (trial < config_.maxTrials) {
+        uint64_t end = std::min(trial + config_.batch, config_.maxTrials);
+        for (; trial < end; ++trial) {
+            if (!shoe.build(known, 3, cell.trueCount, trialSeed(config_.seed, trial))) {
+                cell.verdict = CellVerdict::Unreachable;
+                return;
+            }
+
+            Chips difference;
+            if (play.insurance) {
+                // Страховка - половина ставки, платит 2:1, если закрытая карта - десятка
+                const Card& hole = shoe.getShoe().getCards().back();
+                difference = hole.getValue() == 10 ? CHIP_SCALE : -CHIP_SCALE / 2;
+            }
+            else {
+                Chips deviation = simulator.playDecision(shoe.getShoe(), known[0], known[1], known[2],
+                    play.alternative, CHIP_SCALE, generator);
+                Chips standard = simulator.playDecision(shoe.getShoe(), known[0], known[1], known[2],
+                    basic, CHIP_SCALE, generator);
+                difference = deviation - standard;
+            }
+            cell.difference.add(difference);
+        }
+
+        double mean = cell.difference.getMean() / scale;
+        double margin = config_.confidence * cell.difference.getStdError() / scale;
+        if (std::abs(mean) > margin) {
+            cell.verdict = mean > 0.0 ? CellVerdict::AlternativeBetter : CellVerdict::BasicBetter;
+            return;
+        }
+        if (margin < config_.tolerance) {
+            cell.verdict = CellVerdict::Indifferent;
+            return;
+        }
+    }
+    cell.verdict = CellVerdict::Unresolved;
+}
+
+bool DeviationGenerator::findIndex(size_t play, double& index, bool& rising) const {
+    const DeviationCell* previous = nullptr;
+    for (const DeviationCell& cell : cells_) {
+        if (cell.play != play || cell.verdict == CellVerdict::Unreachable) {
+            continue;
+        }
+        if (previous) {
+            double before = previous->difference.getMean();
+            double after = cell.difference.getMean();
+            if ((before <= 0.0) != (after <= 0.0)) {
+                // Первый переход через ноль - линейная интерполяция между соседними счетами
+                index = previous->trueCount + (cell.trueCount - previous->trueCount) * before / (before - after);
+                rising = after > 0.0;
+                return true;
+            }
+        }
+        previous = &cell;
+    }
+    return false;
+}
+
+void DeviationGenerator::printReport(std::ostream& os, bool details) const {
+    static const char* STRATEGY_NAMES[] = { "Standard (stops at 17+)", "Aggressive (stops at 18+)", "Cautious (stops at 16+)" };
+
+    uint64_t trials = 0;
+    for (const auto& cell : cells_) {
+        trials += cell.difference.getCount();
+    }
+    double scale = static_cast<double>(CHIP_SCALE);
+    double fixedBudget = static_cast<double>(cells_.size()) * static_cast<double>(config_.maxTrials);
+
+    os << "\n=== COUNT-INDEXED DEVIATIONS ===\n";
+    os << std::fixed << std::setprecision(2);
+    os << "Rules: " << config_.rules.deckCount << " decks, decision at " << config_.decksRemaining
+        << " decks remaining, dealer " << STRATEGY_NAMES[static_cast<int>(config_.rules.dealerStrategy)]
+        << " | Count: " << config_.rules.countSystem.name << "\n";
+    os << "Stopping: |EV diff| > " << config_.confidence << " SE or " << config_.confidence
+        << " SE < " << std::setprecision(4) << config_.tolerance << " units, batches of " << config_.batch
+        << ", at most " << config_.maxTrials << " deals per cell\n";
+    os << std::setprecision(2);
+    os << "Cells: " << cells_.size() << " (TC " << config_.minCount << ".." << config_.maxCount << ")"
+        << " | Deals: " << trials << " (" << (fixedBudget > 0.0 ? 100.0 * trials / fixedBudget : 0.0)
+        << "% of fixed budget) | Threads: " << config_.threads << "\n";
+    os << "Time: " << seconds_ << " s (" << std::setprecision(0)
+        << trials / (seconds_ > 0.0 ? seconds_ : 1.0) << " deals/sec)\n\n";
+
+    os << std::left << std::setw(11) << "Play" << std::setw(8) << "Basic" << std::setw(11) << "Deviation"
+        << std::setw(12) << "Index" << std::setw(10) << "Exact" << "Bracket" << std::right << "\n";
+    for (size_t play = 0; play < plays_.size(); ++play) {
+        const DeviationPlay& deviation = plays_[play];
+        const char* basicName = deviation.insurance ? "No" : actionName(basicActions_[play]);
+        const char* deviationName = deviation.insurance ? "Insure" : actionName(deviation.alternative);
+
+        os << std::left << std::setw(11) << deviation.name << std::setw(8) << basicName << std::setw(11) << deviationName;
+        if (!deviation.insurance && basicActions_[play] == deviation.alternative) {
+            os << "same as basic strategy" << std::right << "\n";
+            continue;
+        }
+
+        double index = 0.0;
+        bool rising = true;
+        if (!findIndex(play, index, rising)) {
+            bool always = false;
+            for (const auto& cell : cells_) {
+                if (cell.play == play && cell.verdict != CellVerdict::Unreachable) {
+                    always = cell.difference.getMean() > 0.0;
+                    break;
+                }
+            }
+            os << (always ? "always" : "never") << " in TC " << config_.minCount << ".." << config_.maxCount
+                << std::right << "\n";
+            continue;
+        }
+
+        // Индекс в целых числах: отклоняться, начиная с ближайшего счета за порогом
+        std::ostringstream rule;
+        rule << (rising ? "TC >= " : "TC <= ")
+            << static_cast<int>(rising ? std::ceil(index) : std::floor(index));
+        std::ostringstream exact;
+        exact << std::fixed << std::setprecision(2) << index;
+
+        // Уверенность в пороге - итоги двух ячеек вокруг него
+        std::string bracket;
+        for (const auto& cell : cells_) {
+            if (cell.play == play && (cell.trueCount == static_cast<int>(std::floor(index)) ||
+                cell.trueCount == static_cast<int>(std::floor(index)) + 1)) {
+                if (!bracket.empty()) bracket += " / ";
+                bracket += verdictName(cell.verdict);
+            }
+        }
+        os << std::setw(12) << rule.str() << std::setw(10) << exact.str() << bracket << std::right << "\n";
+    }
+
+    if (!details) {
+        return;
+    }
+    os << "\nEV difference (deviation - basic), units per hand, +/- " << std::setprecision(2)
+        << config_.confidence << " SE:\n";
+    for (size_t play = 0; play < plays_.size(); ++play) {
+        os << "\n" << plays_[play].name << "\n";
+        for (const auto& cell : cells_) {
+            if (cell.play != play) continue;
+            os << "  TC " << std::setw(3) << std::showpos << cell.trueCount << std::noshowpos
+                << std::setw(9) << cell.difference.getCount() << " deals  "
+                << std::setprecision(4) << std::setw(8) << cell.difference.getMean() / scale << " +/- "
+                << std::setw(6) << config_.confidence * cell.difference.getStdError() / scale
+                << "  " << verdictName(cell.verdict) << "\n";
+        }
+    }
+}
+
+// ==================== ТОЧКА ВХОДА ====================
+
+int runDeviationGenerator(int argc, char* argv[]) {
+    CommandLine options(argc, argv);
+
+    DeviationConfig config;
+    config.rules.deckCount = static_cast<size_t>(options.getInt("decks", static_cast<long long>(config.rules.deckCount)));
+    config.decksRemaining = options.getDouble("remaining", config.rules.deckCount / 2.0);
+    config.minCount = static_cast<int>(options.getInt("min-count", config.minCount));
+    config.maxCount = static_cast<int>(options.getInt("max-count", config.maxCount));
+    config.batch = static_cast<uint64_t>(options.getInt("batch", static_cast<long long>(config.batch)));
+    config.maxTrials = static_cast<uint64_t>(options.getInt("max-trials", static_cast<long long>(config.maxTrials)));
+    config.confidence = options.getDouble("confidence", config.confidence);
+    config.tolerance = options.getDouble("tolerance", config.tolerance);
+    config.only = options.getString("only", "");
+    config.threads = static_cast<size_t>(options.getInt("threads", 0));
+    config.seed = static_cast<uint32_t>(options.getInt("seed", config.seed));
+
+    std::string countName = options.getString("count", "hi-lo");
+    const CountSystem* countSystem = findCountSystem(countName);
+    if (!countSystem) {
+        std::cerr << "Unknown count system \"" << countName << "\". Expected hi-lo, hi-opt-1, omega-2 or zen\n";
+        return 1;
+    }
+    config.rules.countSystem = *countSystem;
+
+    if (config.rules.deckCount == 0 || config.decksRemaining <= 0.0 ||
+        config.decksRemaining >= static_cast<double>(config.rules.deckCount) ||
+        config.minCount > config.maxCount || config.maxTrials == 0 || config.confidence <= 0.0) {
+        std::cerr << "Usage: --deviations [--decks N] [--remaining decks] [--count system]"
+            " [--min-count TC] [--max-count TC] [--batch N] [--max-trials N] [--confidence SE]"
+            " [--tolerance units] [--only 16v10,insurance] [--details] [--threads N] [--seed N]\n";
+        return 1;
+    }
+
+    DeviationGenerator generator(config);
+    if (generator.getCells().empty()) {
+        std::cerr << "No deviations match --only \"" << config.only << "\"\n";
+        return 1;
+    }
+    generator.run();
+    generator.printReport(std::cout, options.has("details"));
+    return 0;
+}
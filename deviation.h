@@ -0,0 +1,171 @@
+#pragma once
+#include "player.h"
+#include "deck.h"
+#include "simulator.h"
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// ==================== ШУЗ С ЗАДАННЫМ СЧЕТОМ ====================
+
+/**
+ * @brief Шуз, в котором истинный счет равен заданному
+ *
+ * Из полного шуза убираются известные карты (руки игрока и открытая
+ * карта дилера) и случайные "вышедшие" карты, пока в шузе не останется
+ * заданное число колод. Затем вышедшие и оставшиеся карты меняются
+ * местами по одной, пока бегущий счет не станет round(TC * колод
+ * в остатке). Оставшиеся карты перемешиваются. Работа идет по номерам
+ * достоинств в заранее выделенном буфере - сборка шуза не выделяет память.
+ *
+ * Случайность - только из зерна: одно зерно при разных счетах дает шузы
+ * из одних и тех же случайных чисел. Генератор внутри - splitmix64:
+ * засеять std::mt19937 на каждую раздачу дороже самой сборки шуза.
+ */
+class CountConditionedShoe {
+public:
+    /**
+     * @brief Конструктор
+     * @param rules Правила (колод в шузе и система счета)
+     * @param decksRemaining Колод в шузе на момент решения
+     */
+    CountConditionedShoe(const SimulationRules& rules, double decksRemaining);
+
+    /**
+     * @brief Собрать шуз
+     * @param known Карты, которые уже на столе (учитываются в счете)
+     * @param knownCount Число известных карт
+     * @param trueCount Истинный счет
+     * @param seed Зерно раздачи
+     * @return false если такой счет недостижим при этом остатке шуза
+     */
+    bool build(const Card* known, size_t knownCount, int trueCount, uint64_t seed);
+
+    const Deck& getShoe() const { return shoe_; }
+
+private:
+    size_t remainingCards_;           ///< Карт в собранном шузе
+    Deck shoe_;                       ///< Собранный шуз (счет ведет сам Deck)
+    std::vector<uint8_t> pool_;       ///< Номера достоинств: [0, выбывшие) и [выбывшие, конец) - остаток
+};
+
+// ==================== ОТКЛОНЕНИЯ ====================
+
+/**
+ * @brief Отклонение от базовой стратегии по счету
+ */
+struct DeviationPlay {
+    const char* name;          ///< Короткое имя для --only ("16v10", "insurance")
+    Rank first;                ///< Первая карта игрока
+    Rank second;               ///< Вторая карта игрока
+    Rank upcard;               ///< Открытая карта дилера
+    PlayerAction alternative;  ///< Действие вместо базовой стратегии
+    bool insurance;            ///< Сравнивается страховка, а не решение по руке
+};
+
+/**
+ * @brief "Illustrious 18": страховка и 17 решений с самыми ценными индексами
+ */
+const std::vector<DeviationPlay>& illustriousDeviations();
+
+/**
+ * @brief Итог ячейки (отклонение, истинный счет)
+ */
+enum class CellVerdict : uint8_t {
+    Unresolved,        ///< Исчерпан лимит раздач
+    AlternativeBetter, ///< Отклонение выгоднее с заданной уверенностью
+    BasicBetter,       ///< Базовая стратегия выгоднее
+    Indifferent,       ///< Разница меньше допуска
+    Unreachable        ///< Счет недостижим при этом остатке шуза
+};
+
+/**
+ * @brief Ячейка: одно отклонение при одном истинном счете
+ */
+struct DeviationCell {
+    size_t play = 0;           ///< Номер отклонения
+    int trueCount = 0;         ///< Истинный счет
+    RunningStats difference;   ///< Выигрыш отклонения минус выигрыш базовой стратегии (Chips)
+    CellVerdict verdict = CellVerdict::Unresolved;
+};
+
+/**
+ * @brief Параметры генератора отклонений
+ */
+struct DeviationConfig {
+    SimulationRules rules;         ///< Правила стола и система счета
+    double decksRemaining = 3.0;   ///< Колод в шузе на момент решения
+    int minCount = -6;             ///< Наименьший истинный счет сетки
+    int maxCount = 8;              ///< Наибольший истинный счет сетки
+    uint64_t batch = 4000;         ///< Раздач между проверками остановки
+    uint64_t maxTrials = 200000;   ///< Раздач на ячейку не больше
+    double confidence = 3.0;       ///< Порог остановки в стандартных ошибках
+    double tolerance = 0.005;      ///< Разница меньше (единиц ставки) - действия равноценны
+    std::string only;              ///< Только отклонения с этими именами через запятую
+    size_t threads = 0;            ///< Рабочих потоков (0 - по числу ядер)
+    uint32_t seed = 1;             ///< Зерно
+};
+
+/**
+ * @brief Поиск индексов отклонений: порогов истинного счета, где решение меняется
+ *
+ * Сетка ячеек (отклонение x истинный счет) считается параллельно, ячейки
+ * независимы. Раздача i любой ячейки строится из зерна (seed, i): оба
+ * действия играются на одном и том же шузе, а соседние счета - на шузах
+ * из одних и тех же случайных чисел (общие случайные числа). Поэтому
+ * разница действий и ее наклон по счету шумят намного меньше, чем при
+ * независимых раздачах.
+ *
+ * Ячейка останавливается, как только знак разницы известен с заданной
+ * уверенностью (или разница заведомо меньше допуска); далекие от порога
+ * ячейки решаются за одну пачку, а лимит раздач тратится у порога.
+ * Индекс - линейная интерполяция нуля разницы между соседними счетами.
+ */
+class DeviationGenerator {
+public:
+    explicit DeviationGenerator(const DeviationConfig& config);
+
+    /**
+     * @brief Посчитать все ячейки
+     */
+    void run();
+
+    /**
+     * @brief Отчет: индекс каждого отклонения и (с details) разница по счетам
+     */
+    void printReport(std::ostream& os, bool details) const;
+
+    const std::vector<DeviationCell>& getCells() const { return cells_; }
+
+    /**
+     * @brief Индекс отклонения
+     * @param play Номер отклонения
+     * @param index [out] Истинный счет, где разница проходит через ноль
+     * @param rising [out] true - отклоняться при счете не ниже индекса, false - не выше
+     * @return false если разница не меняет знак на сетке
+     */
+    bool findIndex(size_t play, double& index, bool& rising) const;
+
+private:
+    /**
+     * @brief Считать ячейку пачками до остановки
+     */
+    void resolveCell(DeviationCell& cell, RoundSimulator& simulator, CountConditionedShoe& shoe) const;
+
+    DeviationConfig config_;                 ///< Параметры
+    std::vector<DeviationPlay> plays_;       ///< Отклонения
+    std::vector<PlayerAction> basicActions_; ///< Действие базовой стратегии для каждого отклонения
+    std::vector<DeviationCell> cells_;       ///< Ячейки: по отклонениям, внутри - по возрастанию счета
+    double seconds_ = 0.0;                   ///< Время прогона
+};
+
+/**
+ * @brief Точка входа режима поиска индексов (--deviations)
+ * @param argc Число аргументов
+ * @param argv Аргументы: --decks, --remaining, --count, --min-count, --max-count, --batch,
+ *             --max-trials, --confidence, --tolerance, --only, --details, --threads, --seed
+ * @return 0 при успехе
+ */
+int runDeviationGenerator(int argc, char* argv[]);
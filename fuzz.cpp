@@ -0,0 +1,661 @@
+#include "fuzz.h"
+#include "game.h"
+#include "options.h"
+#include "protocol.h"
+#include "strategy.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+// ==================== РАЗБОР СЛУЧАЯ ====================
+
+namespace {
+    constexpr size_t DECK_CARDS = 52;
+    constexpr size_t DEALER_STRATEGY_COUNT = 3;        ///< Standard, Aggressive, Cautious
+    constexpr size_t PLAYER_POLICY_COUNT = 3;          ///< Basic, MimicDealer, NeverBust
+    constexpr Chips SIMULATOR_RESERVE = 3 * DEFAULT_BET; ///< Запас на удвоения и Split в раунде симулятора
+
+    /**
+     * @brief Чтение байтов случая: за концом данных - нули
+     */
+    class ByteReader {
+    public:
+        ByteReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+        uint8_t next() { return position_ < size_ ? data_[position_++] : 0; }
+        bool atEnd() const { return position_ >= size_; }
+
+    private:
+        const uint8_t* data_;
+        size_t size_;
+        size_t position_ = 0;
+    };
+
+    /**
+     * @brief Карта по номеру 0-51 (масть * 13 + достоинство)
+     */
+    Card cardFromIndex(size_t index) {
+        return Card(static_cast<Suit>((index / 13) % 4), static_cast<Rank>(2 + index % 13));
+    }
+
+    /**
+     * @brief Карты через пробел
+     */
+    std::string cardsToString(const std::vector<Card>& cards) {
+        std::string result;
+        for (const auto& card : cards) {
+            if (!result.empty()) result += ' ';
+            result += card.toString();
+        }
+        return result.empty() ? "-" : result;
+    }
+
+    const char* outcomeName(RoundOutcome outcome) {
+        switch (outcome) {
+        case RoundOutcome::Win:  return "win";
+        case RoundOutcome::Loss: return "loss";
+        case RoundOutcome::Push: return "push";
+        default:                 return "none";
+        }
+    }
+
+    /**
+     * @brief Исход для статистики по итогу ставки (блэкджек - победа)
+     */
+    RoundOutcome settledOutcome(WagerResult result) {
+        switch (result) {
+        case WagerResult::Loss: return RoundOutcome::Loss;
+        case WagerResult::Push: return RoundOutcome::Push;
+        default:                return RoundOutcome::Win;
+        }
+    }
+
+    /**
+     * @brief Сверить инкрементальный счет и состав колоды с пересчетом по картам
+     * @return Описание расхождения или пустая строка
+     */
+    std::string countMismatch(const Deck& deck) {
+        size_t remaining[RANK_COUNT] = {};
+        for (const auto& card : deck.getCards()) {
+            ++remaining[rankIndex(card.getRank())];
+        }
+
+        // Бегущий счет - сумма меток вышедших из полного шуза карт
+        const CountSystem& system = deck.getCountSystem();
+        int runningCount = 0;
+        for (size_t rank = 0; rank < RANK_COUNT; ++rank) {
+            size_t full = 4 * deck.getDeckCount();
+            runningCount += system.tags[rank] * (static_cast<int>(full) - static_cast<int>(remaining[rank]));
+            Rank value = static_cast<Rank>(2 + rank);
+            if (deck.getRemaining(value) != remaining[rank]) {
+                return "rank " + std::to_string(2 + rank) + " remaining " +
+                    std::to_string(deck.getRemaining(value)) + ", rescan " + std::to_string(remaining[rank]);
+            }
+        }
+        if (deck.getRunningCount() != runningCount) {
+            return "running count " + std::to_string(deck.getRunningCount()) +
+                ", rescan " + std::to_string(runningCount);
+        }
+
+        // Суммы побочных ставок после всех выдач и возвратов - как у пересчета по составу
+        if (deck.isTrackingSideBets()) {
+            SideBetOdds rescan;
+            for (const auto& card : deck.getCards()) {
+                rescan.add(card);
+            }
+            if (!(deck.getSideBets() == rescan)) {
+                return "side bets " + std::to_string(deck.getSideBets().getCardCount()) +
+                    " cards, rescan " + std::to_string(rescan.getCardCount());
+            }
+        }
+        return std::string();
+    }
+}
+
+void decodeFuzzCase(const uint8_t* data, size_t size, FuzzCase& fuzzCase) {
+    ByteReader reader(data, size);
+
+    fuzzCase.seatCount = static_cast<uint8_t>(1 + reader.next() % Table::MAX_SEATS);
+    fuzzCase.strategy = static_cast<DealerStrategy>(reader.next() % 3);
+
+    fuzzCase.handCards.clear();
+    size_t handCount = reader.next() % (FUZZ_MAX_HAND_CARDS + 1);
+    for (size_t i = 0; i < handCount; ++i) {
+        fuzzCase.handCards.push_back(cardFromIndex(reader.next() % DECK_CARDS));
+    }
+
+    // Колода: выбранные карты идут первыми, остальные - в каноническом порядке
+    uint8_t remaining[DECK_CARDS];
+    size_t remainingCount = DECK_CARDS;
+    for (size_t i = 0; i < DECK_CARDS; ++i) {
+        remaining[i] = static_cast<uint8_t>(i);
+    }
+
+    fuzzCase.dealOrder.clear();
+    size_t picks = reader.next() % (DECK_CARDS + 1);
+    for (size_t i = 0; i < picks; ++i) {
+        size_t index = reader.next() % remainingCount;
+        fuzzCase.dealOrder.push_back(cardFromIndex(remaining[index]));
+        std::copy(remaining + index + 1, remaining + remainingCount, remaining + index);
+        --remainingCount;
+    }
+    for (size_t i = 0; i < remainingCount; ++i) {
+        fuzzCase.dealOrder.push_back(cardFromIndex(remaining[i]));
+    }
+
+    fuzzCase.decisions.clear();
+    while (!reader.atEnd()) {
+        // Коды 0-3 - действия, 4 - недопустимый код (стол превращает его в Stand)
+        fuzzCase.decisions.push_back(static_cast<uint8_t>(reader.next() % 5));
+    }
+}
+
+std::string describeFuzzCase(const FuzzCase& fuzzCase) {
+    std::ostringstream os;
+    os << "Seats: " << static_cast<int>(fuzzCase.seatCount)
+        << " | Dealer strategy: " << dealerStrategyName(fuzzCase.strategy) << "\n";
+    os << "Hand cards: " << cardsToString(fuzzCase.handCards) << "\n";
+
+    size_t initialCards = 2 * fuzzCase.seatCount + 2;
+    std::vector<Card> initial(fuzzCase.dealOrder.begin(), fuzzCase.dealOrder.begin() + initialCards);
+    std::vector<Card> rest(fuzzCase.dealOrder.begin() + initialCards, fuzzCase.dealOrder.end());
+    os << "Initial deal: " << cardsToString(initial) << "\n";
+    os << "Next cards: " << cardsToString(rest) << "\n";
+
+    os << "Decisions:";
+    for (uint8_t code : fuzzCase.decisions) {
+        os << " " << static_cast<int>(code);
+    }
+    os << (fuzzCase.decisions.empty() ? " - (all Stand)\n" : "\n");
+    return os.str();
+}
+
+// ==================== ДИФФЕРЕНЦИАЛЬНАЯ ПРОВЕРКА ====================
+
+DifferentialHarness::DifferentialHarness()
+    : handPlayer_("Hand"), table_(1, 1, 0), simulatedPlayer_("Simulated") {
+    for (size_t i = 0; i < Table::MAX_SEATS; ++i) {
+        referenceSeats_.emplace_back("Seat " + std::to_string(i + 1));
+    }
+    handCodes_.reserve(FUZZ_MAX_HAND_CARDS);
+
+    for (size_t strategy = 0; strategy < DEALER_STRATEGY_COUNT; ++strategy) {
+        for (size_t policy = 0; policy < PLAYER_POLICY_COUNT; ++policy) {
+            SimulationRules rules;
+            rules.deckCount = 1;
+            rules.dealerStrategy = static_cast<DealerStrategy>(strategy);
+            rules.playerPolicy = static_cast<PlayerPolicy>(policy);
+            simulators_.emplace_back(rules);
+        }
+    }
+}
+
+bool DifferentialHarness::runCase(const uint8_t* data, size_t size, Divergence& divergence) {
+    decodeFuzzCase(data, size, case_);
+    return checkHand(divergence) && checkRound(divergence) && checkSimulator(divergence);
+}
+
+bool DifferentialHarness::checkHand(Divergence& divergence) {
+    handPlayer_.clearHand();
+    handCodes_.clear();
+
+    for (const auto& card : case_.handCards) {
+        handPlayer_.addCard(card);
+        handCodes_.push_back(encodeCard(card));
+
+        int score = handPlayer_.calculateScore();
+        bool pair = handPlayer_.canSplit();
+        HandSummary fromCards = summarizeHand(handPlayer_.getHand());
+        HandSummary fromCodes = summarizeHandCodes(handCodes_.data(), handCodes_.size());
+
+        if (fromCards.score != score || fromCodes.score != score ||
+            (fromCards.pairValue != 0) != pair || (fromCodes.pairValue != 0) != pair) {
+            std::ostringstream os;
+            os << "hand " << cardsToString(handPlayer_.getHand())
+                << ": calculateScore " << score << ", canSplit " << pair
+                << " | summarizeHand " << fromCards.score << " pair " << fromCards.pairValue
+                << " | summarizeHandCodes " << fromCodes.score << " pair " << fromCodes.pairValue;
+            divergence.check = "hand";
+            divergence.detail = os.str();
+            return false;
+        }
+
+        // Рука после перебора в игре не растет
+        if (handPlayer_.isBusted()) {
+            break;
+        }
+    }
+    return true;
+}
+
+bool DifferentialHarness::playReferenceRound() {
+    size_t nextDecision = 0;
+    try {
+        for (size_t seat = 0; seat < case_.seatCount; ++seat) {
+            Player& player = referenceSeats_[seat];
+            referenceDoubled_[seat] = false;
+            bool turnOver = false;
+            while (!turnOver) {
+                uint8_t code = nextDecision < case_.decisions.size()
+                    ? case_.decisions[nextDecision++]
+                    : static_cast<uint8_t>(PlayerAction::Stand);
+
+                // Правила стола: Double - одна карта и конец хода, Split играется как Stand
+                switch (player.convertNetworkAction(code)) {
+                case PlayerAction::Hit:
+                    player.takeCard(referenceDeck_);
+                    turnOver = player.isBusted();
+                    break;
+                case PlayerAction::DoubleDown:
+                    player.takeCard(referenceDeck_);
+                    referenceDoubled_[seat] = true;
+                    turnOver = true;
+                    break;
+                default:
+                    turnOver = true;
+                    break;
+                }
+            }
+        }
+
+        while (referenceDealer_.mustDrawCard()) {
+            referenceDealer_.takeCard(referenceDeck_);
+        }
+    }
+    catch (const std::runtime_error&) {
+        return false; // Колода кончилась
+    }
+    return true;
+}
+
+bool DifferentialHarness::checkRound(Divergence& divergence) {
+    // Начальная раздача как в Table::startRound: по 2 карты местам, затем дилеру
+    size_t dealt = 0;
+    for (size_t seat = 0; seat < case_.seatCount; ++seat) {
+        referenceSeats_[seat].clearHand();
+        referenceSeats_[seat].addCard(case_.dealOrder[dealt++]);
+        referenceSeats_[seat].addCard(case_.dealOrder[dealt++]);
+    }
+    referenceDealer_.clearHand();
+    referenceDealer_.addCard(case_.dealOrder[dealt++]);
+    referenceDealer_.addCard(case_.dealOrder[dealt++]);
+    referenceDealer_.restoreStrategy(case_.strategy);
+
+    // Карты берутся с конца колоды - кладем остаток в обратном порядке;
+    // шансы побочных ставок ведутся, чтобы сверить их после выдач
+    referenceDeck_.clear();
+    referenceDeck_.trackSideBets(true);
+    for (size_t i = case_.dealOrder.size(); i > dealt; --i) {
+        referenceDeck_.addCard(case_.dealOrder[i - 1]);
+    }
+
+    // То же начальное состояние - столу через снимок посреди раунда; у каждого
+    // места ставка DEFAULT_BET и банкролл, которого хватает на удвоение
+    std::memset(&snapshot_, 0, sizeof(snapshot_));
+    snapshot_.version = SNAPSHOT_VERSION;
+    snapshot_.seatCount = case_.seatCount;
+    snapshot_.activeSeat = 0;
+    snapshot_.roundOver = 0;
+    snapshot_.dealerStrategy = static_cast<uint8_t>(case_.strategy);
+    snapshot_.tableId = 1;
+    snapshot_.roundId = 1;
+    saveDeck(snapshot_, referenceDeck_);
+    saveHand(snapshot_.dealer, referenceDealer_.getHand());
+    for (size_t seat = 0; seat < case_.seatCount; ++seat) {
+        saveSeat(snapshot_.seats[seat], referenceSeats_[seat]);
+        snapshot_.seats[seat].wagered = 1;
+        snapshot_.seats[seat].stakes[0] = DEFAULT_BET;
+        snapshot_.seats[seat].balance = STARTING_BANKROLL;
+        snapshot_.outcomes[seat] = static_cast<uint8_t>(RoundOutcome::Push);
+    }
+    if (!table_.restoreSnapshot(snapshot_)) {
+        divergence.check = "round";
+        divergence.detail = "table rejected the initial snapshot";
+        return false;
+    }
+
+    bool referenceComplete = playReferenceRound();
+
+    bool tableComplete = true;
+    size_t nextDecision = 0;
+    try {
+        while (!table_.isRoundOver()) {
+            uint8_t code = nextDecision < case_.decisions.size()
+                ? case_.decisions[nextDecision++]
+                : static_cast<uint8_t>(PlayerAction::Stand);
+            if (!table_.applyDecision(table_.getActiveSeat(), code)) {
+                divergence.check = "round";
+                divergence.detail = "table rejected a decision for its active seat";
+                return false;
+            }
+        }
+    }
+    catch (const std::runtime_error&) {
+        tableComplete = false;
+    }
+
+    std::ostringstream os;
+    std::string tableCount = countMismatch(table_.getDeck());
+    std::string referenceCount = countMismatch(referenceDeck_);
+    if (!tableCount.empty() || !referenceCount.empty()) {
+        os << "deck count: table " << (tableCount.empty() ? "ok" : tableCount)
+            << ", reference " << (referenceCount.empty() ? "ok" : referenceCount);
+    }
+    else if (referenceComplete != tableComplete) {
+        os << "deck exhausted: reference " << !referenceComplete << ", table " << !tableComplete;
+    }
+    else if (!referenceComplete) {
+        return true; // Обе стороны уперлись в конец колоды
+    }
+    else if (table_.getDealer().getHand().size() != referenceDealer_.getHand().size()) {
+        os << "dealer (" << dealerStrategyName(case_.strategy) << "): table "
+            << cardsToString(table_.getDealer().getHand()) << ", reference "
+            << cardsToString(referenceDealer_.getHand());
+    }
+    else {
+        for (size_t seat = 0; seat < case_.seatCount; ++seat) {
+            const Player& tableSeat = table_.getSeats()[seat];
+            const Player& referenceSeat = referenceSeats_[seat];
+            WagerResult expected = wagerResult(Game::judgeHand(referenceSeat, referenceDealer_),
+                referenceSeat.hasNatural(), referenceDealer_.hasNatural());
+            RoundOutcome actual = table_.getOutcomes()[seat];
+
+            // Выигрыш места относительно баланса до ставки
+            Chips stake = referenceDoubled_[seat] ? 2 * DEFAULT_BET : DEFAULT_BET;
+            Chips expectedNet = wagerReturn(stake, expected) - stake;
+            Chips actualNet = table_.getBalance(static_cast<uint8_t>(seat)) - STARTING_BANKROLL - DEFAULT_BET;
+
+            if (tableSeat.getHand().size() != referenceSeat.getHand().size() ||
+                tableSeat.calculateScore() != referenceSeat.calculateScore() ||
+                actual != settledOutcome(expected) || actualNet != expectedNet) {
+                os << "seat " << seat << ": table " << cardsToString(tableSeat.getHand())
+                    << " -> " << outcomeName(actual) << " " << formatChips(actualNet) << ", reference "
+                    << cardsToString(referenceSeat.getHand()) << " -> " << outcomeName(settledOutcome(expected))
+                    << " " << formatChips(expectedNet)
+                    << " (dealer " << cardsToString(referenceDealer_.getHand()) << ")";
+                break;
+            }
+        }
+    }
+
+    if (os.tellp() > 0) {
+        divergence.check = "round";
+        divergence.detail = os.str();
+        return false;
+    }
+    return true;
+}
+
+bool DifferentialHarness::playReferenceSimulation(PlayerPolicy policy, Chips& net) {
+    Player& player = simulatedPlayer_;
+    Dealer& dealer = simulatedDealer_;
+    Chips stakes[Player::MAX_HANDS] = { DEFAULT_BET };
+    Chips reserve = SIMULATOR_RESERVE;
+
+    try {
+        // Раздача симулятора: две карты игроку, затем две дилеру
+        referenceDeck_ = simulatorDeck_;
+        player.clearHand();
+        dealer.clearHand();
+        dealer.restoreStrategy(case_.strategy);
+        player.takeCard(referenceDeck_);
+        player.takeCard(referenceDeck_);
+        dealer.takeCard(referenceDeck_);
+        dealer.takeCard(referenceDeck_);
+
+        int up = upcardValue(dealer.getHand()[0]);
+        for (size_t hand = 0; hand < player.getHandCount(); ++hand) {
+            player.selectHand(hand);
+            while (true) {
+                LegalActions legal = player.getLegalActions();
+                if (stakes[hand] > reserve) {
+                    legal = legal.without(PlayerAction::DoubleDown).without(PlayerAction::Split);
+                }
+                if (legal.empty()) {
+                    break;
+                }
+
+                PlayerAction action = policyAction(policy, summarizeHand(player.getHand()), up, legal);
+                if (action == PlayerAction::Stand) {
+                    break;
+                }
+                if (action == PlayerAction::Hit) {
+                    player.takeCard(referenceDeck_);
+                    continue;
+                }
+                reserve -= stakes[hand];
+                if (action == PlayerAction::DoubleDown) {
+                    stakes[hand] *= 2;
+                    player.takeCard(referenceDeck_);
+                    break;
+                }
+                if (referenceDeck_.size() < 2) {
+                    return false;
+                }
+                player.splitActiveHand(referenceDeck_);
+                stakes[player.getHandCount() - 1] = stakes[hand];
+            }
+        }
+
+        while (dealer.mustDrawCard()) {
+            dealer.takeCard(referenceDeck_);
+        }
+    }
+    catch (const std::runtime_error&) {
+        return false; // Колода кончилась
+    }
+
+    // Расчет как в Game::determineWinner()
+    net = 0;
+    for (size_t hand = 0; hand < player.getHandCount(); ++hand) {
+        player.selectHand(hand);
+        WagerResult result = wagerResult(Game::judgeHand(player, dealer), player.hasNatural(), dealer.hasNatural());
+        net += wagerReturn(stakes[hand], result) - stakes[hand];
+    }
+    player.selectHand(0);
+    return true;
+}
+
+bool DifferentialHarness::checkSimulator(Divergence& divergence) {
+    // Вся колода случая в порядке выдачи; карты берутся с конца
+    simulatorDeck_.clear();
+    for (size_t i = case_.dealOrder.size(); i > 0; --i) {
+        simulatorDeck_.addCard(case_.dealOrder[i - 1]);
+    }
+
+    for (size_t policy = 0; policy < PLAYER_POLICY_COUNT; ++policy) {
+        Chips expected = 0;
+        if (!playReferenceSimulation(static_cast<PlayerPolicy>(policy), expected)) {
+            continue;
+        }
+
+        RoundSimulator& simulator = simulators_[static_cast<size_t>(case_.strategy) * PLAYER_POLICY_COUNT + policy];
+        simulator.loadShoe(simulatorDeck_);
+        Chips actual = simulator.playRound(DEFAULT_BET, SIMULATOR_RESERVE, generator_);
+        if (actual != expected) {
+            std::ostringstream os;
+            os << playerPolicyName(static_cast<PlayerPolicy>(policy)) << " policy: simulator "
+                << formatChips(actual) << ", reference " << formatChips(expected)
+                << " (player " << cardsToString(simulatedPlayer_.getHand()) << ", dealer "
+                << cardsToString(simulatedDealer_.getHand()) << ")";
+            divergence.check = "simulator";
+            divergence.detail = os.str();
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<uint8_t> DifferentialHarness::minimize(const std::vector<uint8_t>& input, const Divergence& divergence) {
+    std::vector<uint8_t> best = input;
+    std::vector<uint8_t> candidate;
+    Divergence found;
+
+    auto stillDiverges = [&](const std::vector<uint8_t>& bytes) {
+        return !runCase(bytes.data(), bytes.size(), found) && found.check == divergence.check;
+    };
+
+    bool progress = true;
+    while (progress) {
+        progress = false;
+
+        // Вырезаем куски от половины длины до одного байта
+        for (size_t chunk = best.size() / 2; chunk > 0; chunk /= 2) {
+            for (size_t start = 0; start + chunk <= best.size();) {
+                candidate.assign(best.begin(), best.begin() + start);
+                candidate.insert(candidate.end(), best.begin() + start + chunk, best.end());
+                if (stillDiverges(candidate)) {
+                    best.swap(candidate);
+                    progress = true;
+                }
+                else {
+                    start += chunk;
+                }
+            }
+        }
+
+        // Уменьшаем оставшиеся байты: 0, половина, на единицу
+        for (size_t i = 0; i < best.size(); ++i) {
+            const uint8_t original = best[i];
+            const uint8_t smaller[] = { 0, static_cast<uint8_t>(original / 2), static_cast<uint8_t>(original - 1) };
+            for (uint8_t value : smaller) {
+                if (value >= best[i]) {
+                    continue;
+                }
+                candidate = best;
+                candidate[i] = value;
+                if (stillDiverges(candidate)) {
+                    best[i] = value;
+                    progress = true;
+                }
+            }
+        }
+    }
+
+    // Оставляем в случае состояние минимального входа
+    runCase(best.data(), best.size(), found);
+    return best;
+}
+
+// ==================== ТОЧКА ВХОДА ====================
+
+namespace {
+    /**
+     * @brief Байты в шестнадцатеричном виде
+     */
+    std::string toHex(const std::vector<uint8_t>& bytes) {
+        std::ostringstream os;
+        os << std::hex << std::setfill('0');
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            os << (i ? " " : "") << std::setw(2) << static_cast<int>(bytes[i]);
+        }
+        return os.str();
+    }
+
+    void printDivergence(const Divergence& divergence, const std::vector<uint8_t>& bytes, const FuzzCase& fuzzCase) {
+        std::cout << "Divergence [" << divergence.check << "]: " << divergence.detail << "\n";
+        std::cout << "Input (" << bytes.size() << " bytes): " << toHex(bytes) << "\n";
+        std::cout << describeFuzzCase(fuzzCase);
+    }
+
+    int replayCase(DifferentialHarness& harness, const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            std::cerr << "Failed to read " << path << ".\n";
+            return 1;
+        }
+        std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        Divergence divergence;
+        if (harness.runCase(bytes.data(), bytes.size(), divergence)) {
+            std::cout << "No divergence.\n" << describeFuzzCase(harness.getLastCase());
+            return 0;
+        }
+        printDivergence(divergence, bytes, harness.getLastCase());
+        return 1;
+    }
+}
+
+int runFuzzer(int argc, char* argv[]) {
+    CommandLine options(argc, argv);
+    DifferentialHarness harness;
+
+    if (options.has("replay")) {
+        return replayCase(harness, options.getString("replay", ""));
+    }
+
+    double seconds = options.getDouble("seconds", 60.0);
+    uint64_t maxCases = static_cast<uint64_t>(options.getInt("cases", 0)); // 0 - ограничение только по времени
+    uint32_t seed = static_cast<uint32_t>(options.getInt("seed", std::random_device{}()));
+    size_t maxLength = static_cast<size_t>(options.getInt("max-length", 128));
+    std::string outPath = options.getString("out", "fuzz_repro.bin");
+
+    std::cout << "Differential fuzzing: seed " << seed << ", up to " << maxLength << " bytes per case\n";
+
+    std::mt19937 generator(seed);
+    std::vector<uint8_t> bytes;
+    bytes.reserve(maxLength);
+    Divergence divergence;
+
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(seconds));
+    uint64_t cases = 0;
+
+    while (maxCases == 0 || cases < maxCases) {
+        // Время проверяем не на каждом случае - now() заметен на фоне одного случая
+        if ((cases & 0xFFF) == 0 && std::chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+
+        bytes.resize(generator() % (maxLength + 1));
+        for (auto& byte : bytes) {
+            byte = static_cast<uint8_t>(generator());
+        }
+        ++cases;
+
+        if (!harness.runCase(bytes.data(), bytes.size(), divergence)) {
+            std::cout << "\nCase " << cases << " diverged, minimizing...\n";
+            std::vector<uint8_t> minimized = harness.minimize(bytes, divergence);
+            harness.runCase(minimized.data(), minimized.size(), divergence);
+            printDivergence(divergence, minimized, harness.getLastCase());
+
+            std::ofstream out(outPath, std::ios::binary);
+            out.write(reinterpret_cast<const char*>(minimized.data()), static_cast<std::streamsize>(minimized.size()));
+            std::cout << "Reproducer written to " << outPath << " (replay with --fuzz --replay " << outPath << ")\n";
+            return 1;
+        }
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "No divergence in " << cases << " cases (" << elapsed << " s, "
+        << (elapsed > 0.0 ? cases / elapsed * 60.0 / 1e6 : 0.0) << "M cases/min)\n";
+    return 0;
+}
+
+#ifdef BLACKJACK_LIBFUZZER
+/**
+ * @brief Вход для libFuzzer (сборка без main.cpp, clang -fsanitize=fuzzer /D BLACKJACK_LIBFUZZER)
+ *
+ * Минимизацию в этом режиме делает сам libFuzzer (-minimize_crash=1)
+ */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    static DifferentialHarness harness;
+    Divergence divergence;
+    if (!harness.runCase(data, size, divergence)) {
+        std::cerr << "Divergence [" << divergence.check << "]: " << divergence.detail << "\n"
+            << describeFuzzCase(harness.getLastCase());
+        std::abort();
+    }
+    return 0;
+}
+#endif
@@ -0,0 +1,140 @@
+#pragma once
+#include "player.h"
+#include "dealer.h"
+#include "deck.h"
+#include "table.h"
+#include "simulator.h"
+#include "snapshot.h"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+constexpr size_t FUZZ_MAX_HAND_CARDS = 24; ///< Карт в сверке подсчета руки (без перебора больше 21 не набрать)
+
+/**
+ * @brief Случай дифференциальной проверки, разобранный из байтов
+ *
+ * Любая строка байтов - допустимый случай: недостающие байты читаются
+ * как нули. Поэтому случаи можно как угодно укорачивать при минимизации
+ * и подавать напрямую из libFuzzer.
+ */
+struct FuzzCase {
+    uint8_t seatCount = 1;                               ///< Мест за столом (1-Table::MAX_SEATS)
+    DealerStrategy strategy = DealerStrategy::Standard;  ///< Стратегия дилера
+    std::vector<Card> handCards;   ///< Карты сверки подсчета (любые, как из многоколодного шуза)
+    std::vector<Card> dealOrder;   ///< Одна колода в порядке выдачи: сначала по 2 карты местам, затем дилеру
+    std::vector<uint8_t> decisions; ///< Коды действий по порядку ходов (кончились - Stand)
+};
+
+/**
+ * @brief Разобрать байты в случай
+ * @param data Байты
+ * @param size Длина
+ * @param fuzzCase [out] Случай (буферы переиспользуются)
+ *
+ * Формат: места, стратегия, число карт сверки и сами карты, число
+ * выбранных карт колоды и выборы (индекс среди оставшихся), затем решения
+ */
+void decodeFuzzCase(const uint8_t* data, size_t size, FuzzCase& fuzzCase);
+
+/**
+ * @brief Текстовое описание случая для отчета о расхождении
+ */
+std::string describeFuzzCase(const FuzzCase& fuzzCase);
+
+/**
+ * @brief Первое найденное расхождение
+ */
+struct Divergence {
+    std::string check;  ///< Какая проверка не сошлась ("hand", "round")
+    std::string detail; ///< Что именно разошлось
+};
+
+/**
+ * @brief Дифференциальная проверка быстрых путей против эталонных классов
+ *
+ * Эталон - правила Player::calculateScore(), Player::canSplit(),
+ * Dealer::mustDrawCard() и расчет Game::determineWinner(): итог ставки
+ * wagerResult(Game::judgeHand(), блэкджек игрока, блэкджек дилера)
+ * и выплата wagerReturn(). Сверяются:
+ * - hand: summarizeHand() и summarizeHandCodes() (стратегия ботов) -
+ *   счет и пара на каждом префиксе руки до перебора;
+ * - round: раунд серверного Table, восстановленного из снимка с заданной
+ *   колодой и ставками, - руки, ход дилера, исходы и балансы мест против
+ *   раунда на эталонных классах;
+ * - simulator: RoundSimulator::playRound() на той же колоде (одно место,
+ *   каждая стратегия игрока) - выигрыш против эталонного раунда с теми же
+ *   решениями стратегии.
+ *
+ * Объекты переиспользуются между случаями, чтобы прогонять миллионы
+ * случаев в минуту.
+ */
+class DifferentialHarness {
+public:
+    DifferentialHarness();
+
+    /**
+     * @brief Прогнать один случай через все проверки
+     * @param data Байты случая
+     * @param size Длина
+     * @param divergence [out] Первое расхождение
+     * @return true если все движки совпали с эталоном
+     */
+    bool runCase(const uint8_t* data, size_t size, Divergence& divergence);
+
+    /**
+     * @brief Минимизировать случай, сохраняя расхождение той же проверки
+     * @param input Байты расходящегося случая
+     * @param divergence Расхождение исходного случая
+     * @return Укороченные байты (вырезание кусков и уменьшение значений)
+     */
+    std::vector<uint8_t> minimize(const std::vector<uint8_t>& input, const Divergence& divergence);
+
+    /**
+     * @brief Последний разобранный случай
+     */
+    const FuzzCase& getLastCase() const { return case_; }
+
+private:
+    bool checkHand(Divergence& divergence);
+    bool checkRound(Divergence& divergence);
+    bool checkSimulator(Divergence& divergence);
+
+    /**
+     * @brief Раунд на эталонных классах по правилам стола
+     * @return false если колода кончилась
+     */
+    bool playReferenceRound();
+
+    /**
+     * @brief Раунд симулятора на эталонных классах: решения по стратегии игрока
+     * @param policy Стратегия игрока
+     * @param net [out] Выигрыш игрока
+     * @return false если колода кончилась (симулятор в этом случае перемешивает)
+     */
+    bool playReferenceSimulation(PlayerPolicy policy, Chips& net);
+
+    FuzzCase case_;                       ///< Текущий случай
+    Player handPlayer_;                   ///< Рука сверки подсчета
+    std::vector<uint8_t> handCodes_;      ///< Коды карт руки сверки
+    std::vector<Player> referenceSeats_;  ///< Эталонные места
+    Dealer referenceDealer_;              ///< Эталонный дилер
+    Deck referenceDeck_;                  ///< Эталонная колода
+    bool referenceDoubled_[Table::MAX_SEATS] = {}; ///< Эталонное место удвоило ставку
+    Table table_;                         ///< Проверяемый стол сервера
+    GameSnapshot snapshot_;               ///< Начальное состояние раунда для стола
+    std::vector<RoundSimulator> simulators_; ///< Проверяемые симуляторы (стратегия дилера x стратегия игрока)
+    Deck simulatorDeck_;                  ///< Колода случая для симулятора
+    Player simulatedPlayer_;              ///< Эталонное место раунда симулятора
+    Dealer simulatedDealer_;              ///< Эталонный дилер раунда симулятора
+    std::mt19937 generator_;              ///< Генератор аварийной перетасовки симулятора (не используется)
+};
+
+/**
+ * @brief Точка входа режима дифференциального фаззинга (--fuzz)
+ * @param argc Число аргументов
+ * @param argv Аргументы: --seconds, --cases, --seed, --max-length, --out (файл воспроизведения), --replay (файл)
+ * @return 0 если расхождений нет
+ */
+int runFuzzer(int argc, char* argv[]);
@@ -1,497 +1,798 @@
-﻿#include "game.h"
-#include <iostream>
-#include <fstream>
-#include <iomanip>
-
-/**
- * @brief Конструктор игры
- *
- * Инициализирует игру и настраивает игроков
- */
-Game::Game() {
-    setupPlayers();
-}
-
-// ==================== МЕТОДЫ ОТОБРАЖЕНИЯ ====================
-
-/**
- * @brief Отрисовка полного игрового стола со всеми картами
- *
- * Используется в конце раунда когда все карты дилера видны
- */
-void Game::drawGameTable() const {
-    system("cls");
-
-    std::cout << "\n";
-    std::cout << "    ============================\n";
-    std::cout << "    |      BLACKJACK TABLE     |\n";
-    std::cout << "    ============================\n\n";
-
-    // Дилер (верх стола)
-    std::cout << "           DEALER'S HAND\n";
-    std::cout << "           ";
-    dealer_.showHand();
-    std::cout << "\n";
-
-    // Разделитель
-    std::cout << "    ----------------------------\n\n";
-
-    // Игроки (низ стола)  
-    for (const auto& player : players_) {
-        std::cout << "           " << player.getName() << "'s HAND\n";
-        std::cout << "           ";
-        player.showHand();
-        std::cout << "\n";
-    }
-
-    // Нижняя часть стола
-    std::cout << "    ============================\n";
-}
-
-/**
- * @brief Отрисовка стола в начале раунда (скрытые карты дилера)
- *
- * Используется во время ходов игроков когда видна только первая карта дилера
- */
-void Game::drawGameTableFirstDeal() const {
-    system("cls");
-
-    std::cout << "\n";
-    std::cout << "    ============================\n";
-    std::cout << "    |      BLACKJACK TABLE     |\n";
-    std::cout << "    ============================\n\n";
-
-    // Дилер (только первая карта видна)
-    std::cout << "           DEALER'S HAND\n";
-    std::cout << "           ";
-    dealer_.showFirstCard();
-    std::cout << "\n";
-
-    // Разделитель
-    std::cout << "    ----------------------------\n\n";
-
-    // Игроки  
-    for (const auto& player : players_) {
-        std::cout << "           " << player.getName() << "'s HAND\n";
-        std::cout << "           ";
-        player.showHand();
-        std::cout << "\n";
-    }
-
-    std::cout << "    ============================\n";
-}
-
-// ==================== НАСТРОЙКА ИГРОКОВ ====================
-
-/**
- * @brief Настройка игроков перед началом игры
- *
- * Запрашивает количество игроков и их имена
- * Валидирует ввод и устанавливает значения по умолчанию
- */
-void Game::setupPlayers() {
-    int playerCount = 0;
-
-    while (playerCount < 1 || playerCount > 4) {
-        std::cout << "How many players? (1-4): ";
-        std::cin >> playerCount;
-
-        if (std::cin.fail()) {
-            std::cin.clear();
-            std::cin.ignore(10000, '\n');
-            setErrorColor();
-            std::cout << "Error! Enter a number from 1 to 4.\n";
-            resetColor();
-            playerCount = 0;
-        }
-        else if (playerCount < 1 || playerCount > 4) {
-            setErrorColor();
-            std::cout << "Error! Enter a number from 1 to 4.\n";
-            resetColor();
-        }
-
-        std::cin.ignore(10000, '\n');
-    }
-
-    // Создание игроков
-    for (int i = 1; i <= playerCount; ++i) {
-        std::string playerName;
-        std::cout << "Enter name for player " << i << ": ";
-        std::getline(std::cin, playerName);
-
-        if (playerName.empty()) {
-            playerName = "Player " + std::to_string(i);
-        }
-
-        players_.emplace_back(playerName);
-    }
-
-    // Подтверждение состава стола
-    std::cout << "\nAt the table: ";
-    for (const auto& player : players_) {
-        std::cout << player.getName() << " ";
-    }
-    std::cout << "\n";
-}
-
-// ==================== ОСНОВНОЙ ИГРОВОЙ ЦИКЛ ====================
-
-/**
- * @brief Запуск основной игровой сессии
- *
- * Управляет всем игровым процессом от приветствия до завершения
- * Включает заставку, выбор стратегии дилера и основной игровой цикл
- */
-void Game::startGame() {
-    loadStatistics();
-
-    // Красивая заставка
-    system("cls");
-    std::cout << R"(
-    .------..------..------..------..------.
-    |B.--. ||L.--. ||A.--. ||C.--. ||K.--. |
-    | :(): || :/\: || (\/) || :/\: || :/\: |
-    | ()() || (__) || :\/: || :\/: || :\/: |
-    | '--'B|| '--'L|| '--'A|| '--'C|| '--'K|
-    `------'`------'`------'`------'`------'
-    .------..------..------..------.
-    |J.--. ||A.--. ||C.--. ||K.--. |
-    | :(): || (\/) || :/\: || :/\: |
-    | ()() || :\/: || :\/: || :\/: |
-    | '--'J|| '--'A|| '--'C|| '--'K|
-    `------'`------'`------'`------'
-    )" << std::endl;
-
-    std::cout << "\nPress Enter to start...";
-    std::cin.ignore();
-
-    // Меню выбора стратегии дилера
-    std::cout << "\n=== WELCOME TO BLACKJACK ===\n";
-    std::cout << "\nSelect dealer strategy:\n";
-    std::cout << "1 - Standard (stops at 17+)\n";
-    std::cout << "2 - Aggressive (stops at 18+)\n";
-    std::cout << "3 - Cautious (stops at 16+)\n";
-    std::cout << "Your choice (1-3): ";
-
-    int strategyChoice;
-    std::cin >> strategyChoice;
-    std::cin.ignore(10000, '\n');
-
-    // Установка стратегии дилера
-    switch (strategyChoice) {
-    case 1:
-        dealer_.setStrategy(DealerStrategy::Standard);
-        break;
-    case 2:
-        dealer_.setStrategy(DealerStrategy::Aggressive);
-        break;
-    case 3:
-        dealer_.setStrategy(DealerStrategy::Cautious);
-        break;
-    default:
-        std::cout << "Invalid choice, using standard strategy\n";
-        dealer_.setStrategy(DealerStrategy::Standard);
-    }
-
-    // Основной игровой цикл
-    while (true) {
-        playRound();
-
-        // Статистика после раунда
-        std::cout << "\n--- CURRENT STATISTICS ---\n";
-        for (auto& player : players_) {
-            player.showStats();
-        }
-
-        // Запрос на продолжение
-        std::cout << "\nPlay again? (y/n): ";
-        char choice;
-        std::cin >> choice;
-        std::cin.ignore(10000, '\n');
-
-        if (choice != 'y' && choice != 'Y') {
-            break;
-        }
-
-        // Сброс состояния для нового раунда
-        deck_ = Deck();
-        deck_.shuffle();
-
-        for (auto& player : players_) {
-            player.clearHand();
-        }
-        dealer_.clearHand();
-    }
-
-    saveStatistics();
-    std::cout << "Thanks for playing!\n";
-}
-
-/**
- * @brief Выполнение одного игрового раунда
- *
- * Полный цикл раунда: раздача, ходы игроков, ход дилера, определение победителя
- */
-void Game::playRound() {
-    setTitleColor();
-    std::cout << "\n--- NEW ROUND ---\n";
-    resetColor();
-
-    deck_.shuffle();
-    dealInitialCards();
-    playerTurns();
-    dealerTurn();
-    determineWinner();
-}
-
-/**
- * @brief Начальная раздача карт
- *
- * Раздает по 2 карты каждому игроку и дилеру
- * Показывает стол со скрытыми картами дилера
- */
-void Game::dealInitialCards() {
-    // Раздача карт игрокам
-    for (auto& player : players_) {
-        player.takeCard(deck_);
-        player.takeCard(deck_);
-    }
-
-    // Раздача карт дилеру
-    dealer_.takeCard(deck_);
-    dealer_.takeCard(deck_);
-
-    // Показываем стол после раздачи
-    drawGameTableFirstDeal();
-}
-
-/**
- * @brief Очередь ходов игроков
- *
- * Каждый игрок по очереди делает свои ходы
- * Обрабатывает Split и создает новых игроков при разделении
- */
-void Game::playerTurns() {
-    std::vector<Player> newSplitPlayers;
-
-    for (size_t i = 0; i < players_.size(); ++i) {
-        auto& player = players_[i];
-
-        while (true) {
-            // Показываем актуальное состояние стола перед каждым ходом
-            drawGameTableFirstDeal();
-
-            std::cout << "\n" << player.getName() << ", your move:\n";
-            PlayerAction action = player.getPlayerAction();
-
-            // Условия выхода из цикла хода игрока
-            if (action == PlayerAction::Stand ||
-                action == PlayerAction::DoubleDown ||
-                player.isBusted()) {
-                break;
-            }
-
-            // Обработка Split
-            if (action == PlayerAction::Split && player.canSplit()) {
-                handleSplit(player, newSplitPlayers);
-            }
-
-            // Обработка Hit
-            if (action == PlayerAction::Hit) {
-                player.takeCard(deck_);
-                // Обновляем отображение после взятия карты
-                drawGameTableFirstDeal();
-            }
-        }
-    }
-
-    // Добавляем split-игроков в конец очереди
-    for (auto& splitPlayer : newSplitPlayers) {
-        players_.push_back(splitPlayer);
-    }
-}
-
-/**
- * @brief Ход дилера (автоматический)
- *
- * Дилер играет по установленной стратегии до достижения порогового значения
- */
-void Game::dealerTurn() {
-    // Показываем полный стол с картами дилера
-    drawGameTable();
-
-    setTitleColor();
-    std::cout << "\n--- Dealer's Move ---\n";
-    resetColor();
-
-    // Автоматическая игра дилера по стратегии
-    while (dealer_.mustDrawCard() && !dealer_.isBusted()) {
-        setColor(11); // Голубой для действий
-        std::cout << "The dealer takes the card...\n";
-        resetColor();
-
-        dealer_.takeCard(deck_);
-        drawGameTable(); // Обновляем отображение
-    }
-
-    // Результат хода дилера
-    if (dealer_.isBusted()) {
-        setErrorColor();
-        std::cout << "Dealer is busted!\n";
-        resetColor();
-    }
-    else {
-        setSuccessColor();
-        std::cout << "Dealer stands.\n";
-        resetColor();
-    }
-}
-
-/**
- * @brief Определение победителей раунда
- *
- * Сравнивает счета игроков и дилера, объявляет результаты
- * Обновляет статистику игроков
- */
-void Game::determineWinner() {
-    int dealerScore = dealer_.calculateScore();
-
-    // Показываем финальный стол
-    drawGameTable();
-
-    for (auto& player : players_) {
-        int playerScore = player.calculateScore();
-
-        setTitleColor();
-        std::cout << "\n=== RESULT for " << player.getName() << " ===\n";
-
-        if (player.isBusted()) {
-            setErrorColor();
-            std::cout << player.getName() << " busted! Dealer wins.\n";
-            player.recordLoss();
-        }
-        else if (dealer_.isBusted()) {
-            setSuccessColor();
-            std::cout << "Dealer busted! " << player.getName() << " wins!\n";
-            player.recordWin();
-        }
-        else if (playerScore > dealerScore) {
-            setSuccessColor();
-            std::cout << player.getName() << " wins! " << playerScore << " vs " << dealerScore << "\n";
-            player.recordWin();
-        }
-        else if (playerScore < dealerScore) {
-            setErrorColor();
-            std::cout << "Dealer wins! " << dealerScore << " vs " << playerScore << "\n";
-            player.recordLoss();
-        }
-        else {
-            setColor(14); // Желтый для ничьи
-            std::cout << "Push! " << player.getName() << " and dealer tie with " << playerScore << "\n";
-            player.recordPush();
-        }
-        resetColor();
-    }
-}
-
-// ==================== СИСТЕМА СТАТИСТИКИ ====================
-
-/**
- * @brief Загрузка статистики игроков из файла
- *
- * Читает статистику из файла blackjack_stats.txt
- * Восстанавливает прогресс игроков между сессиями
- */
-void Game::loadStatistics() {
-    std::ifstream file("blackjack_stats.txt");
-    if (!file) {
-        std::cout << "No statistics file found. Starting with clean statistics.\n";
-        return;
-    }
-
-    std::string line;
-    while (std::getline(file, line)) {
-        parsePlayerStats(line);
-    }
-    std::cout << "Statistics loaded successfully!\n";
-}
-
-/**
- * @brief Сохранение статистики игроков в файл
- *
- * Сохраняет статистику в файл blackjack_stats.txt
- * Формат: Имя:Игр:Побед:Поражений:Ничьих:МаксОчков
- */
-void Game::saveStatistics() {
-    std::ofstream file("blackjack_stats.txt");
-    if (!file) {
-        std::cout << "Error: Failed to create statistics file!\n";
-        return;
-    }
-
-    for (const auto& player : players_) {
-        file << player.getName() << ":"
-            << player.getGamesPlayed() << ":"
-            << player.getGamesWon() << ":"
-            << player.getGamesLost() << ":"
-            << player.getGamesPushed() << ":"
-            << player.getMaxScore() << "\n";
-    }
-
-    std::cout << "Statistics saved to file!\n";
-}
-
-/**
- * @brief Парсинг строки статистики из файла
- * @param line Строка для парсинга в формате "Имя:Игр:Побед:Поражений:Ничьих:МаксОчков"
- */
-void Game::parsePlayerStats(const std::string& line) {
-    std::istringstream iss(line);
-    std::string name;
-    int gamesPlayed, gamesWon, gamesLost, gamesPushed, maxScore;
-    char delimiter;
-
-    if (std::getline(iss, name, ':') >> gamesPlayed >> delimiter
-        >> gamesWon >> delimiter >> gamesLost >> delimiter >> gamesPushed
-        >> delimiter >> maxScore) {
-
-        for (auto& player : players_) {
-            if (player.getName() == name) {
-                player.setGamesPlayed(gamesPlayed);
-                player.setGamesWon(gamesWon);
-                player.setGamesLost(gamesLost);
-                player.setGamesPushed(gamesPushed);
-                player.setGamesScore(maxScore);
-                break;
-            }
-        }
-    }
-}
-
-// ==================== ОБРАБОТКА SPLIT ====================
-
-/**
- * @brief Обработка разделения карт (Split)
- * @param player Игрок выполняющий разделение
- * @param newSplitPlayers Вектор для новых игроков после разделения
- */
-void Game::handleSplit(Player& player, std::vector<Player>& newSplitPlayers) {
-    if (!player.canSplit()) return;
-
-    std::cout << player.getName() << " split hand!\n";
-
-    // Создание нового игрока для split-руки
-    Player splitPlayer(player.getName() + " (Split)");
-    auto secondHand = player.splitHand(deck_);
-    splitPlayer.setHand(secondHand);
-
-    // Добавление карт в обе руки
-    player.takeCard(deck_);
-    splitPlayer.takeCard(deck_);
-
-    // Сохранение нового игрока
-    newSplitPlayers.push_back(splitPlayer);
-
-    // Показываем обновленный стол после split
-    drawGameTableFirstDeal();
+﻿#include "game.h"
+#include "protocol.h"
+#include "profiler.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <cstring>
+
+/**
+ * @brief Конструктор игры
+ * @param input Поток ввода игроков
+ * @param observer Наблюдатель кадров
+ * @param statsFile Файл статистики
+ *
+ * Инициализирует игру и настраивает игроков
+ */
+Game::Game(std::istream& input, FrameObserver* observer, const std::string& statsFile)
+    : input_(input), frameObserver_(observer), statsFile_(statsFile) {
+    setupPlayers();
+}
+
+// ==================== МЕТОДЫ ОТОБРАЖЕНИЯ ====================
+
+/**
+ * @brief Отрисовка полного игрового стола со всеми картами
+ *
+ * Используется в конце раунда когда все карты дилера видны
+ */
+void Game::drawGameTable() const {
+    PROFILE_PHASE(RoundPhase::Render);
+
+    system("cls");
+
+    std::cout << "\n";
+    std::cout << "    ============================\n";
+    std::cout << "    |      BLACKJACK TABLE     |\n";
+    std::cout << "    ============================\n\n";
+
+    // Дилер (верх стола)
+    std::cout << "           DEALER'S HAND\n";
+    std::cout << "           ";
+    dealer_.showHand();
+    std::cout << "\n";
+
+    // Разделитель
+    std::cout << "    ----------------------------\n\n";
+
+    // Игроки (низ стола)  
+    for (const auto& player : players_) {
+        std::cout << "           " << player.getName() << "'s HAND\n";
+        for (size_t hand = 0; hand < player.getHandCount(); ++hand) {
+            std::cout << "           ";
+            player.showHand(hand);
+            std::cout << "\n";
+        }
+    }
+
+    // Нижняя часть стола
+    std::cout << "    ============================\n";
+    notifyFrameRendered();
+}
+
+/**
+ * @brief Отрисовка стола в начале раунда (скрытые карты дилера)
+ *
+ * Используется во время ходов игроков когда видна только первая карта дилера
+ */
+void Game::drawGameTableFirstDeal() const {
+    PROFILE_PHASE(RoundPhase::Render);
+
+    system("cls");
+
+    std::cout << "\n";
+    std::cout << "    ============================\n";
+    std::cout << "    |      BLACKJACK TABLE     |\n";
+    std::cout << "    ============================\n\n";
+
+    // Дилер (только первая карта видна)
+    std::cout << "           DEALER'S HAND\n";
+    std::cout << "           ";
+    dealer_.showFirstCard();
+    std::cout << "\n";
+
+    // Разделитель
+    std::cout << "    ----------------------------\n\n";
+
+    // Игроки  
+    for (const auto& player : players_) {
+        std::cout << "           " << player.getName() << "'s HAND\n";
+        for (size_t hand = 0; hand < player.getHandCount(); ++hand) {
+            std::cout << "           ";
+            player.showHand(hand);
+            std::cout << "\n";
+        }
+    }
+
+    std::cout << "    ============================\n";
+    notifyFrameRendered();
+}
+
+/**
+ * @brief Сообщить наблюдателю о готовом кадре
+ *
+ * Кадр считается готовым, когда он вытолкнут из буфера вывода
+ */
+void Game::notifyFrameRendered() const {
+    if (frameObserver_) {
+        std::cout.flush();
+        frameObserver_->onFrameRendered();
+    }
+}
+
+// ==================== НАСТРОЙКА ИГРОКОВ ====================
+
+/**
+ * @brief Настройка игроков перед началом игры
+ *
+ * Запрашивает количество игроков и их имена
+ * Валидирует ввод и устанавливает значения по умолчанию
+ */
+void Game::setupPlayers() {
+    int playerCount = 0;
+
+    while (playerCount < 1 || playerCount > 4) {
+        std::cout << "How many players? (1-4): ";
+        input_ >> playerCount;
+
+        if (input_.fail()) {
+            input_.clear();
+            input_.ignore(10000, '\n');
+            setErrorColor();
+            std::cout << "Error! Enter a number from 1 to 4.\n";
+            resetColor();
+            playerCount = 0;
+        }
+        else if (playerCount < 1 || playerCount > 4) {
+            setErrorColor();
+            std::cout << "Error! Enter a number from 1 to 4.\n";
+            resetColor();
+        }
+
+        input_.ignore(10000, '\n');
+    }
+
+    // Создание игроков
+    for (int i = 1; i <= playerCount; ++i) {
+        std::string playerName;
+        std::cout << "Enter name for player " << i << ": ";
+        std::getline(input_, playerName);
+
+        if (playerName.empty()) {
+            playerName = "Player " + std::to_string(i);
+        }
+
+        players_.emplace_back(playerName);
+        accounts_.push_back(ledger_.openAccount());
+    }
+    wagers_.assign(players_.size() * Player::MAX_HANDS, NO_WAGER);
+
+    // Подтверждение состава стола
+    std::cout << "\nAt the table: ";
+    for (const auto& player : players_) {
+        std::cout << player.getName() << " ";
+    }
+    std::cout << "\n";
+}
+
+// ==================== ОСНОВНОЙ ИГРОВОЙ ЦИКЛ ====================
+
+/**
+ * @brief Запуск основной игровой сессии
+ *
+ * Управляет всем игровым процессом от приветствия до завершения
+ * Включает заставку, выбор стратегии дилера и основной игровой цикл
+ */
+void Game::startGame() {
+    loadStatistics();
+
+    // Новым игрокам и проигравшим все - стартовый банкролл
+    for (uint32_t account : accounts_) {
+        if (ledger_.getBalance(account) == 0) {
+            ledger_.deposit(account, STARTING_BANKROLL);
+        }
+    }
+
+    // Красивая заставка
+    system("cls");
+    std::cout << R"(
+    .------..------..------..------..------.
+    |B.--. ||L.--. ||A.--. ||C.--. ||K.--. |
+    | :(): || :/\: || (\/) || :/\: || :/\: |
+    | ()() || (__) || :\/: || :\/: || :\/: |
+    | '--'B|| '--'L|| '--'A|| '--'C|| '--'K|
+    `------'`------'`------'`------'`------'
+    .------..------..------..------.
+    |J.--. ||A.--. ||C.--. ||K.--. |
+    | :(): || (\/) || :/\: || :/\: |
+    | ()() || :\/: || :\/: || :\/: |
+    | '--'J|| '--'A|| '--'C|| '--'K|
+    `------'`------'`------'`------'
+    )" << std::endl;
+
+    std::cout << "\nPress Enter to start...";
+    input_.ignore();
+
+    // Меню выбора стратегии дилера
+    std::cout << "\n=== WELCOME TO BLACKJACK ===\n";
+    std::cout << "\nSelect dealer strategy:\n";
+    std::cout << "1 - Standard (stops at 17+)\n";
+    std::cout << "2 - Aggressive (stops at 18+)\n";
+    std::cout << "3 - Cautious (stops at 16+)\n";
+    std::cout << "Your choice (1-3): ";
+
+    int strategyChoice;
+    input_ >> strategyChoice;
+    input_.ignore(10000, '\n');
+
+    // Установка стратегии дилера
+    switch (strategyChoice) {
+    case 1:
+        dealer_.setStrategy(DealerStrategy::Standard);
+        break;
+    case 2:
+        dealer_.setStrategy(DealerStrategy::Aggressive);
+        break;
+    case 3:
+        dealer_.setStrategy(DealerStrategy::Cautious);
+        break;
+    default:
+        std::cout << "Invalid choice, using standard strategy\n";
+        dealer_.setStrategy(DealerStrategy::Standard);
+    }
+
+    // Основной игровой цикл
+    while (true) {
+        playRound();
+
+        // Статистика после раунда
+        std::cout << "\n--- CURRENT STATISTICS ---\n";
+        for (size_t seat = 0; seat < players_.size(); ++seat) {
+            players_[seat].showStats();
+            std::cout << "Balance: " << formatChips(ledger_.getBalance(accounts_[seat])) << "\n";
+        }
+
+        // Запрос на продолжение
+#ifdef BLACKJACK_PROFILE
+        std::cout << "\nPlay again? (y/n, p - phase profile): ";
+#else
+        std::cout << "\nPlay again? (y/n): ";
+#endif
+        char choice;
+        input_ >> choice;
+        input_.ignore(10000, '\n');
+
+#ifdef BLACKJACK_PROFILE
+        // Сводка по фазам по запросу, затем снова вопрос о продолжении
+        while (choice == 'p' || choice == 'P') {
+            dumpPhaseProfile(std::cout);
+            std::cout << "\nPlay again? (y/n, p - phase profile): ";
+            input_ >> choice;
+            input_.ignore(10000, '\n');
+        }
+#endif
+
+        if (choice != 'y' && choice != 'Y') {
+            break;
+        }
+
+        // Сброс состояния для нового раунда
+        deck_ = Deck();
+        deck_.shuffle();
+
+        for (auto& player : players_) {
+            player.clearHand();
+        }
+        dealer_.clearHand();
+    }
+
+    saveStatistics();
+    std::cout << "Thanks for playing!\n";
+}
+
+/**
+ * @brief Выполнение одного игрового раунда
+ *
+ * Полный цикл раунда: ставки, раздача, ходы игроков, ход дилера, определение победителя
+ */
+void Game::playRound() {
+    setTitleColor();
+    std::cout << "\n--- NEW ROUND ---\n";
+    resetColor();
+
+    deck_.shuffle();
+    placeBets();
+    dealInitialCards();
+    playerTurns();
+    dealerTurn();
+    determineWinner();
+}
+
+/**
+ * @brief Прием ставок перед раздачей
+ *
+ * Пустой ввод - ставка по умолчанию (DEFAULT_BET или весь остаток).
+ * Игрок без фишек играет раунд без ставки - исходы идут только в статистику
+ */
+void Game::placeBets() {
+    wagers_.assign(players_.size() * Player::MAX_HANDS, NO_WAGER);
+
+    for (size_t seat = 0; seat < players_.size(); ++seat) {
+        const Player& player = players_[seat];
+        Chips balance = ledger_.getBalance(accounts_[seat]);
+        Chips stake = balance < DEFAULT_BET ? balance : DEFAULT_BET;
+
+        if (balance == 0) {
+            setErrorColor();
+            std::cout << player.getName() << " has no chips left and plays without a bet.\n";
+            resetColor();
+        }
+        while (balance > 0) {
+            std::cout << player.getName() << ", place your bet (balance " << formatChips(balance)
+                << ", Enter for " << formatChips(stake) << "): ";
+
+            std::string line;
+            std::getline(input_, line);
+            Chips entered = 0;
+            if (line.empty()) {
+                break;
+            }
+            if (parseChips(line, entered) && entered > 0 && entered <= balance) {
+                stake = entered;
+                break;
+            }
+
+            setErrorColor();
+            std::cout << "Error! Enter a bet from " << formatChips(1) << " to " << formatChips(balance) << ".\n";
+            resetColor();
+        }
+
+        ledger_.placeBet(accounts_[seat], stake, wagerOf(seat, 0));
+    }
+}
+
+/**
+ * @brief Начальная раздача карт
+ *
+ * Раздает по 2 карты каждому игроку и дилеру
+ * Показывает стол со скрытыми картами дилера
+ */
+void Game::dealInitialCards() {
+    PROFILE_PHASE(RoundPhase::DealInitialCards);
+
+    // Раздача карт игрокам
+    for (auto& player : players_) {
+        player.takeCard(deck_);
+        player.takeCard(deck_);
+    }
+
+    // Раздача карт дилеру
+    dealer_.takeCard(deck_);
+    dealer_.takeCard(deck_);
+
+    // Показываем стол после раздачи
+    drawGameTableFirstDeal();
+}
+
+/**
+ * @brief Очередь ходов игроков
+ *
+ * Каждый игрок по очереди играет все свои руки; руки после Split
+ * добавляются в конец списка рук игрока и играются в том же цикле
+ */
+void Game::playerTurns() {
+    PROFILE_PHASE(RoundPhase::PlayerTurns);
+
+    for (size_t seat = 0; seat < players_.size(); ++seat) {
+        Player& player = players_[seat];
+        for (size_t hand = 0; hand < player.getHandCount(); ++hand) {
+            player.selectHand(hand);
+
+            while (true) {
+                // Показываем актуальное состояние стола перед каждым ходом
+                drawGameTableFirstDeal();
+
+                std::cout << "\n" << player.getName() << ", your move:\n";
+                PlayerAction action = player.getPlayerAction(input_);
+
+                // Условия выхода из цикла хода руки
+                if (action == PlayerAction::Stand || player.isBusted()) {
+                    break;
+                }
+
+                // Удвоение завершает руку, если на него хватило фишек
+                if (action == PlayerAction::DoubleDown) {
+                    if (handleDoubleDown(seat)) {
+                        break;
+                    }
+                    continue;
+                }
+
+                // Обработка Split
+                if (action == PlayerAction::Split && player.canSplit()) {
+                    handleSplit(seat);
+                }
+
+                // Обработка Hit
+                if (action == PlayerAction::Hit) {
+                    player.takeCard(deck_);
+                    // Обновляем отображение после взятия карты
+                    drawGameTableFirstDeal();
+                }
+            }
+        }
+        player.selectHand(0);
+    }
+}
+
+/**
+ * @brief Ход дилера (автоматический)
+ *
+ * Дилер играет по установленной стратегии до достижения порогового значения
+ */
+void Game::dealerTurn() {
+    PROFILE_PHASE(RoundPhase::DealerTurn);
+
+    // Показываем полный стол с картами дилера
+    drawGameTable();
+
+    setTitleColor();
+    std::cout << "\n--- Dealer's Move ---\n";
+    resetColor();
+
+    // Автоматическая игра дилера по стратегии
+    while (dealer_.mustDrawCard() && !dealer_.isBusted()) {
+        setColor(11); // Голубой для действий
+        std::cout << "The dealer takes the card...\n";
+        resetColor();
+
+        dealer_.takeCard(deck_);
+        drawGameTable(); // Обновляем отображение
+    }
+
+    // Результат хода дилера
+    if (dealer_.isBusted()) {
+        setErrorColor();
+        std::cout << "Dealer is busted!\n";
+        resetColor();
+    }
+    else {
+        setSuccessColor();
+        std::cout << "Dealer stands.\n";
+        resetColor();
+    }
+}
+
+/**
+ * @brief Определение победителей раунда
+ *
+ * Сравнивает счета игроков и дилера, объявляет результаты
+ * Обновляет статистику игроков и рассчитывает все ставки раунда одной пачкой
+ */
+void Game::determineWinner() {
+    PROFILE_PHASE(RoundPhase::DetermineWinner);
+
+    int dealerScore = dealer_.calculateScore();
+
+    // Показываем финальный стол
+    drawGameTable();
+
+    for (size_t seat = 0; seat < players_.size(); ++seat) {
+        Player& player = players_[seat];
+
+        // Каждая рука после Split - отдельный исход в статистике того же игрока
+        for (size_t hand = 0; hand < player.getHandCount(); ++hand) {
+            player.selectHand(hand);
+            int playerScore = player.calculateScore();
+
+            setTitleColor();
+            std::cout << "\n=== RESULT for " << player.getName();
+            if (player.getHandCount() > 1) {
+                std::cout << " (hand " << hand + 1 << ")";
+            }
+            std::cout << " ===\n";
+
+            RoundOutcome outcome = RoundOutcome::Push;
+            WagerResult result = settleHand(player, dealer_, outcome);
+
+            switch (outcome) {
+            case RoundOutcome::Win:
+                setSuccessColor();
+                if (result == WagerResult::Natural) {
+                    std::cout << "Blackjack! " << player.getName() << " wins 3:2!\n";
+                }
+                else if (dealer_.isBusted()) {
+                    std::cout << "Dealer busted! " << player.getName() << " wins!\n";
+                }
+                else {
+                    std::cout << player.getName() << " wins! " << playerScore << " vs " << dealerScore << "\n";
+                }
+                player.recordWin();
+                break;
+            case RoundOutcome::Loss:
+                setErrorColor();
+                if (player.isBusted()) {
+                    std::cout << player.getName() << " busted! Dealer wins.\n";
+                }
+                else if (dealer_.hasNatural()) {
+                    std::cout << "Dealer has Blackjack! " << player.getName() << " loses.\n";
+                }
+                else {
+                    std::cout << "Dealer wins! " << dealerScore << " vs " << playerScore << "\n";
+                }
+                player.recordLoss();
+                break;
+            case RoundOutcome::Push:
+                setColor(14); // Желтый для ничьи
+                std::cout << "Push! " << player.getName() << " and dealer tie with " << playerScore << "\n";
+                player.recordPush();
+                break;
+            }
+            resetColor();
+
+            size_t wager = wagerOf(seat, hand);
+            if (wager != NO_WAGER) {
+                ledger_.setResult(wager, result);
+                Chips stake = ledger_.getWager(wager).stake;
+                Chips net = wagerReturn(stake, result) - stake;
+                std::cout << "Bet " << formatChips(stake) << ": " << (net > 0 ? "+" : "") << formatChips(net) << "\n";
+            }
+        }
+        player.selectHand(0);
+    }
+
+    // Все ставки раунда закрываются вместе; номера ставок после settle() недействительны
+    ledger_.settle();
+    wagers_.assign(players_.size() * Player::MAX_HANDS, NO_WAGER);
+}
+
+/**
+ * @brief Исход руки против дилера
+ *
+ * Перебор игрока проигрывает всегда, даже если дилер тоже перебрал;
+ * иначе перебор дилера - победа, дальше сравнение счета
+ */
+RoundOutcome Game::judgeHand(const Player& player, const Dealer& dealer) {
+    if (player.isBusted()) {
+        return RoundOutcome::Loss;
+    }
+    if (dealer.isBusted()) {
+        return RoundOutcome::Win;
+    }
+
+    int playerScore = player.calculateScore();
+    int dealerScore = dealer.calculateScore();
+    if (playerScore > dealerScore) {
+        return RoundOutcome::Win;
+    }
+    if (playerScore < dealerScore) {
+        return RoundOutcome::Loss;
+    }
+    return RoundOutcome::Push;
+}
+
+/**
+ * @brief Итог ставки руки с правилами блэкджеков
+ *
+ * Блэкджек бьет 21 дилера из трех карт, а блэкджек дилера - любую 21
+ * игрока, кроме блэкджека; исход для статистики следует итогу ставки
+ */
+WagerResult Game::settleHand(const Player& player, const Dealer& dealer, RoundOutcome& outcome) {
+    outcome = judgeHand(player, dealer);
+    WagerResult result = wagerResult(outcome, player.hasNatural(), dealer.hasNatural());
+    if (result == WagerResult::Natural) {
+        outcome = RoundOutcome::Win;
+    }
+    else if (result == WagerResult::Loss) {
+        outcome = RoundOutcome::Loss;
+    }
+    return result;
+}
+
+// ==================== СИСТЕМА СТАТИСТИКИ ====================
+
+/**
+ * @brief Загрузка статистики игроков из файла
+ *
+ * Читает статистику из файла statsFile_ (по умолчанию blackjack_stats.txt)
+ * Восстанавливает прогресс игроков между сессиями
+ */
+void Game::loadStatistics() {
+    PROFILE_PHASE(RoundPhase::StatsIo);
+    if (statsFile_.empty()) {
+        return;
+    }
+
+    std::ifstream file(statsFile_);
+    if (!file) {
+        std::cout << "No statistics file found. Starting with clean statistics.\n";
+        return;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        parsePlayerStats(line);
+    }
+    std::cout << "Statistics loaded successfully!\n";
+}
+
+/**
+ * @brief Сохранение статистики игроков в файл
+ *
+ * Сохраняет статистику в файл statsFile_ (по умолчанию blackjack_stats.txt)
+ * Формат: Имя:Игр:Побед:Поражений:Ничьих:МаксОчков:Баланс (баланс в сотых фишки)
+ */
+void Game::saveStatistics() {
+    PROFILE_PHASE(RoundPhase::StatsIo);
+    if (statsFile_.empty()) {
+        return;
+    }
+
+    std::ofstream file(statsFile_);
+    if (!file) {
+        std::cout << "Error: Failed to create statistics file!\n";
+        return;
+    }
+
+    for (size_t seat = 0; seat < players_.size(); ++seat) {
+        const Player& player = players_[seat];
+        file << player.getName() << ":"
+            << player.getGamesPlayed() << ":"
+            << player.getGamesWon() << ":"
+            << player.getGamesLost() << ":"
+            << player.getGamesPushed() << ":"
+            << player.getMaxScore() << ":"
+            << ledger_.getBalance(accounts_[seat]) << "\n";
+    }
+
+    std::cout << "Statistics saved to file!\n";
+}
+
+/**
+ * @brief Парсинг строки статистики из файла
+ * @param line Строка для парсинга в формате "Имя:Игр:Побед:Поражений:Ничьих:МаксОчков[:Баланс]"
+ *
+ * Файлы без баланса (до появления ставок) тоже читаются - игрок получит стартовый банкролл
+ */
+void Game::parsePlayerStats(const std::string& line) {
+    std::istringstream iss(line);
+    std::string name;
+    int gamesPlayed, gamesWon, gamesLost, gamesPushed, maxScore;
+    char delimiter;
+
+    if (std::getline(iss, name, ':') >> gamesPlayed >> delimiter
+        >> gamesWon >> delimiter >> gamesLost >> delimiter >> gamesPushed
+        >> delimiter >> maxScore) {
+
+        Chips balance = 0;
+        if (!(iss >> delimiter >> balance) || balance < 0) {
+            balance = 0;
+        }
+
+        for (size_t seat = 0; seat < players_.size(); ++seat) {
+            Player& player = players_[seat];
+            if (player.getName() == name) {
+                player.setGamesPlayed(gamesPlayed);
+                player.setGamesWon(gamesWon);
+                player.setGamesLost(gamesLost);
+                player.setGamesPushed(gamesPushed);
+                player.setGamesScore(maxScore);
+                if (ledger_.getBalance(accounts_[seat]) == 0) {
+                    ledger_.deposit(accounts_[seat], balance);
+                }
+                break;
+            }
+        }
+    }
+}
+
+// ==================== ОБРАБОТКА SPLIT ====================
+
+/**
+ * @brief Обработка разделения карт (Split)
+ * @param seat Номер игрока выполняющего разделение
+ *
+ * Новая рука живет внутри того же игрока: ее исход идет в его статистику,
+ * а ставка, равная ставке исходной руки, списывается с его счета
+ */
+void Game::handleSplit(size_t seat) {
+    Player& player = players_[seat];
+    if (!player.canSplit()) return;
+
+    size_t wager = wagerOf(seat, player.getActiveHand());
+    size_t splitWager = NO_WAGER;
+    if (wager != NO_WAGER && !ledger_.splitBet(wager, splitWager)) {
+        setErrorColor();
+        std::cout << "Not enough chips to split!\n";
+        resetColor();
+        return;
+    }
+
+    player.splitActiveHand(deck_);
+    wagerOf(seat, player.getHandCount() - 1) = splitWager;
+
+    std::cout << player.getName() << " split hand!\n";
+
+    // Показываем обновленный стол после split
+    drawGameTableFirstDeal();
+}
+
+/**
+ * @brief Обработка удвоения (Double Down)
+ * @param seat Номер игрока
+ * @return false если на счете не хватает фишек
+ *
+ * Ставка активной руки удваивается, рука получает ровно одну карту
+ * и на этом заканчивается - как Table::applyDecision()
+ */
+bool Game::handleDoubleDown(size_t seat) {
+    Player& player = players_[seat];
+    size_t wager = wagerOf(seat, player.getActiveHand());
+    if (wager != NO_WAGER && !ledger_.doubleBet(wager)) {
+        setErrorColor();
+        std::cout << "Not enough chips to double down!\n";
+        resetColor();
+        return false;
+    }
+
+    player.takeCard(deck_);
+    drawGameTableFirstDeal();
+    return true;
+}
+
+// ==================== СНИМКИ ====================
+
+/**
+ * @brief Сохранить состояние игры в плоский снимок
+ * @param snapshot [out] Снимок
+ * @return false если игроков больше SNAPSHOT_MAX_SEATS или рука слишком длинная
+ *
+ * Номер хода в снимок не попадает: в консольной игре его хранит цикл
+ * playerTurns(), поэтому activeSeat всегда NO_ACTIVE_SEAT
+ */
+bool Game::saveSnapshot(GameSnapshot& snapshot) const {
+    std::memset(&snapshot, 0, sizeof(snapshot));
+    if (players_.size() > SNAPSHOT_MAX_SEATS) {
+        return false;
+    }
+
+    snapshot.version = SNAPSHOT_VERSION;
+    snapshot.seatCount = static_cast<uint8_t>(players_.size());
+    snapshot.activeSeat = NO_ACTIVE_SEAT;
+    snapshot.dealerStrategy = static_cast<uint8_t>(dealer_.getStrategy());
+
+    saveDeck(snapshot, deck_);
+    bool valid = saveHand(snapshot.dealer, dealer_.getHand());
+    for (size_t i = 0; i < players_.size() && valid; ++i) {
+        valid = saveSeat(snapshot.seats[i], players_[i]);
+    }
+
+    // Деньги: баланс счета и открытые ставки рук текущего раунда
+    for (size_t i = 0; i < players_.size() && valid; ++i) {
+        saveWagers(snapshot.seats[i], ledger_, accounts_[i], &wagers_[i * Player::MAX_HANDS]);
+    }
+    return valid;
+}
+
+/**
+ * @brief Восстановить состояние игры из снимка
+ * @param snapshot Снимок
+ * @return false если снимок поврежден
+ */
+bool Game::restoreSnapshot(const GameSnapshot& snapshot) {
+    if (!isValidSnapshot(snapshot)) {
+        return false;
+    }
+
+    dealer_.restoreStrategy(static_cast<DealerStrategy>(snapshot.dealerStrategy));
+    while (players_.size() > snapshot.seatCount) {
+        players_.pop_back();
+    }
+    while (players_.size() < snapshot.seatCount) {
+        players_.emplace_back("Player " + std::to_string(players_.size() + 1));
+    }
+
+    bool valid = restoreDeck(snapshot, deck_) && restoreHand(snapshot.dealer, dealer_);
+    for (size_t i = 0; i < players_.size() && valid; ++i) {
+        valid = restoreSeat(snapshot.seats[i], players_[i]);
+    }
+
+    // Новая книга: счета и ставки открываются заново, как было до снимка
+    ledger_.reset();
+    accounts_.clear();
+    wagers_.assign(players_.size() * Player::MAX_HANDS, NO_WAGER);
+    for (size_t i = 0; i < players_.size() && valid; ++i) {
+        accounts_.push_back(restoreWagers(snapshot.seats[i], ledger_, &wagers_[i * Player::MAX_HANDS]));
+    }
+    return valid;
 }
\ No newline at end of file
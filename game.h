@@ -1,118 +1,209 @@
-#pragma once
-#include "player.h"
-#include "dealer.h"
-#include "deck.h"
-#include <vector>
-#include <fstream>
-#include <sstream>
-#include <windows.h>
-
-/**
- * @brief Основной класс игры Blackjack
- *
- * Управляет игровым процессом, координацией между игроками и дилером,
- * отображением игрового стола и статистикой
- */
-class Game {
-public:
-    /**
-     * @brief Конструктор игры
-     */
-    Game();
-
-    /**
-     * @brief Запуск основной игровой сессии
-     */
-    void startGame();
-
-    /**
-     * @brief Выполнение одного игрового раунда
-     */
-    void playRound();
-
-    /**
-     * @brief Сохранение статистики игроков в файл
-     */
-    void saveStatistics();
-
-    /**
-     * @brief Загрузка статистики игроков из файла
-     */
-    void loadStatistics();
-
-    // ==================== ЦВЕТОВЫЕ МЕТОДЫ ====================
-
-    /**
-     * @brief Установка цвета текста в консоли
-     * @param color Код цвета Windows
-     */
-    static void setColor(int color) {
-        HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-        SetConsoleTextAttribute(hConsole, color);
-    }
-
-    static void resetColor() { setColor(7); }      ///< Сброс к стандартному цвету
-    static void setTitleColor() { setColor(13); }  ///< Фиолетовый для заголовков
-    static void setSuccessColor() { setColor(10); } ///< Зеленый для успешных действий
-    static void setErrorColor() { setColor(12); }   ///< Красный для ошибок
-
-private:
-    // ==================== МЕТОДЫ ОТОБРАЖЕНИЯ ====================
-
-    /**
-     * @brief Отрисовка полного игрового стола со всеми картами
-     */
-    void drawGameTable() const;
-
-    /**
-     * @brief Отрисовка стола в начале раунда (скрытые карты дилера)
-     */
-    void drawGameTableFirstDeal() const;
-
-    // ==================== ИГРОВАЯ ЛОГИКА ====================
-
-    /**
-     * @brief Настройка игроков перед началом игры
-     */
-    void setupPlayers();
-
-    /**
-     * @brief Начальная раздача карт
-     */
-    void dealInitialCards();
-
-    /**
-     * @brief Очередь ходов игроков
-     */
-    void playerTurns();
-
-    /**
-     * @brief Ход дилера (автоматический)
-     */
-    void dealerTurn();
-
-    /**
-     * @brief Определение победителей раунда
-     */
-    void determineWinner();
-
-    /**
-     * @brief Обработка разделения карт (Split)
-     * @param player Игрок выполняющий разделение
-     * @param newSplitPlayers Вектор для новых игроков после разделения
-     */
-    void handleSplit(Player& player, std::vector<Player>& newSplitPlayers);
-
-    // ==================== СИСТЕМА СТАТИСТИКИ ====================
-
-    /**
-     * @brief Парсинг строки статистики из файла
-     * @param line Строка для парсинга
-     */
-    void parsePlayerStats(const std::string& line);
-
-private:
-    Deck deck_;                     ///< Игровая колода карт
-    std::vector<Player> players_;   ///< Список игроков за столом
-    Dealer dealer_;                 ///< Дилер (крупье)
+#pragma once
+#include "player.h"
+#include "dealer.h"
+#include "deck.h"
+#include "snapshot.h"
+#include "protocol.h"
+#include "ledger.h"
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <sstream>
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+/**
+ * @brief Наблюдатель отрисовки кадров стола
+ *
+ * Нужен сценарному режиму: время от ввода до готового кадра
+ */
+class FrameObserver {
+public:
+    virtual ~FrameObserver() = default;
+
+    /**
+     * @brief Кадр стола отрисован и выведен
+     */
+    virtual void onFrameRendered() = 0;
+};
+
+/**
+ * @brief Основной класс игры Blackjack
+ *
+ * Управляет игровым процессом, координацией между игроками и дилером,
+ * отображением игрового стола и статистикой. Ставки игроков ведет
+ * книга фишек: у каждого игрока свой счет, раунд рассчитывается пачкой.
+ */
+class Game {
+public:
+    /**
+     * @brief Конструктор игры
+     * @param input Поток ввода (по умолчанию консоль; сценарный режим подставляет свой)
+     * @param observer Наблюдатель кадров (nullptr - без наблюдения)
+     * @param statsFile Файл статистики (пустая строка - не загружать и не сохранять)
+     */
+    explicit Game(std::istream& input = std::cin, FrameObserver* observer = nullptr,
+        const std::string& statsFile = "blackjack_stats.txt");
+
+    /**
+     * @brief Запуск основной игровой сессии
+     */
+    void startGame();
+
+    /**
+     * @brief Выполнение одного игрового раунда
+     */
+    void playRound();
+
+    /**
+     * @brief Сохранение статистики игроков в файл
+     */
+    void saveStatistics();
+
+    /**
+     * @brief Загрузка статистики игроков из файла
+     */
+    void loadStatistics();
+
+    /**
+     * @brief Сохранить колоду, руки, закрытую карту дилера, статистику, счета и ставки в снимок
+     * @param snapshot [out] Снимок
+     * @return false если игроков больше SNAPSHOT_MAX_SEATS
+     */
+    bool saveSnapshot(GameSnapshot& snapshot) const;
+
+    /**
+     * @brief Восстановить игру из снимка
+     * @param snapshot Снимок
+     * @return false если снимок поврежден
+     */
+    bool restoreSnapshot(const GameSnapshot& snapshot);
+
+    /**
+     * @brief Исход руки против дилера по очкам (без правил блэкджеков - см. settleHand())
+     * @param player Игрок
+     * @param dealer Дилер, закончивший ход
+     * @return Исход для игрока
+     */
+    static RoundOutcome judgeHand(const Player& player, const Dealer& dealer);
+
+    /**
+     * @brief Итог ставки руки: judgeHand() с правилами блэкджеков (wagerResult)
+     * @param player Игрок
+     * @param dealer Дилер, закончивший ход
+     * @param outcome [out] Исход для статистики: блэкджек игрока - победа, блэкджек дилера - поражение
+     * @return Итог для расчета ставки
+     *
+     * Общий расчет для Game::determineWinner() и Table
+     */
+    static WagerResult settleHand(const Player& player, const Dealer& dealer, RoundOutcome& outcome);
+
+    // ==================== ЦВЕТОВЫЕ МЕТОДЫ ====================
+
+    /**
+     * @brief Установка цвета текста в консоли
+     * @param color Код цвета Windows
+     */
+    static void setColor(int color) {
+        HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+        SetConsoleTextAttribute(hConsole, color);
+    }
+
+    static void resetColor() { setColor(7); }      ///< Сброс к стандартному цвету
+    static void setTitleColor() { setColor(13); }  ///< Фиолетовый для заголовков
+    static void setSuccessColor() { setColor(10); } ///< Зеленый для успешных действий
+    static void setErrorColor() { setColor(12); }   ///< Красный для ошибок
+
+private:
+    // ==================== МЕТОДЫ ОТОБРАЖЕНИЯ ====================
+
+    /**
+     * @brief Отрисовка полного игрового стола со всеми картами
+     */
+    void drawGameTable() const;
+
+    /**
+     * @brief Отрисовка стола в начале раунда (скрытые карты дилера)
+     */
+    void drawGameTableFirstDeal() const;
+
+    // ==================== ИГРОВАЯ ЛОГИКА ====================
+
+    /**
+     * @brief Настройка игроков перед началом игры
+     */
+    void setupPlayers();
+
+    /**
+     * @brief Прием ставок перед раздачей
+     */
+    void placeBets();
+
+    /**
+     * @brief Начальная раздача карт
+     */
+    void dealInitialCards();
+
+    /**
+     * @brief Очередь ходов игроков
+     */
+    void playerTurns();
+
+    /**
+     * @brief Ход дилера (автоматический)
+     */
+    void dealerTurn();
+
+    /**
+     * @brief Определение победителей раунда
+     */
+    void determineWinner();
+
+    /**
+     * @brief Обработка разделения карт (Split)
+     * @param seat Номер игрока (новая рука и ее ставка остаются у него)
+     */
+    void handleSplit(size_t seat);
+
+    /**
+     * @brief Обработка удвоения (Double Down): ставка x2 и ровно одна карта
+     * @param seat Номер игрока
+     * @return false если на счете не хватает фишек и ход продолжается
+     */
+    bool handleDoubleDown(size_t seat);
+
+    /**
+     * @brief Номер ставки руки в книге фишек
+     */
+    size_t& wagerOf(size_t seat, size_t hand) { return wagers_[seat * Player::MAX_HANDS + hand]; }
+
+    // ==================== СИСТЕМА СТАТИСТИКИ ====================
+
+    /**
+     * @brief Парсинг строки статистики из файла
+     * @param line Строка для парсинга
+     */
+    void parsePlayerStats(const std::string& line);
+
+    /**
+     * @brief Сообщить наблюдателю о готовом кадре
+     */
+    void notifyFrameRendered() const;
+
+private:
+    Deck deck_;                     ///< Игровая колода карт
+    std::vector<Player> players_;   ///< Список игроков за столом
+    Dealer dealer_;                 ///< Дилер (крупье)
+    std::istream& input_;           ///< Поток ввода игроков
+    FrameObserver* frameObserver_;  ///< Наблюдатель кадров (может быть nullptr)
+    std::string statsFile_;         ///< Файл статистики
+    ChipLedger ledger_;             ///< Счета игроков и ставки раунда
+    std::vector<uint32_t> accounts_; ///< Счет каждого игрока
+    std::vector<size_t> wagers_;    ///< Ставки рук (MAX_HANDS на игрока, NO_WAGER - без ставки)
 };
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "histogram.h"
+#include <iomanip>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+ * @brief Номер старшего установленного бита (value > 0)
+ */
+static int highestBit(uint64_t value) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long bit;
+    _BitScanReverse64(&bit, value);
+    return static_cast<int>(bit);
+#elif defined(__GNUC__)
+    return 63 - __builtin_clzll(value);
+#else
+    int bit = 0;
+    while (value >>= 1) {
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+size_t LatencyHistogram::bucketIndex(uint64_t value) {
+    if (value < static_cast<uint64_t>(LINEAR_LIMIT)) {
+        return static_cast<size_t>(value);
+    }
+
+    int exponent = highestBit(value);
+    if (exponent > MAX_EXPONENT) {
+        return BUCKET_COUNT - 1;
+    }
+
+    int shift = exponent - SUB_BUCKET_BITS;
+    size_t sub = static_cast<size_t>(value >> shift) - SUB_BUCKETS;
+    return LINEAR_LIMIT + static_cast<size_t>(exponent - SUB_BUCKET_BITS - 1) * SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyHistogram::bucketLowerBound(size_t bucket) {
+    if (bucket < static_cast<size_t>(LINEAR_LIMIT)) {
+        return bucket;
+    }
+
+    size_t offset = bucket - LINEAR_LIMIT;
+    int exponent = static_cast<int>(offset / SUB_BUCKETS) + SUB_BUCKET_BITS + 1;
+    uint64_t sub = offset % SUB_BUCKETS;
+    return (SUB_BUCKETS + sub) << (exponent - SUB_BUCKET_BITS);
+}
+
+void LatencyHistogram::record(uint64_t value) {
+    buckets_[bucketIndex(value)]++;
+    count_++;
+    sum_ += value;
+    if (value < min_) min_ = value;
+    if (value > max_) max_ = value;
+}
+
+void LatencyHistogram::record(uint64_t value, uint64_t count) {
+    if (count == 0) {
+        return;
+    }
+    buckets_[bucketIndex(value)] += count;
+    count_ += count;
+    sum_ += value * count;
+    if (value < min_) min_ = value;
+    if (value > max_) max_ = value;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    if (other.count_ > 0 && other.min_ < min_) min_ = other.min_;
+    if (other.max_ > max_) max_ = other.max_;
+}
+
+void LatencyHistogram::reset() {
+    *this = LatencyHistogram();
+}
+
+uint64_t LatencyHistogram::valueAtPercentile(double percentile) const {
+    if (count_ == 0) {
+        return 0;
+    }
+
+    uint64_t target = static_cast<uint64_t>(percentile / 100.0 * count_ + 0.5);
+    if (target < 1) target = 1;
+    if (target > count_) target = count_;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets_[i];
+        if (seen >= target) {
+            return bucketLowerBound(i);
+        }
+    }
+    return max_;
+}
+
+void LatencyHistogram::print(std::ostream& os, const std::string& title, double divisor, const std::string& unit) const {
+    os << "\n--- " << title << " (" << unit << ") ---\n";
+    if (count_ == 0) {
+        os << "No samples.\n";
+        return;
+    }
+
+    os << std::fixed << std::setprecision(1);
+    os << "Samples: " << count_ << "\n";
+    os << "Min: " << getMin() / divisor << "  Mean: " << getMean() / divisor
+        << "  Max: " << max_ / divisor << "\n";
+    os << "p50: " << valueAtPercentile(50.0) / divisor
+        << "  p90: " << valueAtPercentile(90.0) / divisor
+        << "  p99: " << valueAtPercentile(99.0) / divisor
+        << "  p99.9: " << valueAtPercentile(99.9) / divisor << "\n";
+
+    // Распределение по октавам (степеням двойки)
+    uint64_t octaveCounts[MAX_EXPONENT + 1] = {};
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        uint64_t lower = bucketLowerBound(i);
+        octaveCounts[lower > 0 ? highestBit(lower) : 0] += buckets_[i];
+    }
+    for (int octave = 0; octave <= MAX_EXPONENT; ++octave) {
+        if (octaveCounts[octave] == 0) continue;
+        os << "  >= " << std::setw(10) << (octave > 0 ? (1ull << octave) / divisor : 0.0) << " " << unit
+            << ": " << std::setw(10) << octaveCounts[octave]
+            << "  (" << std::setw(5) << 100.0 * octaveCounts[octave] / count_ << "%)\n";
+    }
+}
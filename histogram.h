@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+/**
+ * @brief Логарифмически-линейная гистограмма задержек (в стиле HDR)
+ *
+ * Значения до 64 хранятся точно, дальше каждый интервал [2^k, 2^(k+1))
+ * делится на 32 равные корзины - относительная погрешность не более ~3%.
+ * Память фиксирована, запись - O(1) без выделений.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 5;                          ///< 32 корзины на октаву
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;           ///< Корзин на октаву
+    static constexpr int LINEAR_LIMIT = SUB_BUCKETS * 2;               ///< Граница точных значений
+    static constexpr int MAX_EXPONENT = 47;                            ///< Старший учитываемый бит
+    static constexpr size_t BUCKET_COUNT =
+        LINEAR_LIMIT + (MAX_EXPONENT - SUB_BUCKET_BITS) * SUB_BUCKETS; ///< Всего корзин
+
+    /**
+     * @brief Записать значение
+     * @param value Значение (обычно наносекунды)
+     */
+    void record(uint64_t value);
+
+    /**
+     * @brief Записать значение несколько раз
+     * @param value Значение
+     * @param count Число повторов
+     */
+    void record(uint64_t value, uint64_t count);
+
+    /**
+     * @brief Добавить содержимое другой гистограммы
+     * @param other Гистограмма того же формата
+     */
+    void merge(const LatencyHistogram& other);
+
+    /**
+     * @brief Очистить гистограмму
+     */
+    void reset();
+
+    /**
+     * @brief Значение перцентиля
+     * @param percentile Перцентиль (0-100)
+     * @return Нижняя граница корзины, содержащей перцентиль
+     */
+    uint64_t valueAtPercentile(double percentile) const;
+
+    /// @name Геттеры
+    /// @{
+    uint64_t getCount() const { return count_; }
+    uint64_t getMin() const { return count_ ? min_ : 0; }
+    uint64_t getMax() const { return max_; }
+    double getMean() const { return count_ ? static_cast<double>(sum_) / count_ : 0.0; }
+    uint64_t getBucketCount(size_t bucket) const { return buckets_[bucket]; }
+    /// @}
+
+    /**
+     * @brief Номер корзины для значения
+     */
+    static size_t bucketIndex(uint64_t value);
+
+    /**
+     * @brief Нижняя граница корзины
+     */
+    static uint64_t bucketLowerBound(size_t bucket);
+
+    /**
+     * @brief Вывести перцентили и распределение по октавам
+     * @param os Поток вывода
+     * @param title Заголовок
+     * @param divisor Делитель для вывода (например 1000 для нс -> мкс)
+     * @param unit Подпись единиц
+     */
+    void print(std::ostream& os, const std::string& title, double divisor, const std::string& unit) const;
+
+private:
+    uint64_t buckets_[BUCKET_COUNT] = {}; ///< Счетчики корзин
+    uint64_t count_ = 0;                  ///< Число значений
+    uint64_t sum_ = 0;                    ///< Сумма значений
+    uint64_t min_ = UINT64_MAX;           ///< Минимум
+    uint64_t max_ = 0;                    ///< Максимум
+};
@@ -0,0 +1,166 @@
+#include "ledger.h"
+#include <cctype>
+
+// ==================== ВЫПЛАТЫ ====================
+
+WagerResult wagerResult(RoundOutcome outcome, bool playerNatural, bool dealerNatural) {
+    if (playerNatural && !dealerNatural) {
+        return WagerResult::Natural;
+    }
+    if (dealerNatural && !playerNatural) {
+        return WagerResult::Loss; // 21 из трех карт или после Split не равна блэкджеку дилера
+    }
+    switch (outcome) {
+    case RoundOutcome::Win:  return WagerResult::Win;
+    case RoundOutcome::Loss: return WagerResult::Loss;
+    case RoundOutcome::Push: break;
+    }
+    return WagerResult::Push;
+}
+
+/**
+ * @brief Возврат в половинах ставки по итогу: 0, 1:1 назад, 2:1 назад, 5:2 назад
+ */
+static const Chips RETURN_HALVES[] = { 0, 2, 4, 5 };
+
+Chips wagerReturn(Chips stake, WagerResult result) {
+    return stake * RETURN_HALVES[static_cast<size_t>(result)] / 2;
+}
+
+std::string formatChips(Chips amount) {
+    std::string sign = amount < 0 ? "-" : "";
+    Chips magnitude = amount < 0 ? -amount : amount;
+    std::string cents = std::to_string(magnitude % CHIP_SCALE);
+    if (cents.size() < 2) cents = "0" + cents;
+    return sign + std::to_string(magnitude / CHIP_SCALE) + "." + cents;
+}
+
+bool parseChips(const std::string& text, Chips& amount) {
+    Chips whole = 0;
+    Chips fraction = 0;
+    int fractionDigits = -1; // -1 - точки еще не было
+    bool anyDigit = false;
+
+    for (char c : text) {
+        if (c == '.' && fractionDigits < 0) {
+            fractionDigits = 0;
+        }
+        else if (std::isdigit(static_cast<unsigned char>(c))) {
+            anyDigit = true;
+            if (fractionDigits < 0) {
+                whole = whole * 10 + (c - '0');
+                if (whole > (Chips(1) << 40)) return false; // Заведомо больше любого банкролла
+            }
+            else if (++fractionDigits > 2) {
+                return false;
+            }
+            else {
+                fraction = fraction * 10 + (c - '0');
+            }
+        }
+        else {
+            return false;
+        }
+    }
+    if (!anyDigit) {
+        return false;
+    }
+
+    if (fractionDigits == 1) fraction *= 10;
+    amount = whole * CHIP_SCALE + fraction;
+    return true;
+}
+
+// ==================== СЧЕТА ====================
+
+uint32_t ChipLedger::openAccount(Chips deposit) {
+    balances_.push_back(0);
+    uint32_t account = static_cast<uint32_t>(balances_.size() - 1);
+    this->deposit(account, deposit);
+    return account;
+}
+
+void ChipLedger::deposit(uint32_t account, Chips amount) {
+    balances_[account] += amount;
+    deposits_ += amount;
+}
+
+bool ChipLedger::debit(uint32_t account, Chips amount) {
+    if (amount < 0 || amount > balances_[account]) {
+        return false;
+    }
+    balances_[account] -= amount;
+    inPlay_ += amount;
+    return true;
+}
+
+// ==================== СТАВКИ РАУНДА ====================
+
+bool ChipLedger::placeBet(uint32_t account, Chips stake, size_t& wager) {
+    if (!debit(account, stake)) {
+        return false;
+    }
+
+    Wager entry;
+    entry.account = account;
+    entry.stake = stake;
+    pending_.push_back(entry);
+    wager = pending_.size() - 1;
+    return true;
+}
+
+bool ChipLedger::doubleBet(size_t wager) {
+    Wager& entry = pending_[wager];
+    if (!debit(entry.account, entry.stake)) {
+        return false;
+    }
+    entry.stake *= 2;
+    entry.doubled = true;
+    return true;
+}
+
+bool ChipLedger::splitBet(size_t wager, size_t& splitWager) {
+    // Копия: push_back в placeBet может переместить pending_
+    Wager entry = pending_[wager];
+    return placeBet(entry.account, entry.stake, splitWager);
+}
+
+// ==================== РАСЧЕТ ====================
+
+Chips ChipLedger::settle() {
+    Chips houseNet = 0;
+    Chips staked = 0;
+
+    // Один проход без ветвлений по итогам: возврат берется из таблицы
+    for (const Wager& entry : pending_) {
+        Chips returned = wagerReturn(entry.stake, entry.result);
+        balances_[entry.account] += returned;
+        houseNet += entry.stake - returned;
+        staked += entry.stake;
+    }
+
+    house_ += houseNet;
+    inPlay_ -= staked;
+    turnover_ += staked;
+    settled_ += pending_.size();
+    pending_.clear();
+    return houseNet;
+}
+
+void ChipLedger::reset() {
+    balances_.clear();
+    pending_.clear();
+    house_ = 0;
+    inPlay_ = 0;
+    deposits_ = 0;
+    turnover_ = 0;
+    settled_ = 0;
+}
+
+bool ChipLedger::audit() const {
+    Chips total = house_ + inPlay_;
+    for (Chips balance : balances_) {
+        total += balance;
+    }
+    return total == deposits_;
+}
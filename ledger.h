@@ -0,0 +1,180 @@
+#pragma once
+#include "protocol.h"
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Сумма в фишках с фиксированной точкой: CHIP_SCALE единиц на фишку
+ *
+ * Целые сотые доли фишки - суммы складываются точно, а итоги сходятся
+ * до единицы при любом числе раундов
+ */
+using Chips = int64_t;
+
+constexpr Chips CHIP_SCALE = 100;                     ///< Единиц в одной фишке
+constexpr Chips STARTING_BANKROLL = 1000 * CHIP_SCALE; ///< Банкролл нового игрока
+constexpr Chips DEFAULT_BET = 10 * CHIP_SCALE;        ///< Ставка по умолчанию
+
+/**
+ * @brief Итог ставки для расчета выплаты
+ */
+enum class WagerResult : uint8_t {
+    Loss,    ///< Ставка проиграна
+    Push,    ///< Ставка возвращается
+    Win,     ///< Выплата 1:1
+    Natural  ///< Блэкджек с раздачи, выплата 3:2
+};
+
+/**
+ * @brief Итог ставки по исходу руки
+ * @param outcome Исход руки (Game::judgeHand)
+ * @param playerNatural У игрока блэкджек с раздачи
+ * @param dealerNatural У дилера блэкджек с раздачи
+ * @return Natural если блэкджек только у игрока, Loss если только у дилера, иначе итог по исходу
+ */
+WagerResult wagerResult(RoundOutcome outcome, bool playerNatural, bool dealerNatural);
+
+/**
+ * @brief Сумма, возвращаемая игроку вместе со ставкой
+ * @param stake Ставка
+ * @param result Итог ставки
+ * @return 0, stake, 2 * stake или stake + 3/2 stake (остаток от деления в пользу заведения)
+ */
+Chips wagerReturn(Chips stake, WagerResult result);
+
+/**
+ * @brief Сумма в виде "1234.50"
+ */
+std::string formatChips(Chips amount);
+
+/**
+ * @brief Разобрать сумму вида "10", "10.5" или "10.50"
+ * @param text Текст
+ * @param amount [out] Сумма
+ * @return false если текст не число, отрицателен или точнее CHIP_SCALE
+ */
+bool parseChips(const std::string& text, Chips& amount);
+
+constexpr size_t NO_WAGER = static_cast<size_t>(-1); ///< Рука без ставки
+
+/**
+ * @brief Ставка раунда, ожидающая расчета
+ */
+struct Wager {
+    uint32_t account = 0;                   ///< Счет игрока
+    WagerResult result = WagerResult::Push; ///< Итог (до расчета - возврат)
+    Chips stake = 0;                        ///< Ставка с учетом удвоения
+    bool doubled = false;                   ///< Ставка удвоена (Double Down)
+};
+
+/**
+ * @brief Книга фишек: счета игроков, ставки раунда и касса заведения
+ *
+ * Ставка сразу списывается со счета в "игру" (escrow), поэтому поставить
+ * больше баланса нельзя. Удвоение и Split добавляют к ставке или заводят
+ * новую из того же счета. Расчет идет пачкой: settle() одним проходом по
+ * плоскому массиву закрывает все ставки раунда всех мест (или сразу многих
+ * столов), без выделений памяти после разогрева.
+ *
+ * Деньги не создаются и не исчезают: сумма счетов, кассы и ставок в игре
+ * всегда равна сумме внесенного (audit()).
+ */
+class ChipLedger {
+public:
+    /**
+     * @brief Открыть счет
+     * @param deposit Начальный взнос
+     * @return Номер счета
+     */
+    uint32_t openAccount(Chips deposit = 0);
+
+    /**
+     * @brief Внести фишки на счет (докупка)
+     * @param account Номер счета
+     * @param amount Сумма
+     */
+    void deposit(uint32_t account, Chips amount);
+
+    /// @name Ставки раунда
+    /// @{
+
+    /**
+     * @brief Поставить со счета
+     * @param account Номер счета
+     * @param stake Ставка (0 - рука без ставки)
+     * @param wager [out] Номер ставки до следующего settle()
+     * @return false если ставка отрицательна или больше баланса
+     */
+    bool placeBet(uint32_t account, Chips stake, size_t& wager);
+
+    /**
+     * @brief Удвоить ставку (Double Down)
+     * @return false если на счете не хватает фишек
+     */
+    bool doubleBet(size_t wager);
+
+    /**
+     * @brief Завести ставку новой руки после Split - равную исходной
+     * @param wager Ставка разделяемой руки
+     * @param splitWager [out] Ставка новой руки
+     * @return false если на счете не хватает фишек
+     */
+    bool splitBet(size_t wager, size_t& splitWager);
+
+    /**
+     * @brief Записать итог ставки
+     */
+    void setResult(size_t wager, WagerResult result) { pending_[wager].result = result; }
+
+    const Wager& getWager(size_t wager) const { return pending_[wager]; } ///< Ставка по номеру
+    size_t getPendingCount() const { return pending_.size(); }          ///< Ставок до расчета
+    /// @}
+
+    /**
+     * @brief Рассчитать все ставки пачкой
+     * @return Выигрыш заведения на этой пачке (отрицательный - проигрыш)
+     *
+     * Номера ставок после расчета недействительны
+     */
+    Chips settle();
+
+    /**
+     * @brief Закрыть все счета и ставки без расчета (перед восстановлением из снимка)
+     *
+     * Емкость массивов сохраняется: после разогрева без выделений памяти
+     */
+    void reset();
+
+    /**
+     * @brief Сходятся ли итоги: счета + касса + ставки в игре == внесенное
+     */
+    bool audit() const;
+
+    /// @name Геттеры
+    /// @{
+    Chips getBalance(uint32_t account) const { return balances_[account]; }
+    size_t getAccountCount() const { return balances_.size(); }
+    Chips getHouse() const { return house_; }         ///< Выигрыш заведения за все время
+    Chips getInPlay() const { return inPlay_; }       ///< Ставки до расчета
+    Chips getDeposits() const { return deposits_; }   ///< Всего внесено на счета
+    Chips getTurnover() const { return turnover_; }   ///< Всего рассчитано ставок
+    uint64_t getSettledCount() const { return settled_; } ///< Всего рассчитано ставок (штук)
+    /// @}
+
+private:
+    /**
+     * @brief Списать со счета в игру
+     * @return false если не хватает фишек
+     */
+    bool debit(uint32_t account, Chips amount);
+
+    std::vector<Chips> balances_; ///< Балансы счетов
+    std::vector<Wager> pending_;  ///< Ставки до расчета (емкость переиспользуется)
+    Chips house_ = 0;             ///< Касса заведения
+    Chips inPlay_ = 0;            ///< Ставки, списанные со счетов и еще не рассчитанные
+    Chips deposits_ = 0;          ///< Внесено на все счета
+    Chips turnover_ = 0;          ///< Сумма рассчитанных ставок
+    uint64_t settled_ = 0;        ///< Рассчитано ставок
+};
@@ -0,0 +1,292 @@
+#include "network.h"
+#include "loadgen.h"
+#include "options.h"
+#include "strategy.h"
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+using LoadClock = std::chrono::steady_clock;
+
+/**
+ * @brief Состояние одного имитируемого игрока
+ */
+struct SimulatedPlayer {
+    SOCKET socket = INVALID_SOCKET;  ///< Сокет подключения
+    MessageBuffer input;             ///< Буфер приема
+    SendBuffer output;               ///< Буфер отправки
+    int seat = -1;                   ///< Место за столом (известно после первого запроса хода)
+
+    uint32_t tableId = 0;            ///< Стол запрошенного хода
+    uint32_t roundId = 0;            ///< Раунд запрошенного хода
+    PlayerAction action = PlayerAction::Stand; ///< Подготовленное решение
+
+    bool awaitingResponse = false;   ///< Решение отправлено, ждем ответ
+    LoadClock::time_point sentAt;    ///< Время отправки решения
+};
+
+// Синхронизация старта: измерение начинается когда все потоки подключились
+static std::atomic<size_t> readyWorkers(0);
+static std::atomic<bool> startSignal(false);
+
+/**
+ * @brief Конструктор
+ * @param config Параметры
+ */
+LoadGenerator::LoadGenerator(const LoadGeneratorConfig& config)
+    : config_(config) {
+    if (config_.threads == 0) {
+        config_.threads = std::thread::hardware_concurrency();
+    }
+    if (config_.threads == 0) config_.threads = 1;
+    if (config_.threads > config_.connections) config_.threads = config_.connections;
+}
+
+bool LoadGenerator::run() {
+    results_.assign(config_.threads, LoadWorkerResult());
+    readyWorkers = 0;
+    startSignal = false;
+
+    std::cout << "Connecting " << config_.connections << " players to "
+        << config_.host << ":" << config_.port << "...\n";
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < config_.threads; ++i) {
+        // Распределяем подключения по потокам как можно равномернее
+        size_t count = config_.connections / config_.threads +
+            (i < config_.connections % config_.threads ? 1 : 0);
+        workers.emplace_back(&LoadGenerator::workerLoop, this, i, count);
+    }
+
+    while (readyWorkers < config_.threads) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::cout << "Running for " << config_.durationSeconds << " s...\n";
+    auto startTime = LoadClock::now();
+    startSignal = true;
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    measuredSeconds_ = std::chrono::duration<double>(LoadClock::now() - startTime).count();
+
+    size_t connected = 0;
+    for (const auto& result : results_) {
+        connected += result.connected;
+    }
+    return connected > 0;
+}
+
+// ==================== РАБОЧИЙ ПОТОК ====================
+
+void LoadGenerator::workerLoop(size_t workerIndex, size_t connectionCount) {
+    LoadWorkerResult& result = results_[workerIndex];
+    std::vector<std::unique_ptr<SimulatedPlayer>> players;
+    std::vector<WSAPOLLFD> pollFds;
+
+    for (size_t i = 0; i < connectionCount; ++i) {
+        SOCKET socket = connectTo(config_.host, config_.port);
+        if (socket == INVALID_SOCKET) {
+            continue;
+        }
+        players.emplace_back(new SimulatedPlayer());
+        players.back()->socket = socket;
+
+        WSAPOLLFD fd;
+        fd.fd = socket;
+        fd.events = POLLRDNORM;
+        fd.revents = 0;
+        pollFds.push_back(fd);
+    }
+    result.connected = players.size();
+
+    readyWorkers++;
+    while (!startSignal) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // Темп решений: каждый поток отвечает за свою долю общего темпа
+    LoadClock::duration interval = LoadClock::duration::zero();
+    if (config_.decisionRate > 0.0) {
+        interval = std::chrono::duration_cast<LoadClock::duration>(
+            std::chrono::duration<double>(config_.threads / config_.decisionRate));
+    }
+
+    auto now = LoadClock::now();
+    auto deadline = now + std::chrono::seconds(config_.durationSeconds);
+    auto nextSend = now;
+    std::deque<size_t> sendQueue;
+    uint8_t buffer[PROTOCOL_MAX_MESSAGE_SIZE];
+
+    while (now < deadline && !players.empty()) {
+        // Отправляем решения, время которых наступило
+        while (!sendQueue.empty() && (interval == LoadClock::duration::zero() || nextSend <= now)) {
+            size_t index = sendQueue.front();
+            sendQueue.pop_front();
+
+            SimulatedPlayer& player = *players[index];
+            if (player.socket == INVALID_SOCKET) continue;
+
+            size_t length = encodeDecision(buffer, sizeof(buffer), player.tableId, player.roundId,
+                static_cast<uint8_t>(player.seat), player.action);
+            player.sentAt = LoadClock::now();
+            player.awaitingResponse = true;
+            if (!player.output.send(player.socket, buffer, length)) {
+                closesocket(player.socket);
+                player.socket = INVALID_SOCKET;
+                pollFds[index].fd = INVALID_SOCKET;
+                continue;
+            }
+            if (player.output.hasPending()) {
+                pollFds[index].events = POLLRDNORM | POLLWRNORM;
+            }
+            nextSend += interval;
+        }
+
+        // После долгой паузы не пытаемся "догнать" темп пачкой решений
+        if (interval != LoadClock::duration::zero() && nextSend + std::chrono::seconds(1) < now) {
+            nextSend = now;
+        }
+
+        int timeout = 10;
+        if (!sendQueue.empty()) {
+            auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(nextSend - now).count();
+            timeout = (interval == LoadClock::duration::zero() || wait < 0) ? 0 : static_cast<int>(wait);
+        }
+
+        int ready = WSAPoll(pollFds.data(), static_cast<ULONG>(pollFds.size()), timeout);
+        if (ready == SOCKET_ERROR) {
+            break;
+        }
+
+        for (size_t i = 0; ready > 0 && i < pollFds.size(); ++i) {
+            short events = pollFds[i].revents;
+            if (events == 0) continue;
+
+            SimulatedPlayer& player = *players[i];
+            bool alive = (events & (POLLERR | POLLHUP | POLLNVAL)) == 0;
+
+            if (alive && (events & POLLWRNORM)) {
+                alive = player.output.flush(player.socket);
+                if (!player.output.hasPending()) {
+                    pollFds[i].events = POLLRDNORM;
+                }
+            }
+            if (alive && (events & POLLRDNORM)) {
+                alive = player.input.receive(player.socket);
+
+                const uint8_t* message = nullptr;
+                MessageHeader header;
+                while (player.input.nextMessage(message, header)) {
+                    auto received = LoadClock::now();
+                    if (player.awaitingResponse) {
+                        player.awaitingResponse = false;
+                        result.latency.record(static_cast<uint64_t>(
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(received - player.sentAt).count()));
+                        result.decisions++;
+                    }
+
+                    if (header.type == MessageType::ActionRequest) {
+                        ActionRequestView request;
+                        if (!request.parse(message, header.length)) continue;
+
+                        uint8_t codes[32];
+                        size_t count = request.cardCount() < 32 ? request.cardCount() : 32;
+                        for (size_t c = 0; c < count; ++c) {
+                            codes[c] = request.cardCode(c);
+                        }
+
+                        Card upcard(Suit::Hearts, Rank::Two);
+                        decodeCard(request.dealerUpcardCode(), upcard);
+
+                        player.seat = request.seat();
+                        player.tableId = request.tableId();
+                        player.roundId = request.roundId();
+                        player.action = basicStrategyAction(summarizeHandCodes(codes, count),
+                            upcardValue(upcard), request.legalActions());
+                        sendQueue.push_back(i);
+                    }
+                    else if (header.type == MessageType::RoundResult && player.seat == 0) {
+                        result.rounds++;
+                    }
+                }
+                alive = alive && !player.input.isCorrupted();
+            }
+
+            if (!alive) {
+                closesocket(player.socket);
+                player.socket = INVALID_SOCKET;
+                pollFds[i].fd = INVALID_SOCKET;
+            }
+        }
+
+        now = LoadClock::now();
+    }
+
+    for (auto& player : players) {
+        if (player->socket != INVALID_SOCKET) {
+            closesocket(player->socket);
+        }
+    }
+}
+
+// ==================== ОТЧЕТ ====================
+
+void LoadGenerator::printReport() const {
+    size_t connected = 0;
+    uint64_t rounds = 0;
+    uint64_t decisions = 0;
+    LatencyHistogram latency;
+
+    for (const auto& result : results_) {
+        connected += result.connected;
+        rounds += result.rounds;
+        decisions += result.decisions;
+        latency.merge(result.latency);
+    }
+
+    double seconds = measuredSeconds_ > 0.0 ? measuredSeconds_ : 1.0;
+    std::cout << "\n=== LOAD GENERATOR REPORT ===\n";
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Connections: " << connected << "/" << config_.connections
+        << " | Threads: " << config_.threads << "\n";
+    std::cout << "Duration: " << seconds << " s\n";
+    std::cout << "Rounds: " << rounds << " (" << rounds / seconds << " rounds/sec)\n";
+    std::cout << "Decisions: " << decisions << " (" << decisions / seconds << " decisions/sec)\n";
+    latency.print(std::cout, "Decision-to-response latency", 1000.0, "us");
+}
+
+// ==================== ТОЧКА ВХОДА ====================
+
+int runLoadGenerator(int argc, char* argv[]) {
+    CommandLine options(argc, argv);
+
+    LoadGeneratorConfig config;
+    config.host = options.getString("host", config.host);
+    config.port = static_cast<uint16_t>(options.getInt("port", DEFAULT_SERVER_PORT));
+    config.connections = static_cast<size_t>(options.getInt("connections", 1000));
+    config.decisionRate = options.getDouble("rate", 0.0);
+    config.durationSeconds = static_cast<int>(options.getInt("duration", 10));
+    config.threads = static_cast<size_t>(options.getInt("threads", 0));
+
+    if (config.connections == 0) {
+        std::cerr << "Number of connections must be positive.\n";
+        return 1;
+    }
+    if (!initNetwork()) {
+        std::cerr << "Failed to initialize Winsock.\n";
+        return 1;
+    }
+
+    LoadGenerator generator(config);
+    bool ok = generator.run();
+    generator.printReport();
+
+    shutdownNetwork();
+    return ok ? 0 : 1;
+}
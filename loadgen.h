@@ -0,0 +1,75 @@
+#pragma once
+#include "network.h"
+#include "histogram.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Параметры нагрузочного клиента
+ */
+struct LoadGeneratorConfig {
+    std::string host = "127.0.0.1";      ///< Адрес сервера
+    uint16_t port = DEFAULT_SERVER_PORT; ///< Порт сервера
+    size_t connections = 1000;           ///< Число имитируемых игроков
+    double decisionRate = 0.0;           ///< Решений в секунду суммарно (0 - без ограничения)
+    int durationSeconds = 10;            ///< Длительность измерения
+    size_t threads = 0;                  ///< Рабочих потоков (0 - по числу ядер)
+};
+
+/**
+ * @brief Итоги одного рабочего потока нагрузочного клиента
+ */
+struct LoadWorkerResult {
+    size_t connected = 0;        ///< Успешных подключений
+    uint64_t rounds = 0;         ///< Завершенных раундов (считаются местом 0)
+    uint64_t decisions = 0;      ///< Отправленных решений с полученным ответом
+    LatencyHistogram latency;    ///< Задержка решение -> ответ, нс
+};
+
+/**
+ * @brief Нагрузочный клиент сервера столов
+ *
+ * Открывает множество подключений, играет базовой стратегией через
+ * сообщения Decision с заданным темпом и измеряет пропускную способность
+ * сервера и задержку от отправки решения до ответа сервера.
+ */
+class LoadGenerator {
+public:
+    /**
+     * @brief Конструктор
+     * @param config Параметры
+     */
+    explicit LoadGenerator(const LoadGeneratorConfig& config);
+
+    /**
+     * @brief Выполнить нагрузочный прогон
+     * @return false если не удалось подключиться ни разу
+     */
+    bool run();
+
+    /**
+     * @brief Вывести отчет
+     */
+    void printReport() const;
+
+private:
+    /**
+     * @brief Рабочий поток: свой поднабор подключений и свой темп
+     * @param workerIndex Номер потока
+     * @param connectionCount Число подключений потока
+     */
+    void workerLoop(size_t workerIndex, size_t connectionCount);
+
+    LoadGeneratorConfig config_;              ///< Параметры
+    std::vector<LoadWorkerResult> results_;   ///< Итоги потоков
+    double measuredSeconds_ = 0.0;            ///< Фактическая длительность измерения
+};
+
+/**
+ * @brief Точка входа режима нагрузочного клиента (--loadgen)
+ * @param argc Число аргументов
+ * @param argv Аргументы: --host, --port, --connections, --rate, --duration, --threads
+ * @return Код завершения
+ */
+int runLoadGenerator(int argc, char* argv[]);
@@ -1,50 +1,116 @@
-﻿#include <iostream>
-#include "game.h"
-
-/**
- * @brief Точка входа в приложение Blackjack
- *
- * Создает и запускает игровой экземпляр, управляет жизненным циклом приложения
- *
- * @return Код завершения программы (0 - успешное завершение)
- */
-int main() {
-    // Настройка локализации для корректного отображения символов
-    setlocale(LC_ALL, "Russian");
-
-    std::cout << "=== BLACKJACK GAME ===\n";
-    std::cout << "Initializing game...\n\n";
-
-    try {
-        // Создание и запуск игрового экземпляра
-        Game blackjackGame;
-        blackjackGame.startGame();
-
-        std::cout << "\nGame session completed successfully.\n";
-    }
-    catch (const std::exception& e) {
-        // Обработка критических ошибок
-        std::cerr << "\n*** CRITICAL ERROR ***\n";
-        std::cerr << "Game terminated unexpectedly: " << e.what() << "\n";
-        std::cerr << "Please restart the application.\n";
-
-        std::cout << "\nPress Enter to exit...";
-        std::cin.get();
-        return 1; // Возврат кода ошибки
-    }
-    catch (...) {
-        // Обработка непредвиденных ошибок
-        std::cerr << "\n*** UNKNOWN ERROR ***\n";
-        std::cerr << "Game terminated due to unexpected error.\n";
-        std::cerr << "Please restart the application.\n";
-
-        std::cout << "\nPress Enter to exit...";
-        std::cin.get();
-        return 1; // Возврат кода ошибки
-    }
-
-    // Корректное завершение программы
-    std::cout << "\nPress Enter to exit...";
-    std::cin.get();
-    return 0;
+﻿#include <iostream>
+#include <cstring>
+#include "server.h"
+#include "loadgen.h"
+#include "benchmark.h"
+#include "scriptinput.h"
+#include "fuzz.h"
+#include "simulator.h"
+#include "deviation.h"
+#include "spread.h"
+#include "compare.h"
+#include "sweep.h"
+#include "solver.h"
+#include "corpus.h"
+#include "game.h"
+
+/**
+ * @brief Точка входа в приложение Blackjack
+ *
+ * Создает и запускает игровой экземпляр, управляет жизненным циклом приложения.
+ * Первый аргумент может выбрать служебный режим:
+ * - --server  - сервер столов по бинарному протоколу
+ * - --loadgen - нагрузочный клиент для сервера столов
+ * - --bench   - микробенчмарки горячих путей
+ * - --script  - интерактивная игра по сценарию ввода с замером задержек
+ * - --fuzz    - дифференциальная проверка быстрых путей против эталонных правил
+ * - --bankroll - симуляция траекторий банкролла и риска разорения
+ * - --deviations - поиск индексов отклонений от базовой стратегии по счету
+ * - --spread  - подбор шкалы ставок под ограничение риска разорения
+ * - --compare - сравнение двух стратегий с уменьшением дисперсии
+ * - --sweep   - преимущество казино для сетки правил на общих шузах
+ * - --solve   - лучшая игра с полной информацией о порядке карт шуза
+ * - --corpus  - файл заранее перемешанных шузов для всех процессов
+ *
+ * @param argc Число аргументов командной строки
+ * @param argv Аргументы командной строки
+ * @return Код завершения программы (0 - успешное завершение)
+ */
+int main(int argc, char* argv[]) {
+    // Настройка локализации для корректного отображения символов
+    setlocale(LC_ALL, "Russian");
+
+    // Служебные режимы работают без интерактивного стола
+    if (argc > 1 && std::strcmp(argv[1], "--server") == 0) {
+        return runTableServer(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--loadgen") == 0) {
+        return runLoadGenerator(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) {
+        return runBenchmarks(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--script") == 0) {
+        return runScriptedGame(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--fuzz") == 0) {
+        return runFuzzer(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--bankroll") == 0) {
+        return runBankrollSimulator(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--deviations") == 0) {
+        return runDeviationGenerator(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--spread") == 0) {
+        return runSpreadOptimizer(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--compare") == 0) {
+        return runStrategyComparison(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--sweep") == 0) {
+        return runRuleSweep(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--solve") == 0) {
+        return runShoeSolver(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--corpus") == 0) {
+        return runShoeCorpus(argc - 1, argv + 1);
+    }
+
+    std::cout << "=== BLACKJACK GAME ===\n";
+    std::cout << "Initializing game...\n\n";
+
+    try {
+        // Создание и запуск игрового экземпляра
+        Game blackjackGame;
+        blackjackGame.startGame();
+
+        std::cout << "\nGame session completed successfully.\n";
+    }
+    catch (const std::exception& e) {
+        // Обработка критических ошибок
+        std::cerr << "\n*** CRITICAL ERROR ***\n";
+        std::cerr << "Game terminated unexpectedly: " << e.what() << "\n";
+        std::cerr << "Please restart the application.\n";
+
+        std::cout << "\nPress Enter to exit...";
+        std::cin.get();
+        return 1; // Возврат кода ошибки
+    }
+    catch (...) {
+        // Обработка непредвиденных ошибок
+        std::cerr << "\n*** UNKNOWN ERROR ***\n";
+        std::cerr << "Game terminated due to unexpected error.\n";
+        std::cerr << "Please restart the application.\n";
+
+        std::cout << "\nPress Enter to exit...";
+        std::cin.get();
+        return 1; // Возврат кода ошибки
+    }
+
+    // Корректное завершение программы
+    std::cout << "\nPress Enter to exit...";
+    std::cin.get();
+    return 0;
 }
\ No newline at end of file
@@ -0,0 +1,111 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief Ограниченная lock-free очередь "много писателей - один читатель"
+ *
+ * Кольцевой буфер с порядковым номером в каждой ячейке (схема Д. Вьюкова).
+ * Писатели резервируют ячейку атомарным CAS и заполняют ее на месте,
+ * поэтому сообщение можно закодировать прямо в очередь без копирования.
+ * Мьютексов и выделений памяти после создания нет.
+ *
+ * @tparam T Тип элемента (должен иметь конструктор по умолчанию)
+ */
+template <typename T>
+class MpscQueue {
+public:
+    /**
+     * @brief Конструктор очереди
+     * @param capacity Емкость (округляется вверх до степени двойки)
+     */
+    explicit MpscQueue(size_t capacity) {
+        capacity_ = 1;
+        while (capacity_ < capacity) {
+            capacity_ <<= 1;
+        }
+        mask_ = capacity_ - 1;
+
+        cells_.reset(new Cell[capacity_]);
+        for (size_t i = 0; i < capacity_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /**
+     * @brief Заполнить ячейку на месте и опубликовать ее (любой поток)
+     * @param fill Функция fill(T&), заполняющая элемент
+     * @return false если очередь заполнена
+     */
+    template <typename Fill>
+    bool tryPush(Fill&& fill) {
+        size_t position = enqueuePosition_.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells_[position & mask_];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+            if (difference == 0) {
+                if (enqueuePosition_.compare_exchange_weak(position, position + 1,
+                    std::memory_order_relaxed)) {
+                    fill(cell.data);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0) {
+                return false; // Очередь заполнена
+            }
+            else {
+                position = enqueuePosition_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Обработать следующий элемент на месте (только поток-читатель)
+     * @param consume Функция consume(T&)
+     * @return false если очередь пуста
+     */
+    template <typename Consume>
+    bool tryPop(Consume&& consume) {
+        Cell& cell = cells_[dequeuePosition_ & mask_];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (sequence != dequeuePosition_ + 1) {
+            return false;
+        }
+
+        consume(cell.data);
+        cell.sequence.store(dequeuePosition_ + capacity_, std::memory_order_release);
+        ++dequeuePosition_;
+        return true;
+    }
+
+    /**
+     * @brief Пуста ли очередь (точно только для потока-читателя)
+     */
+    bool empty() const {
+        const Cell& cell = cells_[dequeuePosition_ & mask_];
+        return cell.sequence.load(std::memory_order_acquire) != dequeuePosition_ + 1;
+    }
+
+private:
+    /**
+     * @brief Ячейка очереди
+     */
+    struct Cell {
+        std::atomic<size_t> sequence; ///< Порядковый номер (состояние ячейки)
+        T data;                       ///< Элемент
+    };
+
+    std::unique_ptr<Cell[]> cells_;                    ///< Ячейки
+    size_t capacity_ = 0;                              ///< Емкость
+    size_t mask_ = 0;                                  ///< Маска индекса
+    alignas(64) std::atomic<size_t> enqueuePosition_{0}; ///< Позиция записи (общая для писателей)
+    alignas(64) size_t dequeuePosition_ = 0;           ///< Позиция чтения (только читатель)
+};
@@ -0,0 +1,163 @@
+#include "network.h"
+#include <cstring>
+
+// ==================== ИНИЦИАЛИЗАЦИЯ И СОКЕТЫ ====================
+
+bool initNetwork() {
+    WSADATA data;
+    return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+}
+
+void shutdownNetwork() {
+    WSACleanup();
+}
+
+bool configureSocket(SOCKET socket) {
+    u_long nonBlocking = 1;
+    if (ioctlsocket(socket, FIONBIO, &nonBlocking) != 0) {
+        return false;
+    }
+
+    // Сообщения маленькие - отправляем сразу, без склейки
+    int noDelay = 1;
+    setsockopt(socket, IPPROTO_TCP, TCP_NODELAY,
+        reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+    return true;
+}
+
+SOCKET listenOn(uint16_t port) {
+    SOCKET listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (listener == INVALID_SOCKET) {
+        return INVALID_SOCKET;
+    }
+
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR,
+        reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listener, SOMAXCONN) != 0 ||
+        !configureSocket(listener)) {
+        closesocket(listener);
+        return INVALID_SOCKET;
+    }
+    return listener;
+}
+
+SOCKET connectTo(const std::string& host, uint16_t port) {
+    SOCKET connection = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (connection == INVALID_SOCKET) {
+        return INVALID_SOCKET;
+    }
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+
+    if (inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1 ||
+        connect(connection, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        !configureSocket(connection)) {
+        closesocket(connection);
+        return INVALID_SOCKET;
+    }
+    return connection;
+}
+
+bool wouldBlock() {
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+}
+
+// ==================== БУФЕРЫ СООБЩЕНИЙ ====================
+
+bool MessageBuffer::receive(SOCKET socket) {
+    // Сдвигаем необработанный остаток в начало буфера
+    if (begin_ > 0) {
+        std::memmove(data_, data_ + begin_, end_ - begin_);
+        end_ -= begin_;
+        begin_ = 0;
+    }
+
+    while (end_ < CAPACITY) {
+        int received = recv(socket, reinterpret_cast<char*>(data_ + end_),
+            static_cast<int>(CAPACITY - end_), 0);
+        if (received > 0) {
+            end_ += static_cast<size_t>(received);
+            continue;
+        }
+        if (received == 0) {
+            return false; // Соединение закрыто
+        }
+        return wouldBlock();
+    }
+    return true;
+}
+
+bool MessageBuffer::nextMessage(const uint8_t*& message, MessageHeader& header) {
+    size_t available = end_ - begin_;
+    if (available < PROTOCOL_HEADER_SIZE) {
+        return false;
+    }
+
+    const uint8_t* start = data_ + begin_;
+    if (!decodeHeader(start, available, header)) {
+        // Заголовок корректен, но сообщение пришло не целиком - ждем остаток
+        uint16_t length = static_cast<uint16_t>(start[4] | (start[5] << 8));
+        if (start[0] == PROTOCOL_MAGIC && start[1] == PROTOCOL_VERSION &&
+            length >= PROTOCOL_HEADER_SIZE && length <= PROTOCOL_MAX_MESSAGE_SIZE && length > available) {
+            return false;
+        }
+        corrupted_ = true;
+        return false;
+    }
+
+    message = start;
+    begin_ += header.length;
+    return true;
+}
+
+bool SendBuffer::send(SOCKET socket, const uint8_t* message, size_t length) {
+    size_t offset = 0;
+
+    // Если очередь пуста - пробуем отправить напрямую
+    if (size_ == 0) {
+        int sent = ::send(socket, reinterpret_cast<const char*>(message), static_cast<int>(length), 0);
+        if (sent < 0) {
+            if (!wouldBlock()) return false;
+            sent = 0;
+        }
+        offset = static_cast<size_t>(sent);
+    }
+
+    size_t rest = length - offset;
+    if (rest == 0) {
+        return true;
+    }
+    if (size_ + rest > CAPACITY) {
+        return false; // Клиент не успевает читать
+    }
+    std::memcpy(data_ + size_, message + offset, rest);
+    size_ += rest;
+    return true;
+}
+
+bool SendBuffer::flush(SOCKET socket) {
+    if (size_ == 0) {
+        return true;
+    }
+
+    int sent = ::send(socket, reinterpret_cast<const char*>(data_), static_cast<int>(size_), 0);
+    if (sent < 0) {
+        return wouldBlock();
+    }
+
+    std::memmove(data_, data_ + sent, size_ - static_cast<size_t>(sent));
+    size_ -= static_cast<size_t>(sent);
+    return true;
+}
@@ -0,0 +1,141 @@
+#pragma once
+// Winsock2 должен подключаться раньше windows.h (его включает player.h),
+// поэтому этот заголовок подключается первым в .cpp файлах сетевых модулей.
+// NOMINMAX: макросы min/max из windows.h ломают std::min/std::max
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include "protocol.h"
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+#pragma comment(lib, "Ws2_32.lib")
+
+constexpr uint16_t DEFAULT_SERVER_PORT = 27021; ///< Порт сервера столов по умолчанию
+
+// ==================== ИНИЦИАЛИЗАЦИЯ И СОКЕТЫ ====================
+
+/**
+ * @brief Инициализация Winsock
+ * @return true при успехе
+ */
+bool initNetwork();
+
+/**
+ * @brief Освобождение ресурсов Winsock
+ */
+void shutdownNetwork();
+
+/**
+ * @brief Перевести сокет в неблокирующий режим и отключить алгоритм Нейгла
+ * @param socket Сокет
+ * @return true при успехе
+ */
+bool configureSocket(SOCKET socket);
+
+/**
+ * @brief Создать слушающий сокет на localhost
+ * @param port Порт
+ * @return Сокет или INVALID_SOCKET
+ */
+SOCKET listenOn(uint16_t port);
+
+/**
+ * @brief Подключиться к серверу (блокирующее подключение)
+ * @param host IPv4-адрес сервера
+ * @param port Порт
+ * @return Сокет или INVALID_SOCKET
+ */
+SOCKET connectTo(const std::string& host, uint16_t port);
+
+/**
+ * @brief Проверка что операция неблокирующего сокета просто "не готова"
+ */
+bool wouldBlock();
+
+// ==================== БУФЕРЫ СООБЩЕНИЙ ====================
+
+/**
+ * @brief Буфер приема с разбиением потока на сообщения протокола
+ *
+ * Фиксированный размер, без выделения памяти: сообщения отдаются
+ * указателями прямо в буфер и действительны до следующего receive()
+ */
+class MessageBuffer {
+public:
+    static constexpr size_t CAPACITY = PROTOCOL_MAX_MESSAGE_SIZE * 8; ///< Размер буфера
+
+    /**
+     * @brief Прочитать доступные данные из сокета
+     * @param socket Сокет
+     * @return false если соединение закрыто или произошла ошибка
+     */
+    bool receive(SOCKET socket);
+
+    /**
+     * @brief Извлечь следующее целое сообщение
+     * @param message [out] Указатель на начало сообщения
+     * @param header [out] Заголовок сообщения
+     * @return false если целого сообщения нет
+     *
+     * Поврежденный поток помечается ошибкой (см. isCorrupted)
+     */
+    bool nextMessage(const uint8_t*& message, MessageHeader& header);
+
+    /**
+     * @brief Поток содержит некорректный заголовок
+     */
+    bool isCorrupted() const { return corrupted_; }
+
+private:
+    uint8_t data_[CAPACITY];  ///< Принятые байты
+    size_t begin_ = 0;        ///< Начало необработанных данных
+    size_t end_ = 0;          ///< Конец принятых данных
+    bool corrupted_ = false;  ///< Признак поврежденного потока
+};
+
+/**
+ * @brief Буфер отправки для неблокирующего сокета
+ *
+ * Сообщение сначала пытаемся отправить сразу; остаток, который сокет
+ * не принял, хранится до следующего flush()
+ */
+class SendBuffer {
+public:
+    static constexpr size_t CAPACITY = PROTOCOL_MAX_MESSAGE_SIZE * 32; ///< Размер буфера
+
+    /**
+     * @brief Отправить сообщение или поставить его в очередь
+     * @param socket Сокет
+     * @param message Сообщение
+     * @param length Длина
+     * @return false если буфер переполнен или произошла ошибка сокета
+     */
+    bool send(SOCKET socket, const uint8_t* message, size_t length);
+
+    /**
+     * @brief Дослать накопленные данные
+     * @return false при ошибке сокета
+     */
+    bool flush(SOCKET socket);
+
+    /**
+     * @brief Есть ли неотправленные данные
+     */
+    bool hasPending() const { return size_ > 0; }
+
+    /**
+     * @brief Число неотправленных байт
+     */
+    size_t getPending() const { return size_; }
+
+private:
+    uint8_t data_[CAPACITY]; ///< Неотправленные байты
+    size_t size_ = 0;        ///< Число неотправленных байт
+};
@@ -0,0 +1,53 @@
+#include "options.h"
+#include <cstdlib>
+
+CommandLine::CommandLine(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        args_.emplace_back(argv[i]);
+    }
+}
+
+bool CommandLine::has(const std::string& name) const {
+    for (const auto& arg : args_) {
+        if (arg == "--" + name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::string* CommandLine::find(const std::string& name) const {
+    for (size_t i = 0; i + 1 < args_.size(); ++i) {
+        if (args_[i] == "--" + name) {
+            return &args_[i + 1];
+        }
+    }
+    return nullptr;
+}
+
+std::string CommandLine::getString(const std::string& name, const std::string& fallback) const {
+    const std::string* value = find(name);
+    return value ? *value : fallback;
+}
+
+long long CommandLine::getInt(const std::string& name, long long fallback) const {
+    const std::string* value = find(name);
+    if (!value) {
+        return fallback;
+    }
+
+    char* end = nullptr;
+    long long result = std::strtoll(value->c_str(), &end, 10);
+    return (end && *end == '\0' && !value->empty()) ? result : fallback;
+}
+
+double CommandLine::getDouble(const std::string& name, double fallback) const {
+    const std::string* value = find(name);
+    if (!value) {
+        return fallback;
+    }
+
+    char* end = nullptr;
+    double result = std::strtod(value->c_str(), &end);
+    return (end && *end == '\0' && !value->empty()) ? result : fallback;
+}
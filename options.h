@@ -0,0 +1,55 @@
+#pragma once
+#include <string>
+#include <vector>
+
+/**
+ * @brief Разбор параметров командной строки вида "--name value"
+ *
+ * Используется служебными режимами (сервер, нагрузочный клиент и т.д.),
+ * которые запускаются из main() по первому аргументу
+ */
+class CommandLine {
+public:
+    /**
+     * @brief Конструктор
+     * @param argc Число аргументов
+     * @param argv Аргументы
+     */
+    CommandLine(int argc, char* argv[]);
+
+    /**
+     * @brief Есть ли параметр (флаг)
+     * @param name Имя без "--"
+     */
+    bool has(const std::string& name) const;
+
+    /**
+     * @brief Строковое значение параметра
+     * @param name Имя без "--"
+     * @param fallback Значение по умолчанию
+     */
+    std::string getString(const std::string& name, const std::string& fallback) const;
+
+    /**
+     * @brief Целое значение параметра
+     * @param name Имя без "--"
+     * @param fallback Значение по умолчанию (и при ошибке разбора)
+     */
+    long long getInt(const std::string& name, long long fallback) const;
+
+    /**
+     * @brief Вещественное значение параметра
+     * @param name Имя без "--"
+     * @param fallback Значение по умолчанию (и при ошибке разбора)
+     */
+    double getDouble(const std::string& name, double fallback) const;
+
+private:
+    /**
+     * @brief Найти значение параметра
+     * @return Указатель на значение или nullptr
+     */
+    const std::string* find(const std::string& name) const;
+
+    std::vector<std::string> args_; ///< Аргументы без имени программы
+};
@@ -1,226 +1,414 @@
-#pragma once
-#include "card.h"
-#include "deck.h"
-#include <vector>
-#include <string>
-#include <windows.h>
-
-/**
- * @brief Действия доступные игроку в Blackjack
- */
-enum class PlayerAction {
-    Hit,        ///< Взять карту
-    Stand,      ///< Остановиться
-    DoubleDown, ///< Удвоить ставку
-    Split       ///< Разделить карты
-};
-
-/**
- * @brief Класс представляющий игрока в Blackjack
- *
- * Управляет состоянием игрока, его картами, статистикой
- * и доступными действиями в зависимости от ситуации
- */
-class Player {
-public:
-    /**
-     * @brief Конструктор игрока
-     * @param playerName Имя игрока
-     */
-    Player(const std::string& playerName);
-
-    // ==================== ОСНОВНЫЕ ИГРОВЫЕ МЕТОДЫ ====================
-
-    /**
-     * @brief Взять карту из колоды
-     * @param deck Колода из которой берется карта
-     */
-    void takeCard(Deck& deck);
-
-    /**
-     * @brief Рассчитать текущий счет руки
-     * @return Счет руки с учетом тузов
-     */
-    int calculateScore() const;
-
-    /**
-     * @brief Показать карты игрока в ASCII-формате
-     */
-    void showHand() const;
-
-    /**
-     * @brief Получить имя игрока
-     * @return Имя игрока
-     */
-    std::string getName() const;
-
-    /**
-     * @brief Получить действие игрока (интерактивный ввод)
-     * @return Выбранное действие
-     */
-    PlayerAction getPlayerAction() const;
-
-    /**
-     * @brief Проверить перебор (счет > 21)
-     * @return true если перебор, иначе false
-     */
-    bool isBusted() const;
-
-    /**
-     * @brief Проверить возможность разделения карт
-     * @return true если можно разделить, иначе false
-     */
-    bool canSplit() const;
-
-    /**
-     * @brief Проверить возможность удвоения ставки
-     * @return true если можно удвоить, иначе false
-     */
-    bool canDoubleDown() const;
-
-    /**
-     * @brief Получить текстовое представление руки
-     * @return Строка с картами руки
-     */
-    std::string getHandAsString() const;
-
-    /**
-     * @brief Получить текстовое представление статистики
-     * @return Строка со статистикой игрока
-     */
-    std::string getStatsAsString() const;
-
-    // ==================== МЕТОДЫ ДЛЯ СЕТЕВОЙ ИГРЫ ====================
-
-    /**
-     * @brief Получить список доступных действий
-     * @return Вектор доступных действий
-     */
-    std::vector<PlayerAction> getAvailableActions() const;
-
-    /**
-     * @brief Получить текстовое представление доступных действий
-     * @return Строка с описанием доступных действий
-     */
-    std::string getActionsAsString() const;
-
-    /**
-     * @brief Конвертировать сетевой выбор в действие
-     * @param networkChoice Числовой выбор из сети
-     * @return Соответствующее действие
-     */
-    PlayerAction convertNetworkChoice(int networkChoice) const;
-
-    // ==================== ВСПОМОГАТЕЛЬНЫЕ МЕТОДЫ ====================
-
-    /**
-     * @brief Показать доступные действия (интерактивный вывод)
-     */
-    void showAvailableActions() const;
-
-    /**
-     * @brief Получить выбор игрока (интерактивный ввод)
-     * @return Числовой выбор игрока
-     */
-    int getPlayerChoice() const;
-
-    /**
-     * @brief Конвертировать выбор в действие
-     * @param choice Числовой выбор
-     * @return Соответствующее действие
-     */
-    PlayerAction convertChoiceToAction(int choice) const;
-
-    // ==================== МЕТОДЫ ДЛЯ РАБОТЫ С РУКОЙ ====================
-
-    /**
-     * @brief Получить константную ссылку на руку
-     * @return Константная ссылка на вектор карт
-     */
-    const std::vector<Card>& getHand() const;
-
-    /**
-     * @brief Очистить руку (для нового раунда)
-     */
-    void clearHand();
-
-    /**
-     * @brief Установить новую руку (для Split)
-     * @param newHand Новая рука
-     */
-    void setHand(const std::vector<Card>& newHand);
-
-    /**
-     * @brief Разделить руку на две
-     * @param deck Колода для взятия дополнительных карт
-     * @return Вторая рука после разделения
-     */
-    std::vector<Card> splitHand(Deck& deck);
-
-    // ==================== СТАТИСТИКА И РЕЗУЛЬТАТЫ ====================
-
-    /// @name Геттеры статистики
-    /// @{
-    int getGamesPlayed() const { return gamesPlayed_; }
-    int getGamesWon() const { return gamesWon_; }
-    int getGamesLost() const { return gamesLost_; }
-    int getGamesPushed() const { return gamesPushed_; }
-    int getMaxScore() const { return maxScore_; }
-    double getWinRate() const { return winRate_; }
-    /// @}
-
-    /// @name Методы обновления статистики
-    /// @{
-    void recordWin();                          ///< Записать победу
-    void recordLoss();                         ///< Записать поражение
-    void recordPush();                         ///< Записать ничью
-    void updateMaxScore(int score);            ///< Обновить максимум очков
-    void showStats() const;                    ///< Показать статистику
-    /// @}
-
-    /// @name Сеттеры статистики (для загрузки)
-    /// @{
-    void setGamesPlayed(int value) { gamesPlayed_ = value; updateWinRate(); }
-    void setGamesWon(int value) { gamesWon_ = value; updateWinRate(); }
-    void setGamesLost(int value) { gamesLost_ = value; updateWinRate(); }
-    void setGamesPushed(int value) { gamesPushed_ = value; updateWinRate(); }
-    void setGamesScore(int value) { maxScore_ = value; }
-    /// @}
-
-    // ==================== ЦВЕТОВЫЕ МЕТОДЫ ====================
-
-    /**
-     * @brief Установка цвета текста в консоли
-     * @param color Код цвета Windows
-     */
-    static void setColor(int color) {
-        HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-        SetConsoleTextAttribute(hConsole, color);
-    }
-
-    static void resetColor() { setColor(7); }      ///< Сброс к стандартному цвету
-    static void setPlayerColor() { setColor(11); } ///< Голубой для игрока
-    static void setCardColor() { setColor(14); }   ///< Желтый для карт
-    static void setScoreColor() { setColor(10); }  ///< Зеленый для счета
-    static void setActionColor() { setColor(15); } ///< Ярко-белый для действий
-
-private:
-    std::string name_;                           ///< Имя игрока
-    std::vector<Card> hand_;                     ///< Карты в руке
-
-    // Статистика игрока
-    int gamesPlayed_ = 0;                        ///< Сыграно игр
-    int gamesWon_ = 0;                           ///< Выиграно игр
-    int gamesLost_ = 0;                          ///< Проиграно игр
-    int gamesPushed_ = 0;                        ///< Ничьих
-    int maxScore_ = 0;                           ///< Максимальный счет
-    double winRate_ = 0.0;                       ///< Процент побед
-
-    /**
-     * @brief Обновить процент побед
-     */
-    void updateWinRate() {
-        winRate_ = (gamesPlayed_ > 0) ?
-            (static_cast<double>(gamesWon_) / gamesPlayed_ * 100) : 0.0;
-    }
+#pragma once
+#include "card.h"
+#include "deck.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <iostream>
+// Без макросов min/max из windows.h: они ломают std::min/std::max
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+/**
+ * @brief Действия доступные игроку в Blackjack
+ */
+enum class PlayerAction {
+    Hit,        ///< Взять карту
+    Stand,      ///< Остановиться
+    DoubleDown, ///< Удвоить ставку
+    Split       ///< Разделить карты
+};
+
+/**
+ * @brief Набор допустимых действий - битовая маска без выделений памяти
+ *
+ * Бит действия - 1 << PlayerAction, тот же формат что и в сообщении
+ * ActionRequest. Порядок обхода и нумерация пунктов меню совпадают
+ * с порядком PlayerAction: Hit, Stand, Double Down, Split.
+ * Набор считается один раз на точку решения (Player::getLegalActions())
+ * и передается в консольный, сетевой и бот-пути.
+ */
+class LegalActions {
+public:
+    static constexpr uint8_t ALL_MASK = 0x0F; ///< Биты всех действий
+
+    /**
+     * @brief Бит действия в маске
+     */
+    static constexpr uint8_t bit(PlayerAction action) {
+        return static_cast<uint8_t>(1u << static_cast<unsigned>(action));
+    }
+
+    constexpr LegalActions() = default;
+
+    /**
+     * @brief Набор из маски (лишние биты отбрасываются)
+     */
+    constexpr explicit LegalActions(uint8_t mask) : mask_(static_cast<uint8_t>(mask & ALL_MASK)) {}
+
+    constexpr uint8_t getMask() const { return mask_; }         ///< Маска для протокола
+    constexpr bool empty() const { return mask_ == 0; }         ///< Нет допустимых действий
+    constexpr bool contains(PlayerAction action) const { return (mask_ & bit(action)) != 0; }
+
+    /// @name Построение набора
+    /// @{
+    constexpr LegalActions with(PlayerAction action) const {
+        return LegalActions(static_cast<uint8_t>(mask_ | bit(action)));
+    }
+    constexpr LegalActions without(PlayerAction action) const {
+        return LegalActions(static_cast<uint8_t>(mask_ & ~bit(action)));
+    }
+    /// @}
+
+    /**
+     * @brief Число допустимых действий
+     */
+    constexpr size_t size() const {
+        size_t count = 0;
+        for (uint8_t rest = mask_; rest != 0; rest = static_cast<uint8_t>(rest & (rest - 1))) {
+            ++count;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Действие по номеру пункта меню
+     * @param index Номер среди допустимых действий (с нуля)
+     * @param action [out] Действие
+     * @return false если номер вне набора
+     */
+    constexpr bool actionAt(size_t index, PlayerAction& action) const {
+        for (Iterator it = begin(); it != end(); ++it) {
+            if (index-- == 0) {
+                action = *it;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Обход допустимых действий по возрастанию кода
+     */
+    class Iterator {
+    public:
+        constexpr explicit Iterator(uint8_t rest) : rest_(rest) {}
+
+        constexpr PlayerAction operator*() const {
+            unsigned index = 0;
+            while (((rest_ >> index) & 1u) == 0) {
+                ++index;
+            }
+            return static_cast<PlayerAction>(index);
+        }
+        constexpr Iterator& operator++() {
+            rest_ = static_cast<uint8_t>(rest_ & (rest_ - 1)); // Снимаем младший бит
+            return *this;
+        }
+        constexpr bool operator!=(const Iterator& other) const { return rest_ != other.rest_; }
+
+    private:
+        uint8_t rest_; ///< Еще не пройденные биты
+    };
+
+    constexpr Iterator begin() const { return Iterator(mask_); }
+    constexpr Iterator end() const { return Iterator(0); }
+
+private:
+    uint8_t mask_ = 0; ///< Биты допустимых действий
+};
+
+static_assert(LegalActions(LegalActions::ALL_MASK).without(PlayerAction::Split).size() == 3,
+    "LegalActions must stay usable in constant expressions");
+
+/**
+ * @brief Класс представляющий игрока в Blackjack
+ *
+ * Управляет состоянием игрока, его картами, статистикой
+ * и доступными действиями в зависимости от ситуации.
+ * После Split у игрока несколько рук (до MAX_HANDS) - все они живут
+ * внутри игрока, а игровые методы работают с активной рукой.
+ */
+class Player {
+public:
+    static constexpr size_t MAX_HANDS = 4; ///< Рук у места (повторный Split до 4 рук)
+
+    /**
+     * @brief Конструктор игрока
+     * @param playerName Имя игрока
+     */
+    Player(const std::string& playerName);
+
+    // ==================== ОСНОВНЫЕ ИГРОВЫЕ МЕТОДЫ ====================
+
+    /**
+     * @brief Взять карту из колоды
+     * @param deck Колода из которой берется карта
+     */
+    void takeCard(Deck& deck);
+
+    /**
+     * @brief Рассчитать текущий счет руки
+     * @return Счет руки с учетом тузов
+     */
+    int calculateScore() const;
+
+    /**
+     * @brief Мягкий ли счет активной руки (туз считается как 11)
+     */
+    bool isSoftScore() const;
+
+    /**
+     * @brief Показать карты активной руки в ASCII-формате
+     */
+    void showHand() const;
+
+    /**
+     * @brief Показать карты руки с номером index в ASCII-формате
+     * @param index Номер руки (0 - getHandCount() - 1)
+     */
+    void showHand(size_t index) const;
+
+    /**
+     * @brief Получить имя игрока
+     * @return Имя игрока
+     */
+    std::string getName() const;
+
+    /**
+     * @brief Получить действие игрока (интерактивный ввод)
+     * @param input Поток ввода (консоль или сценарий)
+     * @return Выбранное действие
+     */
+    PlayerAction getPlayerAction(std::istream& input = std::cin) const;
+
+    /**
+     * @brief Проверить перебор (счет > 21)
+     * @return true если перебор, иначе false
+     */
+    bool isBusted() const;
+
+    /**
+     * @brief Проверить блэкджек с раздачи (две карты на 21, без Split)
+     * @return true если натуральный блэкджек, иначе false
+     */
+    bool hasNatural() const;
+
+    /**
+     * @brief Проверить возможность разделения карт
+     * @return true если в активной руке пара и рук меньше MAX_HANDS
+     */
+    bool canSplit() const;
+
+    /**
+     * @brief Проверить возможность удвоения ставки
+     * @return true если можно удвоить, иначе false
+     */
+    bool canDoubleDown() const;
+
+    /**
+     * @brief Получить текстовое представление руки
+     * @return Строка с картами руки
+     */
+    std::string getHandAsString() const;
+
+    /**
+     * @brief Получить текстовое представление статистики
+     * @return Строка со статистикой игрока
+     */
+    std::string getStatsAsString() const;
+
+    // ==================== МЕТОДЫ ДЛЯ СЕТЕВОЙ ИГРЫ ====================
+
+    /**
+     * @brief Допустимые действия активной руки
+     * @return Набор действий (пустой если у руки перебор)
+     */
+    LegalActions getLegalActions() const;
+
+    /**
+     * @brief Получить текстовое представление доступных действий
+     * @return Строка с описанием доступных действий
+     */
+    std::string getActionsAsString() const;
+
+    /**
+     * @brief Конвертировать сетевой выбор в действие
+     * @param networkChoice Числовой выбор из сети
+     * @return Соответствующее действие
+     */
+    PlayerAction convertNetworkChoice(int networkChoice) const;
+
+    /**
+     * @brief Проверить действие, полученное по бинарному протоколу
+     * @param actionCode Код действия (значение PlayerAction)
+     * @return Запрошенное действие, либо Stand если оно недопустимо
+     */
+    PlayerAction convertNetworkAction(uint8_t actionCode) const;
+
+    // ==================== ВСПОМОГАТЕЛЬНЫЕ МЕТОДЫ ====================
+
+    /**
+     * @brief Показать доступные действия (интерактивный вывод)
+     * @param legal Допустимые действия (номер пункта - позиция в наборе)
+     */
+    void showAvailableActions(LegalActions legal) const;
+
+    /**
+     * @brief Получить выбор игрока (интерактивный ввод)
+     * @param input Поток ввода (консоль или сценарий)
+     * @return Числовой выбор игрока
+     */
+    int getPlayerChoice(std::istream& input = std::cin) const;
+
+    /**
+     * @brief Конвертировать выбор в действие
+     * @param choice Числовой выбор (пункт меню)
+     * @param legal Допустимые действия
+     * @return Соответствующее действие (Hit если пункта нет в меню)
+     */
+    PlayerAction convertChoiceToAction(int choice, LegalActions legal) const;
+
+    // ==================== МЕТОДЫ ДЛЯ РАБОТЫ С РУКОЙ ====================
+
+    /**
+     * @brief Получить константную ссылку на активную руку
+     * @return Константная ссылка на вектор карт
+     */
+    const std::vector<Card>& getHand() const;
+
+    /**
+     * @brief Получить руку по номеру
+     * @param index Номер руки (0 - getHandCount() - 1)
+     * @return Константная ссылка на вектор карт
+     */
+    const std::vector<Card>& getHand(size_t index) const { return hands_[index]; }
+
+    /**
+     * @brief Очистить все руки (для нового раунда)
+     *
+     * Остается одна пустая активная рука; емкость рук сохраняется,
+     * поэтому следующие раунды и Split память не выделяют
+     */
+    void clearHand();
+
+    /**
+     * @brief Добавить карту в активную руку без колоды (для восстановления снимков)
+     * @param card Карта
+     */
+    void addCard(const Card& card);
+
+    /**
+     * @brief Сменить имя игрока (для восстановления снимков)
+     * @param playerName Новое имя
+     */
+    void setName(const std::string& playerName) { name_ = playerName; }
+
+    /// @name Несколько рук после Split
+    /// @{
+
+    /**
+     * @brief Разделить активную руку
+     * @param deck Колода для добора
+     * @return false если разделить нельзя (см. canSplit())
+     *
+     * Вторая карта уходит в новую руку в конце списка, затем каждая
+     * из двух рук получает по карте. Активная рука не меняется.
+     */
+    bool splitActiveHand(Deck& deck);
+
+    /**
+     * @brief Открыть пустую руку и сделать ее активной (для восстановления снимков)
+     * @return false если рук уже MAX_HANDS
+     */
+    bool addHand();
+
+    /**
+     * @brief Сделать руку активной
+     * @param index Номер руки (0 - getHandCount() - 1)
+     */
+    void selectHand(size_t index) { activeHand_ = index < handCount_ ? index : activeHand_; }
+
+    size_t getHandCount() const { return handCount_; }   ///< Число рук в раунде
+    size_t getActiveHand() const { return activeHand_; } ///< Номер активной руки
+    /// @}
+
+    // ==================== СТАТИСТИКА И РЕЗУЛЬТАТЫ ====================
+
+    /// @name Геттеры статистики
+    /// @{
+    int getGamesPlayed() const { return gamesPlayed_; }
+    int getGamesWon() const { return gamesWon_; }
+    int getGamesLost() const { return gamesLost_; }
+    int getGamesPushed() const { return gamesPushed_; }
+    int getMaxScore() const { return maxScore_; }
+    double getWinRate() const { return winRate_; }
+    /// @}
+
+    /// @name Методы обновления статистики
+    /// @{
+    void recordWin();                          ///< Записать победу
+    void recordLoss();                         ///< Записать поражение
+    void recordPush();                         ///< Записать ничью
+    void updateMaxScore(int score);            ///< Обновить максимум очков
+    void showStats() const;                    ///< Показать статистику
+    /// @}
+
+    /// @name Сеттеры статистики (для загрузки)
+    /// @{
+    void setGamesPlayed(int value) { gamesPlayed_ = value; updateWinRate(); }
+    void setGamesWon(int value) { gamesWon_ = value; updateWinRate(); }
+    void setGamesLost(int value) { gamesLost_ = value; updateWinRate(); }
+    void setGamesPushed(int value) { gamesPushed_ = value; updateWinRate(); }
+    void setGamesScore(int value) { maxScore_ = value; }
+    /// @}
+
+    // ==================== ЦВЕТОВЫЕ МЕТОДЫ ====================
+
+    /**
+     * @brief Установка цвета текста в консоли
+     * @param color Код цвета Windows
+     */
+    static void setColor(int color) {
+        HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+        SetConsoleTextAttribute(hConsole, color);
+    }
+
+    static void resetColor() { setColor(7); }      ///< Сброс к стандартному цвету
+    static void setPlayerColor() { setColor(11); } ///< Голубой для игрока
+    static void setCardColor() { setColor(14); }   ///< Желтый для карт
+    static void setScoreColor() { setColor(10); }  ///< Зеленый для счета
+    static void setActionColor() { setColor(15); } ///< Ярко-белый для действий
+
+private:
+    std::string name_;                           ///< Имя игрока
+    std::vector<Card> hands_[MAX_HANDS];         ///< Руки (используются первые handCount_)
+    size_t handCount_ = 1;                       ///< Рук в текущем раунде
+    size_t activeHand_ = 0;                      ///< Рука, к которой относятся игровые методы
+
+    // Статистика игрока
+    int gamesPlayed_ = 0;                        ///< Сыграно игр
+    int gamesWon_ = 0;                           ///< Выиграно игр
+    int gamesLost_ = 0;                          ///< Проиграно игр
+    int gamesPushed_ = 0;                        ///< Ничьих
+    int maxScore_ = 0;                           ///< Максимальный счет
+    double winRate_ = 0.0;                       ///< Процент побед
+
+    /**
+     * @brief Счет набора карт (тузы как 1 или 11)
+     */
+    static int scoreCards(const std::vector<Card>& cards);
+
+    /**
+     * @brief Обновить процент побед
+     */
+    void updateWinRate() {
+        winRate_ = (gamesPlayed_ > 0) ?
+            (static_cast<double>(gamesWon_) / gamesPlayed_ * 100) : 0.0;
+    }
 };
\ No newline at end of file
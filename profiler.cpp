@@ -0,0 +1,144 @@
+#include "profiler.h"
+#include "histogram.h"
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    /**
+     * @brief Гистограммы фаз одного потока
+     *
+     * Счетчики атомарные только ради чтения из dumpPhaseProfile():
+     * пишет их один поток через load + store, без блокирующих инструкций
+     */
+    struct ThreadPhases {
+        std::atomic<uint64_t> buckets[ROUND_PHASE_COUNT][LatencyHistogram::BUCKET_COUNT];
+
+        ThreadPhases() {
+            for (auto& phase : buckets) {
+                for (auto& bucket : phase) {
+                    bucket.store(0, std::memory_order_relaxed);
+                }
+            }
+        }
+    };
+
+    /**
+     * @brief Реестр гистограмм всех потоков (живут до конца программы)
+     */
+    struct PhaseRegistry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadPhases>> threads;
+    };
+
+    PhaseRegistry& registry() {
+        static PhaseRegistry instance;
+        return instance;
+    }
+
+#ifdef BLACKJACK_PROFILE
+    void dumpAtExit() {
+        dumpPhaseProfile(std::cout);
+    }
+#endif
+
+    ThreadPhases* registerThread() {
+        PhaseRegistry& phases = registry();
+        std::lock_guard<std::mutex> lock(phases.mutex);
+#ifdef BLACKJACK_PROFILE
+        if (phases.threads.empty()) {
+            std::atexit(dumpAtExit);
+        }
+#endif
+        phases.threads.emplace_back(new ThreadPhases());
+        return phases.threads.back().get();
+    }
+
+    /**
+     * @brief Тактов profileTimestamp() в наносекунде
+     */
+    double ticksPerNanosecond() {
+#ifdef BLACKJACK_PROFILE_TSC
+        // Частота TSC постоянна на современных процессорах - калибруем по steady_clock
+        static const double ratio = [] {
+            auto wallStart = std::chrono::steady_clock::now();
+            uint64_t tscStart = profileTimestamp();
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            uint64_t tscEnd = profileTimestamp();
+            double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - wallStart).count();
+            return ns > 0.0 ? static_cast<double>(tscEnd - tscStart) / ns : 1.0;
+        }();
+        return ratio;
+#else
+        return 1.0;
+#endif
+    }
+}
+
+const char* roundPhaseName(RoundPhase phase) {
+    switch (phase) {
+    case RoundPhase::DealInitialCards: return "dealInitialCards";
+    case RoundPhase::PlayerTurns:      return "playerTurns";
+    case RoundPhase::DealerTurn:       return "dealerTurn";
+    case RoundPhase::DetermineWinner:  return "determineWinner";
+    case RoundPhase::Render:           return "render";
+    case RoundPhase::StatsIo:          return "statsIo";
+    default:                           return "unknown";
+    }
+}
+
+void recordPhase(RoundPhase phase, uint64_t ticks) {
+    // Указатель без динамической инициализации - без проверки guard на каждом зонде
+    thread_local ThreadPhases* local = nullptr;
+    if (!local) {
+        local = registerThread();
+    }
+
+    std::atomic<uint64_t>& bucket =
+        local->buckets[static_cast<size_t>(phase)][LatencyHistogram::bucketIndex(ticks)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void dumpPhaseProfile(std::ostream& os) {
+    // Сливаем потоки в обычные гистограммы; значение корзины - ее нижняя граница
+    LatencyHistogram merged[ROUND_PHASE_COUNT];
+    {
+        PhaseRegistry& phases = registry();
+        std::lock_guard<std::mutex> lock(phases.mutex);
+        for (const auto& thread : phases.threads) {
+            for (size_t phase = 0; phase < ROUND_PHASE_COUNT; ++phase) {
+                for (size_t bucket = 0; bucket < LatencyHistogram::BUCKET_COUNT; ++bucket) {
+                    uint64_t count = thread->buckets[phase][bucket].load(std::memory_order_relaxed);
+                    merged[phase].record(LatencyHistogram::bucketLowerBound(bucket), count);
+                }
+            }
+        }
+    }
+
+    double ticksPerUs = ticksPerNanosecond() * 1000.0;
+    os << "\n=== ROUND PHASE PROFILE (us) ===\n";
+    os << std::left << std::setw(18) << "Phase" << std::right
+        << std::setw(10) << "count" << std::setw(12) << "mean"
+        << std::setw(12) << "p50" << std::setw(12) << "p90"
+        << std::setw(12) << "p99" << std::setw(12) << "max" << "\n";
+
+    os << std::fixed << std::setprecision(2);
+    for (size_t phase = 0; phase < ROUND_PHASE_COUNT; ++phase) {
+        const LatencyHistogram& histogram = merged[phase];
+        if (histogram.getCount() == 0) {
+            continue;
+        }
+        os << std::left << std::setw(18) << roundPhaseName(static_cast<RoundPhase>(phase)) << std::right
+            << std::setw(10) << histogram.getCount()
+            << std::setw(12) << histogram.getMean() / ticksPerUs
+            << std::setw(12) << histogram.valueAtPercentile(50.0) / ticksPerUs
+            << std::setw(12) << histogram.valueAtPercentile(90.0) / ticksPerUs
+            << std::setw(12) << histogram.valueAtPercentile(99.0) / ticksPerUs
+            << std::setw(12) << histogram.getMax() / ticksPerUs << "\n";
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define BLACKJACK_PROFILE_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BLACKJACK_PROFILE_TSC 1
+#endif
+
+/**
+ * @brief Фазы раунда, время которых измеряется
+ *
+ * Фазы могут быть вложены: отрисовка стола происходит внутри раздачи
+ * и ходов игроков, поэтому Render считается и в них тоже
+ */
+enum class RoundPhase : uint8_t {
+    DealInitialCards, ///< Game::dealInitialCards
+    PlayerTurns,      ///< Game::playerTurns (включая ожидание ввода)
+    DealerTurn,       ///< Game::dealerTurn
+    DetermineWinner,  ///< Game::determineWinner
+    Render,           ///< Отрисовка стола
+    StatsIo,          ///< Загрузка и сохранение статистики
+    Count             ///< Число фаз
+};
+
+constexpr size_t ROUND_PHASE_COUNT = static_cast<size_t>(RoundPhase::Count); ///< Число фаз
+
+/**
+ * @brief Название фазы для отчета
+ */
+const char* roundPhaseName(RoundPhase phase);
+
+/**
+ * @brief Метка времени зонда: такты TSC на x86, иначе наносекунды steady_clock
+ */
+inline uint64_t profileTimestamp() {
+#ifdef BLACKJACK_PROFILE_TSC
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/**
+ * @brief Записать длительность фазы в гистограмму текущего потока
+ * @param phase Фаза
+ * @param ticks Длительность в единицах profileTimestamp()
+ *
+ * У каждого потока свои гистограммы, которые пишет только он сам, -
+ * без блокировок и общих кеш-линий. Регистрация потока (один раз)
+ * проходит под мьютексом.
+ */
+void recordPhase(RoundPhase phase, uint64_t ticks);
+
+/**
+ * @brief Вывести сводку по фазам всех потоков (можно вызывать в любой момент)
+ * @param os Поток вывода
+ */
+void dumpPhaseProfile(std::ostream& os);
+
+/**
+ * @brief Зонд: измеряет время от создания до выхода из области видимости
+ */
+class PhaseTimer {
+public:
+    explicit PhaseTimer(RoundPhase phase)
+        : phase_(phase), start_(profileTimestamp()) {
+    }
+
+    ~PhaseTimer() {
+        recordPhase(phase_, profileTimestamp() - start_);
+    }
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+    RoundPhase phase_; ///< Измеряемая фаза
+    uint64_t start_;   ///< Метка начала
+};
+
+/**
+ * @brief Измерить фазу до конца текущего блока
+ *
+ * Зонды включаются определением BLACKJACK_PROFILE при сборке
+ * (/D BLACKJACK_PROFILE); без него макрос не порождает никакого кода.
+ * Со включенными зондами сводка выводится при выходе из программы.
+ */
+#ifdef BLACKJACK_PROFILE
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_PHASE(phase) PhaseTimer PROFILE_CONCAT(phaseTimer_, __LINE__)(phase)
+#else
+#define PROFILE_PHASE(phase) ((void)0)
+#endif
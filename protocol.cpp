@@ -0,0 +1,364 @@
+#include "protocol.h"
+
+// Размеры тел сообщений фиксированной длины (без заголовка)
+constexpr size_t TABLE_STATE_FIXED_SIZE = 12;    // tableId, roundId, activeSeat, flags, dealerScore, dealerCardCount
+constexpr size_t ACTION_REQUEST_FIXED_SIZE = 12; // tableId, roundId, seat, legalMask, upcard, cardCount
+constexpr size_t DECISION_SIZE = 10;             // tableId, roundId, seat, action
+constexpr size_t ROUND_RESULT_FIXED_SIZE = 10;   // tableId, roundId, dealerScore, seatCount
+constexpr size_t ROUND_RESULT_SEAT_SIZE = 3;     // seat, outcome, score
+constexpr size_t TABLE_DELTA_FIXED_SIZE = 13;    // tableId, roundId, sequence, eventCount
+constexpr size_t TABLE_DELTA_EVENT_SIZE = 3;     // kind, seat, value
+constexpr size_t SUBSCRIBE_SIZE = 4;             // tableId
+
+// ==================== ВСПОМОГАТЕЛЬНЫЕ ФУНКЦИИ ====================
+
+/**
+ * @brief Последовательная запись полей в буфер вызывающей стороны
+ *
+ * При переполнении запоминает ошибку и перестает писать,
+ * поэтому проверка выполняется один раз в конце кодирования
+ */
+class ByteWriter {
+public:
+    ByteWriter(uint8_t* buffer, size_t capacity)
+        : buffer_(buffer), capacity_(capacity) {
+    }
+
+    void putU8(uint8_t value) {
+        if (position_ + 1 > capacity_) { overflow_ = true; return; }
+        buffer_[position_++] = value;
+    }
+
+    void putU16(uint16_t value) {
+        putU8(static_cast<uint8_t>(value));
+        putU8(static_cast<uint8_t>(value >> 8));
+    }
+
+    void putU32(uint32_t value) {
+        putU16(static_cast<uint16_t>(value));
+        putU16(static_cast<uint16_t>(value >> 16));
+    }
+
+    void putHeader(MessageType type) {
+        putU8(PROTOCOL_MAGIC);
+        putU8(PROTOCOL_VERSION);
+        putU8(static_cast<uint8_t>(type));
+        putU8(0);
+        putU16(0); // Длина заполняется в finish()
+    }
+
+    /**
+     * @brief Завершить сообщение и проставить длину в заголовке
+     * @return Длина сообщения или 0 при переполнении
+     */
+    size_t finish() {
+        if (overflow_ || position_ > PROTOCOL_MAX_MESSAGE_SIZE) {
+            return 0;
+        }
+        buffer_[4] = static_cast<uint8_t>(position_);
+        buffer_[5] = static_cast<uint8_t>(position_ >> 8);
+        return position_;
+    }
+
+private:
+    uint8_t* buffer_;      ///< Буфер назначения
+    size_t capacity_;      ///< Размер буфера
+    size_t position_ = 0;  ///< Текущая позиция записи
+    bool overflow_ = false; ///< Признак переполнения
+};
+
+static uint16_t readU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static uint32_t readU32(const uint8_t* p) {
+    return static_cast<uint32_t>(readU16(p)) | (static_cast<uint32_t>(readU16(p + 2)) << 16);
+}
+
+/**
+ * @brief Записать руку: число карт и коды карт
+ */
+static void putHand(ByteWriter& writer, const std::vector<Card>& hand) {
+    writer.putU8(static_cast<uint8_t>(hand.size()));
+    for (const auto& card : hand) {
+        writer.putU8(encodeCard(card));
+    }
+}
+
+/**
+ * @brief Проверить заголовок и тип сообщения
+ * @return Указатель на тело или nullptr
+ */
+static const uint8_t* checkMessage(const uint8_t* data, size_t size, MessageType expected, size_t minBody) {
+    MessageHeader header;
+    if (!decodeHeader(data, size, header) || header.type != expected ||
+        header.length < PROTOCOL_HEADER_SIZE + minBody) {
+        return nullptr;
+    }
+    return data + PROTOCOL_HEADER_SIZE;
+}
+
+// ==================== КАРТЫ И ДЕЙСТВИЯ ====================
+
+uint8_t encodeCard(const Card& card) {
+    return static_cast<uint8_t>((static_cast<int>(card.getSuit()) << 4) |
+        static_cast<int>(card.getRank()));
+}
+
+bool decodeCard(uint8_t code, Card& card) {
+    int suit = code >> 4;
+    int rank = code & 0x0F;
+    if (suit > static_cast<int>(Suit::Spades) ||
+        rank < static_cast<int>(Rank::Two) || rank > static_cast<int>(Rank::Ace)) {
+        return false;
+    }
+    card = Card(static_cast<Suit>(suit), static_cast<Rank>(rank));
+    return true;
+}
+
+// ==================== КОДИРОВАНИЕ ====================
+
+size_t encodeTableState(uint8_t* buffer, size_t capacity, const TableStateInfo& info,
+    const Dealer& dealer, const std::vector<Player>& seats) {
+    ByteWriter writer(buffer, capacity);
+    writer.putHeader(MessageType::TableState);
+    writer.putU32(info.tableId);
+    writer.putU32(info.roundId);
+    writer.putU8(info.activeSeat);
+    writer.putU8(info.holeCardHidden ? TABLE_FLAG_HOLE_HIDDEN : 0);
+
+    // Пока карта дилера скрыта, его счет клиенту не сообщается
+    const auto& dealerHand = dealer.getHand();
+    writer.putU8(info.holeCardHidden ? 0 : static_cast<uint8_t>(dealer.calculateScore()));
+    writer.putU8(static_cast<uint8_t>(dealerHand.size()));
+    for (size_t i = 0; i < dealerHand.size(); ++i) {
+        bool hidden = info.holeCardHidden && i > 0;
+        writer.putU8(hidden ? CARD_HIDDEN : encodeCard(dealerHand[i]));
+    }
+
+    writer.putU8(static_cast<uint8_t>(seats.size()));
+    for (size_t i = 0; i < seats.size(); ++i) {
+        const auto& player = seats[i];
+        uint8_t flags = player.isBusted() ? SEAT_FLAG_BUSTED : 0;
+        if (info.activeSeat != NO_ACTIVE_SEAT && i < info.activeSeat) {
+            flags |= SEAT_FLAG_FINISHED;
+        }
+        writer.putU8(static_cast<uint8_t>(i));
+        writer.putU8(flags);
+        writer.putU8(static_cast<uint8_t>(player.calculateScore()));
+        putHand(writer, player.getHand());
+    }
+
+    return writer.finish();
+}
+
+size_t encodeActionRequest(uint8_t* buffer, size_t capacity, uint32_t tableId, uint32_t roundId,
+    uint8_t seat, const Player& player, const Card& dealerUpcard, LegalActions legalActions) {
+    ByteWriter writer(buffer, capacity);
+    writer.putHeader(MessageType::ActionRequest);
+    writer.putU32(tableId);
+    writer.putU32(roundId);
+    writer.putU8(seat);
+    writer.putU8(legalActions.getMask());
+    writer.putU8(encodeCard(dealerUpcard));
+    putHand(writer, player.getHand());
+    return writer.finish();
+}
+
+size_t encodeDecision(uint8_t* buffer, size_t capacity, uint32_t tableId, uint32_t roundId,
+    uint8_t seat, PlayerAction action) {
+    ByteWriter writer(buffer, capacity);
+    writer.putHeader(MessageType::Decision);
+    writer.putU32(tableId);
+    writer.putU32(roundId);
+    writer.putU8(seat);
+    writer.putU8(static_cast<uint8_t>(action));
+    return writer.finish();
+}
+
+size_t encodeRoundResult(uint8_t* buffer, size_t capacity, uint32_t tableId, uint32_t roundId,
+    uint8_t dealerScore, const std::vector<RoundOutcome>& outcomes, const std::vector<Player>& seats) {
+    ByteWriter writer(buffer, capacity);
+    writer.putHeader(MessageType::RoundResult);
+    writer.putU32(tableId);
+    writer.putU32(roundId);
+    writer.putU8(dealerScore);
+    writer.putU8(static_cast<uint8_t>(outcomes.size()));
+    for (size_t i = 0; i < outcomes.size(); ++i) {
+        writer.putU8(static_cast<uint8_t>(i));
+        writer.putU8(static_cast<uint8_t>(outcomes[i]));
+        writer.putU8(i < seats.size() ? static_cast<uint8_t>(seats[i].calculateScore()) : 0);
+    }
+    return writer.finish();
+}
+
+size_t encodeTableDelta(uint8_t* buffer, size_t capacity, uint32_t tableId, uint32_t roundId,
+    uint32_t sequence, const TableEvent* events, size_t count) {
+    if (count > PROTOCOL_MAX_DELTA_EVENTS) {
+        return 0;
+    }
+
+    ByteWriter writer(buffer, capacity);
+    writer.putHeader(MessageType::TableDelta);
+    writer.putU32(tableId);
+    writer.putU32(roundId);
+    writer.putU32(sequence);
+    writer.putU8(static_cast<uint8_t>(count));
+    for (size_t i = 0; i < count; ++i) {
+        writer.putU8(static_cast<uint8_t>(events[i].kind));
+        writer.putU8(events[i].seat);
+        writer.putU8(events[i].value);
+    }
+    return writer.finish();
+}
+
+size_t encodeSubscribe(uint8_t* buffer, size_t capacity, uint32_t tableId) {
+    ByteWriter writer(buffer, capacity);
+    writer.putHeader(MessageType::Subscribe);
+    writer.putU32(tableId);
+    return writer.finish();
+}
+
+// ==================== ДЕКОДИРОВАНИЕ ====================
+
+bool decodeHeader(const uint8_t* data, size_t size, MessageHeader& header) {
+    if (size < PROTOCOL_HEADER_SIZE || data[0] != PROTOCOL_MAGIC || data[1] != PROTOCOL_VERSION) {
+        return false;
+    }
+
+    uint8_t type = data[2];
+    if (type < static_cast<uint8_t>(MessageType::TableState) ||
+        type > static_cast<uint8_t>(MessageType::Subscribe)) {
+        return false;
+    }
+
+    header.type = static_cast<MessageType>(type);
+    header.length = readU16(data + 4);
+    return header.length >= PROTOCOL_HEADER_SIZE &&
+        header.length <= PROTOCOL_MAX_MESSAGE_SIZE &&
+        header.length <= size;
+}
+
+bool TableStateView::parse(const uint8_t* data, size_t size) {
+    body_ = checkMessage(data, size, MessageType::TableState, TABLE_STATE_FIXED_SIZE);
+    if (!body_) {
+        return false;
+    }
+
+    size_t bodySize = readU16(data + 4) - PROTOCOL_HEADER_SIZE;
+    seatsOffset_ = TABLE_STATE_FIXED_SIZE + dealerCardCount();
+    if (seatsOffset_ + 1 > bodySize) {
+        body_ = nullptr;
+        return false;
+    }
+
+    // Проверяем что все записи мест помещаются в сообщение
+    size_t offset = seatsOffset_ + 1;
+    for (size_t i = 0; i < seatCount(); ++i) {
+        if (offset + 4 > bodySize || offset + SeatView(body_ + offset).size() > bodySize) {
+            body_ = nullptr;
+            return false;
+        }
+        offset += SeatView(body_ + offset).size();
+    }
+    return true;
+}
+
+uint32_t TableStateView::tableId() const { return readU32(body_); }
+uint32_t TableStateView::roundId() const { return readU32(body_ + 4); }
+uint8_t TableStateView::activeSeat() const { return body_[8]; }
+bool TableStateView::holeCardHidden() const { return (body_[9] & TABLE_FLAG_HOLE_HIDDEN) != 0; }
+uint8_t TableStateView::dealerScore() const { return body_[10]; }
+uint8_t TableStateView::dealerCardCount() const { return body_[11]; }
+uint8_t TableStateView::dealerCardCode(size_t i) const { return body_[TABLE_STATE_FIXED_SIZE + i]; }
+uint8_t TableStateView::seatCount() const { return body_[seatsOffset_]; }
+
+SeatView TableStateView::seat(size_t index) const {
+    size_t offset = seatsOffset_ + 1;
+    for (size_t i = 0; i < index; ++i) {
+        offset += SeatView(body_ + offset).size();
+    }
+    return SeatView(body_ + offset);
+}
+
+bool ActionRequestView::parse(const uint8_t* data, size_t size) {
+    body_ = checkMessage(data, size, MessageType::ActionRequest, ACTION_REQUEST_FIXED_SIZE);
+    if (body_ && readU16(data + 4) < PROTOCOL_HEADER_SIZE + ACTION_REQUEST_FIXED_SIZE + cardCount()) {
+        body_ = nullptr;
+    }
+    return body_ != nullptr;
+}
+
+uint32_t ActionRequestView::tableId() const { return readU32(body_); }
+uint32_t ActionRequestView::roundId() const { return readU32(body_ + 4); }
+uint8_t ActionRequestView::seat() const { return body_[8]; }
+LegalActions ActionRequestView::legalActions() const { return LegalActions(body_[9]); }
+uint8_t ActionRequestView::dealerUpcardCode() const { return body_[10]; }
+uint8_t ActionRequestView::cardCount() const { return body_[11]; }
+uint8_t ActionRequestView::cardCode(size_t i) const { return body_[ACTION_REQUEST_FIXED_SIZE + i]; }
+
+bool DecisionView::parse(const uint8_t* data, size_t size) {
+    body_ = checkMessage(data, size, MessageType::Decision, DECISION_SIZE);
+    return body_ != nullptr;
+}
+
+uint32_t DecisionView::tableId() const { return readU32(body_); }
+uint32_t DecisionView::roundId() const { return readU32(body_ + 4); }
+uint8_t DecisionView::seat() const { return body_[8]; }
+uint8_t DecisionView::actionCode() const { return body_[9]; }
+
+bool RoundResultView::parse(const uint8_t* data, size_t size) {
+    body_ = checkMessage(data, size, MessageType::RoundResult, ROUND_RESULT_FIXED_SIZE);
+    if (body_ && readU16(data + 4) <
+        PROTOCOL_HEADER_SIZE + ROUND_RESULT_FIXED_SIZE + seatCount() * ROUND_RESULT_SEAT_SIZE) {
+        body_ = nullptr;
+    }
+    return body_ != nullptr;
+}
+
+uint32_t RoundResultView::tableId() const { return readU32(body_); }
+uint32_t RoundResultView::roundId() const { return readU32(body_ + 4); }
+uint8_t RoundResultView::dealerScore() const { return body_[8]; }
+uint8_t RoundResultView::seatCount() const { return body_[9]; }
+
+uint8_t RoundResultView::seat(size_t i) const {
+    return body_[ROUND_RESULT_FIXED_SIZE + i * ROUND_RESULT_SEAT_SIZE];
+}
+
+RoundOutcome RoundResultView::outcome(size_t i) const {
+    return static_cast<RoundOutcome>(body_[ROUND_RESULT_FIXED_SIZE + i * ROUND_RESULT_SEAT_SIZE + 1]);
+}
+
+uint8_t RoundResultView::score(size_t i) const {
+    return body_[ROUND_RESULT_FIXED_SIZE + i * ROUND_RESULT_SEAT_SIZE + 2];
+}
+
+bool TableDeltaView::parse(const uint8_t* data, size_t size) {
+    body_ = checkMessage(data, size, MessageType::TableDelta, TABLE_DELTA_FIXED_SIZE);
+    if (body_ && readU16(data + 4) <
+        PROTOCOL_HEADER_SIZE + TABLE_DELTA_FIXED_SIZE + eventCount() * TABLE_DELTA_EVENT_SIZE) {
+        body_ = nullptr;
+    }
+    return body_ != nullptr;
+}
+
+uint32_t TableDeltaView::tableId() const { return readU32(body_); }
+uint32_t TableDeltaView::roundId() const { return readU32(body_ + 4); }
+uint32_t TableDeltaView::sequence() const { return readU32(body_ + 8); }
+uint8_t TableDeltaView::eventCount() const { return body_[12]; }
+
+TableEvent TableDeltaView::event(size_t i) const {
+    const uint8_t* p = body_ + TABLE_DELTA_FIXED_SIZE + i * TABLE_DELTA_EVENT_SIZE;
+    TableEvent event;
+    event.kind = static_cast<DeltaKind>(p[0]);
+    event.seat = p[1];
+    event.value = p[2];
+    return event;
+}
+
+bool SubscribeView::parse(const uint8_t* data, size_t size) {
+    body_ = checkMessage(data, size, MessageType::Subscribe, SUBSCRIBE_SIZE);
+    return body_ != nullptr;
+}
+
+uint32_t SubscribeView::tableId() const { return readU32(body_); }
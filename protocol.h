@@ -0,0 +1,354 @@
+#pragma once
+#include "player.h"
+#include "dealer.h"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file protocol.h
+ * @brief Бинарный сетевой протокол стола
+ *
+ * Все сообщения имеют фиксированный заголовок (6 байт) и тело
+ * фиксированной структуры. Многобайтовые поля - little-endian.
+ *
+ * Заголовок:
+ * | смещение | размер | поле                               |
+ * |----------|--------|------------------------------------|
+ * | 0        | 1      | магическое число PROTOCOL_MAGIC    |
+ * | 1        | 1      | версия протокола                   |
+ * | 2        | 1      | тип сообщения (MessageType)        |
+ * | 3        | 1      | зарезервировано (0)                |
+ * | 4        | 2      | полная длина сообщения с заголовком|
+ *
+ * Карта кодируется одним байтом: (масть << 4) | достоинство,
+ * скрытая карта дилера - байт CARD_HIDDEN.
+ *
+ * Кодирование выполняется в заранее выделенный буфер вызывающей стороны,
+ * декодирование - через "представления" (View), которые читают поля
+ * прямо из принятого буфера без копирования и без выделения памяти.
+ */
+
+constexpr uint8_t PROTOCOL_MAGIC = 0xB1;         ///< Магическое число сообщения
+constexpr uint8_t PROTOCOL_VERSION = 1;          ///< Текущая версия протокола
+constexpr size_t PROTOCOL_HEADER_SIZE = 6;       ///< Размер заголовка в байтах
+constexpr size_t PROTOCOL_MAX_MESSAGE_SIZE = 512; ///< Максимальный размер сообщения
+constexpr uint8_t CARD_HIDDEN = 0x00;            ///< Код скрытой карты
+constexpr uint8_t NO_ACTIVE_SEAT = 0xFF;         ///< Нет игрока, ожидающего хода
+constexpr uint8_t DEALER_SEAT = 0xFE;            ///< "Место" дилера в событиях дельты
+constexpr size_t PROTOCOL_MAX_DELTA_EVENTS = 64; ///< Максимум событий в одном сообщении дельты
+
+/**
+ * @brief Типы сообщений протокола
+ */
+enum class MessageType : uint8_t {
+    TableState = 1,    ///< Полное состояние стола (сервер -> клиент)
+    ActionRequest = 2, ///< Запрос хода с маской допустимых действий (сервер -> клиент)
+    Decision = 3,      ///< Решение игрока (клиент -> сервер)
+    RoundResult = 4,   ///< Итоги раунда (сервер -> клиент)
+    TableDelta = 5,    ///< Изменения стола для зрителей (сервер -> зритель)
+    Subscribe = 6      ///< Подписка зрителя на стол (зритель -> сервер)
+};
+
+/**
+ * @brief Исход раунда для места за столом
+ */
+enum class RoundOutcome : uint8_t {
+    Win = 1,  ///< Победа игрока
+    Loss = 2, ///< Поражение игрока
+    Push = 3  ///< Ничья
+};
+
+/**
+ * @brief Виды событий в сообщении дельты
+ */
+enum class DeltaKind : uint8_t {
+    RoundStarted = 1,     ///< Начался новый раунд (руки очищены)
+    CardDealt = 2,        ///< Карта выдана месту или дилеру (закрытая - CARD_HIDDEN)
+    ActionTaken = 3,      ///< Игрок сделал ход (value - PlayerAction)
+    HoleCardRevealed = 4, ///< Открыта закрытая карта дилера
+    SeatResult = 5        ///< Итог места (value - RoundOutcome)
+};
+
+/**
+ * @brief Одно событие дельты (3 байта на проводе)
+ */
+struct TableEvent {
+    DeltaKind kind = DeltaKind::RoundStarted; ///< Вид события
+    uint8_t seat = 0;                         ///< Место или DEALER_SEAT
+    uint8_t value = 0;                        ///< Код карты, действия или исхода
+};
+
+/// @name Флаги мест и стола
+/// @{
+constexpr uint8_t SEAT_FLAG_BUSTED = 0x01;       ///< У игрока перебор
+constexpr uint8_t SEAT_FLAG_FINISHED = 0x02;     ///< Игрок завершил ход
+constexpr uint8_t TABLE_FLAG_HOLE_HIDDEN = 0x01; ///< Закрытая карта дилера скрыта
+/// @}
+
+// ==================== КАРТЫ И ДЕЙСТВИЯ ====================
+
+/**
+ * @brief Закодировать карту в один байт
+ * @param card Карта
+ * @return Байт (масть << 4) | достоинство
+ */
+uint8_t encodeCard(const Card& card);
+
+/**
+ * @brief Раскодировать карту из байта
+ * @param code Байт карты
+ * @param card [out] Раскодированная карта
+ * @return false если байт не является допустимой картой (в т.ч. CARD_HIDDEN)
+ */
+bool decodeCard(uint8_t code, Card& card);
+
+// ==================== КОДИРОВАНИЕ ====================
+
+/**
+ * @brief Общие поля сообщения о состоянии стола
+ */
+struct TableStateInfo {
+    uint32_t tableId = 0;                  ///< Идентификатор стола
+    uint32_t roundId = 0;                  ///< Номер раунда
+    uint8_t activeSeat = NO_ACTIVE_SEAT;   ///< Место, ожидающее хода
+    bool holeCardHidden = true;            ///< Скрывать ли закрытую карту дилера
+};
+
+/**
+ * @brief Закодировать полное состояние стола
+ * @param buffer Буфер назначения
+ * @param capacity Размер буфера
+ * @param info Общие поля стола
+ * @param dealer Дилер
+ * @param seats Игроки за столом (индекс = номер места)
+ * @return Число записанных байт или 0 если буфер мал
+ */
+size_t encodeTableState(uint8_t* buffer, size_t capacity, const TableStateInfo& info,
+    const Dealer& dealer, const std::vector<Player>& seats);
+
+/**
+ * @brief Закодировать запрос хода
+ * @param buffer Буфер назначения
+ * @param capacity Размер буфера
+ * @param tableId Идентификатор стола
+ * @param roundId Номер раунда
+ * @param seat Номер места
+ * @param player Игрок, который должен сделать ход
+ * @param dealerUpcard Открытая карта дилера
+ * @param legalActions Допустимые действия (обычно player.getLegalActions())
+ * @return Число записанных байт или 0 если буфер мал
+ */
+size_t encodeActionRequest(uint8_t* buffer, size_t capacity, uint32_t tableId, uint32_t roundId,
+    uint8_t seat, const Player& player, const Card& dealerUpcard, LegalActions legalActions);
+
+/**
+ * @brief Закодировать решение игрока
+ * @param buffer Буфер назначения
+ * @param capacity Размер буфера
+ * @param tableId Идентификатор стола
+ * @param roundId Номер раунда
+ * @param seat Номер места
+ * @param action Выбранное действие
+ * @return Число записанных байт или 0 если буфер мал
+ */
+size_t encodeDecision(uint8_t* buffer, size_t capacity, uint32_t tableId, uint32_t roundId,
+    uint8_t seat, PlayerAction action);
+
+/**
+ * @brief Закодировать итоги раунда
+ * @param buffer Буфер назначения
+ * @param capacity Размер буфера
+ * @param tableId Идентификатор стола
+ * @param roundId Номер раунда
+ * @param dealerScore Финальный счет дилера
+ * @param outcomes Исходы по местам (индекс = номер места)
+ * @param seats Игроки за столом
+ * @return Число записанных байт или 0 если буфер мал
+ */
+size_t encodeRoundResult(uint8_t* buffer, size_t capacity, uint32_t tableId, uint32_t roundId,
+    uint8_t dealerScore, const std::vector<RoundOutcome>& outcomes, const std::vector<Player>& seats);
+
+/**
+ * @brief Закодировать дельту стола для зрителей
+ * @param buffer Буфер назначения
+ * @param capacity Размер буфера
+ * @param tableId Идентификатор стола
+ * @param roundId Номер раунда
+ * @param sequence Порядковый номер дельты стола
+ * @param events События (не более PROTOCOL_MAX_DELTA_EVENTS)
+ * @param count Число событий
+ * @return Число записанных байт или 0 если буфер мал
+ */
+size_t encodeTableDelta(uint8_t* buffer, size_t capacity, uint32_t tableId, uint32_t roundId,
+    uint32_t sequence, const TableEvent* events, size_t count);
+
+/**
+ * @brief Закодировать подписку зрителя на стол
+ * @param buffer Буфер назначения
+ * @param capacity Размер буфера
+ * @param tableId Идентификатор стола
+ * @return Число записанных байт или 0 если буфер мал
+ */
+size_t encodeSubscribe(uint8_t* buffer, size_t capacity, uint32_t tableId);
+
+// ==================== ДЕКОДИРОВАНИЕ ====================
+
+/**
+ * @brief Раскодированный заголовок сообщения
+ */
+struct MessageHeader {
+    MessageType type = MessageType::TableState; ///< Тип сообщения
+    uint16_t length = 0;                        ///< Полная длина сообщения
+};
+
+/**
+ * @brief Проверить и раскодировать заголовок
+ * @param data Начало принятых данных
+ * @param size Число доступных байт
+ * @param header [out] Заголовок
+ * @return true если заголовок корректен и сообщение принято целиком
+ */
+bool decodeHeader(const uint8_t* data, size_t size, MessageHeader& header);
+
+/**
+ * @brief Представление места в сообщении о состоянии стола
+ */
+class SeatView {
+public:
+    SeatView(const uint8_t* data) : data_(data) {}
+
+    uint8_t seat() const { return data_[0]; }        ///< Номер места
+    uint8_t flags() const { return data_[1]; }       ///< Флаги SEAT_FLAG_*
+    uint8_t score() const { return data_[2]; }       ///< Счет руки
+    uint8_t cardCount() const { return data_[3]; }   ///< Число карт
+    uint8_t cardCode(size_t i) const { return data_[4 + i]; } ///< Код i-й карты
+
+    /**
+     * @brief Размер записи места в байтах
+     */
+    size_t size() const { return 4 + static_cast<size_t>(cardCount()); }
+
+private:
+    const uint8_t* data_; ///< Начало записи места в буфере
+};
+
+/**
+ * @brief Представление сообщения о состоянии стола
+ *
+ * Не владеет памятью: буфер должен жить дольше представления
+ */
+class TableStateView {
+public:
+    /**
+     * @brief Проверить структуру сообщения
+     * @param data Начало сообщения (с заголовком)
+     * @param size Длина сообщения
+     * @return true если все записи помещаются в сообщение
+     */
+    bool parse(const uint8_t* data, size_t size);
+
+    uint32_t tableId() const;                     ///< Идентификатор стола
+    uint32_t roundId() const;                     ///< Номер раунда
+    uint8_t activeSeat() const;                   ///< Место, ожидающее хода
+    bool holeCardHidden() const;                  ///< Скрыта ли карта дилера
+    uint8_t dealerScore() const;                  ///< Видимый счет дилера
+    uint8_t dealerCardCount() const;              ///< Число карт дилера
+    uint8_t dealerCardCode(size_t i) const;       ///< Код i-й карты дилера
+    uint8_t seatCount() const;                    ///< Число мест
+
+    /**
+     * @brief Получить запись места
+     * @param index Порядковый номер записи (0..seatCount()-1)
+     * @return Представление места
+     */
+    SeatView seat(size_t index) const;
+
+private:
+    const uint8_t* body_ = nullptr; ///< Начало тела сообщения
+    size_t seatsOffset_ = 0;        ///< Смещение первой записи места в теле
+};
+
+/**
+ * @brief Представление запроса хода
+ */
+class ActionRequestView {
+public:
+    bool parse(const uint8_t* data, size_t size);
+
+    uint32_t tableId() const;               ///< Идентификатор стола
+    uint32_t roundId() const;               ///< Номер раунда
+    uint8_t seat() const;                   ///< Номер места
+    LegalActions legalActions() const;      ///< Допустимые действия
+    uint8_t dealerUpcardCode() const;       ///< Код открытой карты дилера
+    uint8_t cardCount() const;              ///< Число карт игрока
+    uint8_t cardCode(size_t i) const;       ///< Код i-й карты игрока
+
+private:
+    const uint8_t* body_ = nullptr; ///< Начало тела сообщения
+};
+
+/**
+ * @brief Представление решения игрока
+ */
+class DecisionView {
+public:
+    bool parse(const uint8_t* data, size_t size);
+
+    uint32_t tableId() const;     ///< Идентификатор стола
+    uint32_t roundId() const;     ///< Номер раунда
+    uint8_t seat() const;         ///< Номер места
+    uint8_t actionCode() const;   ///< Код действия (значение PlayerAction)
+
+private:
+    const uint8_t* body_ = nullptr; ///< Начало тела сообщения
+};
+
+/**
+ * @brief Представление итогов раунда
+ */
+class RoundResultView {
+public:
+    bool parse(const uint8_t* data, size_t size);
+
+    uint32_t tableId() const;                 ///< Идентификатор стола
+    uint32_t roundId() const;                 ///< Номер раунда
+    uint8_t dealerScore() const;              ///< Счет дилера
+    uint8_t seatCount() const;                ///< Число мест
+    uint8_t seat(size_t i) const;             ///< Номер i-го места
+    RoundOutcome outcome(size_t i) const;     ///< Исход i-го места
+    uint8_t score(size_t i) const;            ///< Счет i-го места
+
+private:
+    const uint8_t* body_ = nullptr; ///< Начало тела сообщения
+};
+
+/**
+ * @brief Представление дельты стола
+ */
+class TableDeltaView {
+public:
+    bool parse(const uint8_t* data, size_t size);
+
+    uint32_t tableId() const;              ///< Идентификатор стола
+    uint32_t roundId() const;              ///< Номер раунда
+    uint32_t sequence() const;             ///< Порядковый номер дельты
+    uint8_t eventCount() const;            ///< Число событий
+    TableEvent event(size_t i) const;      ///< i-е событие
+
+private:
+    const uint8_t* body_ = nullptr; ///< Начало тела сообщения
+};
+
+/**
+ * @brief Представление подписки зрителя
+ */
+class SubscribeView {
+public:
+    bool parse(const uint8_t* data, size_t size);
+
+    uint32_t tableId() const; ///< Идентификатор стола
+
+private:
+    const uint8_t* body_ = nullptr; ///< Начало тела сообщения
+};
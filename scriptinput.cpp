@@ -0,0 +1,148 @@
+#include "scriptinput.h"
+#include "options.h"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+// ==================== БУФЕР СЦЕНАРИЯ ====================
+
+ScriptedInputBuffer::ScriptedInputBuffer(const std::vector<std::string>& lines) {
+    lines_.reserve(lines.size());
+    for (const auto& line : lines) {
+        lines_.push_back(line + "\n");
+    }
+}
+
+ScriptedInputBuffer::int_type ScriptedInputBuffer::underflow() {
+    if (gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+    }
+    if (nextLine_ >= lines_.size()) {
+        throw ScriptExhausted();
+    }
+
+    // Новая строка - новое "нажатие Enter": отсюда отсчитывается задержка до кадра
+    std::string& line = lines_[nextLine_++];
+    setg(&line[0], &line[0], &line[0] + line.size());
+    lastInputTime_ = Clock::now();
+    pendingInput_ = true;
+    return traits_type::to_int_type(*gptr());
+}
+
+// ==================== ПРОГОН СЦЕНАРИЯ ====================
+
+namespace {
+    /**
+     * @brief Буфер вывода, отбрасывающий все (для --quiet)
+     */
+    class NullBuffer : public std::streambuf {
+    protected:
+        int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+        std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+    };
+}
+
+ScriptedRun::ScriptedRun(const ScriptedRunConfig& config)
+    : config_(config) {
+}
+
+bool ScriptedRun::load() {
+    std::ifstream file(config_.scriptPath);
+    if (!file) {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (!line.empty() && line[0] == '#') {
+            continue;
+        }
+        lines_.push_back(line);
+    }
+    return !lines_.empty();
+}
+
+int ScriptedRun::run() {
+    NullBuffer nullBuffer;
+    std::streambuf* console = std::cout.rdbuf();
+    if (config_.quiet) {
+        std::cout.rdbuf(&nullBuffer);
+    }
+
+    for (int i = 0; i < config_.repeat; ++i) {
+        ScriptedInputBuffer buffer(lines_);
+        std::istream input(&buffer);
+        input.exceptions(std::ios::badbit); // ScriptExhausted из буфера доходит до нас
+        activeInput_ = &buffer;
+
+        auto start = std::chrono::steady_clock::now();
+        try {
+            Game game(input, this, config_.statsFile);
+            game.startGame();
+            completed_++;
+        }
+        catch (const ScriptExhausted&) {
+            exhausted_++;
+        }
+        totalSeconds_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        inputs_ += buffer.getConsumedLines();
+        activeInput_ = nullptr;
+    }
+
+    std::cout.rdbuf(console);
+    return completed_;
+}
+
+void ScriptedRun::onFrameRendered() {
+    frames_++;
+    if (!activeInput_ || !activeInput_->hasPendingInput()) {
+        return; // Кадр без нового ввода (например ход дилера)
+    }
+
+    auto elapsed = ScriptedInputBuffer::Clock::now() - activeInput_->getLastInputTime();
+    inputToFrame_.record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    activeInput_->clearPendingInput();
+}
+
+void ScriptedRun::printReport() const {
+    std::cout << "\n=== SCRIPTED INPUT REPORT ===\n";
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Script: " << config_.scriptPath << " (" << lines_.size() << " input lines)\n";
+    std::cout << "Runs: " << config_.repeat << " | Completed: " << completed_
+        << " | Script exhausted: " << exhausted_ << "\n";
+    std::cout << "Inputs: " << inputs_ << " | Frames: " << frames_
+        << " | Total time: " << totalSeconds_ << " s\n";
+    inputToFrame_.print(std::cout, "Input-to-frame latency", 1000.0, "us");
+}
+
+// ==================== ТОЧКА ВХОДА ====================
+
+int runScriptedGame(int argc, char* argv[]) {
+    CommandLine options(argc, argv);
+
+    ScriptedRunConfig config;
+    config.scriptPath = options.getString("file", "");
+    config.repeat = static_cast<int>(options.getInt("repeat", 1));
+    config.quiet = options.has("quiet");
+    config.statsFile = options.getString("stats-file", "");
+
+    if (config.scriptPath.empty() || config.repeat < 1) {
+        std::cerr << "Usage: --script --file <script.txt> [--repeat N] [--quiet] [--stats-file <file>]\n";
+        return 1;
+    }
+
+    ScriptedRun run(config);
+    if (!run.load()) {
+        std::cerr << "Failed to read script " << config.scriptPath << ".\n";
+        return 1;
+    }
+
+    run.run();
+    run.printReport();
+    return 0;
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include "game.h"
+#include "histogram.h"
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Сценарий закончился раньше, чем игра перестала спрашивать ввод
+ */
+class ScriptExhausted : public std::runtime_error {
+public:
+    ScriptExhausted() : std::runtime_error("input script exhausted") {}
+};
+
+/**
+ * @brief Буфер ввода, отдающий строки сценария как нажатия клавиш
+ *
+ * Каждая строка выдается целиком вместе с '\n', как после Enter в
+ * консоли; момент выдачи запоминается для измерения задержки до кадра.
+ * Когда строки кончаются, бросается ScriptExhausted (поток должен
+ * пробрасывать badbit, см. std::istream::exceptions).
+ */
+class ScriptedInputBuffer : public std::streambuf {
+public:
+    using Clock = std::chrono::steady_clock; ///< Часы меток ввода
+
+    /**
+     * @brief Конструктор
+     * @param lines Строки ввода (без '\n')
+     */
+    explicit ScriptedInputBuffer(const std::vector<std::string>& lines);
+
+    /**
+     * @brief Есть ли ввод, еще не закрытый кадром
+     */
+    bool hasPendingInput() const { return pendingInput_; }
+
+    /**
+     * @brief Момент выдачи последней строки
+     */
+    Clock::time_point getLastInputTime() const { return lastInputTime_; }
+
+    /**
+     * @brief Отметить, что последний ввод уже дошел до кадра
+     */
+    void clearPendingInput() { pendingInput_ = false; }
+
+    /**
+     * @brief Выдано строк
+     */
+    size_t getConsumedLines() const { return nextLine_; }
+
+protected:
+    int_type underflow() override;
+
+private:
+    std::vector<std::string> lines_;     ///< Строки с '\n'
+    size_t nextLine_ = 0;                ///< Следующая строка
+    Clock::time_point lastInputTime_;    ///< Момент выдачи последней строки
+    bool pendingInput_ = false;          ///< Ввод еще не дошел до кадра
+};
+
+/**
+ * @brief Параметры сценарного режима
+ */
+struct ScriptedRunConfig {
+    std::string scriptPath;  ///< Файл сценария
+    int repeat = 1;          ///< Сколько раз проиграть сценарий
+    bool quiet = false;      ///< Не выводить кадры в консоль
+    std::string statsFile;   ///< Файл статистики игры (пусто - не трогать статистику)
+};
+
+/**
+ * @brief Сценарный прогон интерактивной игры
+ *
+ * Подставляет в Game поток со сценарием и считает время от выдачи
+ * строки ввода до первого после нее отрисованного кадра стола.
+ */
+class ScriptedRun : public FrameObserver {
+public:
+    /**
+     * @brief Конструктор
+     * @param config Параметры
+     */
+    explicit ScriptedRun(const ScriptedRunConfig& config);
+
+    /**
+     * @brief Загрузить сценарий
+     * @return false если файл не открылся или пуст
+     *
+     * Формат: одна строка файла - одна строка ввода, пустая строка -
+     * просто Enter, строки с '#' в начале - комментарии
+     */
+    bool load();
+
+    /**
+     * @brief Проиграть сценарий config.repeat раз
+     * @return Число прогонов, дошедших до конца игры
+     */
+    int run();
+
+    /**
+     * @brief Вывести отчет о задержках
+     */
+    void printReport() const;
+
+    void onFrameRendered() override;
+
+private:
+    ScriptedRunConfig config_;            ///< Параметры
+    std::vector<std::string> lines_;      ///< Строки сценария
+    ScriptedInputBuffer* activeInput_ = nullptr; ///< Буфер текущего прогона
+    LatencyHistogram inputToFrame_;       ///< Задержка ввод -> кадр, нс
+    uint64_t frames_ = 0;                 ///< Отрисовано кадров
+    uint64_t inputs_ = 0;                 ///< Выдано строк ввода
+    int completed_ = 0;                   ///< Прогонов до конца игры
+    int exhausted_ = 0;                   ///< Прогонов, где сценарий кончился раньше
+    double totalSeconds_ = 0.0;           ///< Суммарное время прогонов
+};
+
+/**
+ * @brief Точка входа сценарного режима (--script)
+ * @param argc Число аргументов
+ * @param argv Аргументы: --file (сценарий), --repeat, --quiet, --stats-file
+ * @return Код завершения
+ */
+int runScriptedGame(int argc, char* argv[]);
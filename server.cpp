@@ -0,0 +1,627 @@
+#include "network.h"
+#include "server.h"
+#include "options.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+constexpr size_t IO_QUEUE_CAPACITY = 16384; ///< Емкость очереди потока ввода-вывода
+constexpr int IO_SLEEP_TIMEOUT_MS = 50;     ///< Ожидание в WSAPoll, когда работы нет
+constexpr size_t SPECTATOR_LAG_LIMIT = SendBuffer::CAPACITY / 4; ///< Хвост, после которого зритель пропускает дельты
+constexpr uint32_t SPECTATOR_ID_FLAG = 0x80000000u; ///< Старший бит идентификатора - зритель
+
+// ==================== РАССАДКА ====================
+
+void SeatAllocator::acquire(uint32_t& tableId, uint8_t& seat) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t position;
+    if (!free_.empty()) {
+        position = free_.top();
+        free_.pop();
+    }
+    else {
+        position = next_++;
+    }
+    tableId = static_cast<uint32_t>(position / seatsPerTable_ + 1);
+    seat = static_cast<uint8_t>(position % seatsPerTable_);
+    if (tableId > tableCount_.load(std::memory_order_relaxed)) {
+        tableCount_.store(tableId, std::memory_order_release);
+    }
+}
+
+void SeatAllocator::release(uint32_t tableId, uint8_t seat) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.push(static_cast<uint32_t>((tableId - 1) * seatsPerTable_ + seat));
+}
+
+// ==================== ПОТОК ВВОДА-ВЫВОДА ====================
+
+IoWorker::IoWorker(size_t index, const ServerConfig& config, const std::vector<IoChannel*>& channels,
+    const std::vector<TableShard*>& shards, SeatAllocator& seats, SOCKET listener, SOCKET spectatorListener)
+    : index_(index), config_(config), channels_(channels), shards_(shards), seats_(seats), listener_(listener),
+    spectatorListener_(spectatorListener) {
+    // Служебные сокеты: пробуждение и (для потока 0) слушатели
+    WSAPOLLFD fd;
+    fd.fd = channels_[index_]->getWakeSocket();
+    fd.events = POLLRDNORM;
+    fd.revents = 0;
+    pollFds_.push_back(fd);
+
+    if (listener_ != INVALID_SOCKET) {
+        fd.fd = listener_;
+        pollFds_.push_back(fd);
+    }
+    if (spectatorListener_ != INVALID_SOCKET) {
+        spectatorPoll_ = pollFds_.size();
+        fd.fd = spectatorListener_;
+        pollFds_.push_back(fd);
+    }
+    pollBase_ = pollFds_.size();
+}
+
+IoWorker::~IoWorker() {
+    stop();
+    for (auto& connection : connections_) {
+        if (connection) {
+            closesocket(connection->socket);
+        }
+    }
+}
+
+void IoWorker::start(int core) {
+    wakeSender_ = createWakeSender();
+    running_ = true;
+    thread_ = std::thread(&IoWorker::run, this, core);
+}
+
+void IoWorker::stop() {
+    running_ = false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    if (wakeSender_ != INVALID_SOCKET) {
+        closesocket(wakeSender_);
+        wakeSender_ = INVALID_SOCKET;
+    }
+}
+
+void IoWorker::run(int core) {
+    if (core >= 0) {
+        pinThreadToCore(static_cast<size_t>(core));
+    }
+
+    IoChannel& channel = *channels_[index_];
+    while (running_.load(std::memory_order_relaxed)) {
+        bool busy = drainChannel();
+
+        // Засыпаем только если очередь пуста - иначе опрашиваем без ожидания
+        int timeout = (!busy && channel.prepareToSleep()) ? IO_SLEEP_TIMEOUT_MS : 0;
+        int ready = WSAPoll(pollFds_.data(), static_cast<ULONG>(pollFds_.size()), timeout);
+        channel.wakeUp();
+        if (ready <= 0) {
+            continue;
+        }
+
+        if (listener_ != INVALID_SOCKET && (pollFds_[1].revents & POLLRDNORM)) {
+            acceptConnections(listener_, false);
+        }
+        if (spectatorListener_ != INVALID_SOCKET && (pollFds_[spectatorPoll_].revents & POLLRDNORM)) {
+            acceptConnections(spectatorListener_, true);
+        }
+
+        for (size_t i = pollBase_; i < pollFds_.size(); ++i) {
+            short events = pollFds_[i].revents;
+            size_t index = i - pollBase_;
+            if (events == 0 || !connections_[index]) {
+                continue;
+            }
+
+            if (events & (POLLERR | POLLHUP | POLLNVAL)) {
+                closeConnection(index);
+                continue;
+            }
+            if (events & POLLWRNORM) {
+                Connection& connection = *connections_[index];
+                if (!connection.output.flush(connection.socket)) {
+                    closeConnection(index);
+                    continue;
+                }
+                if (!connection.output.hasPending()) {
+                    pollFds_[i].events = POLLRDNORM;
+                    if (connection.awaitingSnapshot) {
+                        requestSnapshot(connection); // Зритель догнал - пора дать снимок
+                    }
+                }
+            }
+            if (events & POLLRDNORM) {
+                readConnection(index);
+            }
+        }
+    }
+}
+
+bool IoWorker::drainChannel() {
+    bool any = false;
+    IoChannel& channel = *channels_[index_];
+
+    while (channel.queue.tryPop([this](IoEvent& event) {
+        if (event.type == IoEventType::NewConnection) {
+            addConnection(event.socket, event.connectionId);
+            return;
+        }
+        if (event.type == IoEventType::Broadcast) {
+            fanOut(event);
+            return;
+        }
+        if (event.type == IoEventType::Resync) {
+            resyncSpectators(event.tableId);
+            return;
+        }
+
+        auto found = slotById_.find(event.connectionId);
+        if (found == slotById_.end() || !connections_[found->second]) {
+            return; // Подключение уже закрыто
+        }
+
+        size_t index = found->second;
+        if (event.type == IoEventType::Snapshot) {
+            Connection& connection = *connections_[index];
+            if (!connection.resyncRequested || connection.tableId != event.tableId) {
+                return; // Зритель успел переподписаться - ждет другой снимок
+            }
+            connection.awaitingSnapshot = false;
+            connection.resyncRequested = false;
+        }
+        sendToConnection(index, event.data, event.length);
+    })) {
+        any = true;
+    }
+    return any;
+}
+
+// ==================== ПОДКЛЮЧЕНИЯ ====================
+
+void IoWorker::sendToConnection(size_t index, const uint8_t* message, size_t length) {
+    Connection& connection = *connections_[index];
+    if (!connection.output.send(connection.socket, message, length)) {
+        // Клиент не читает - закрываем при следующем опросе
+        shutdown(connection.socket, SD_BOTH);
+    }
+    if (connection.output.hasPending()) {
+        pollFds_[pollBase_ + index].events = POLLRDNORM | POLLWRNORM;
+    }
+}
+
+// ==================== ЗРИТЕЛИ ====================
+
+void IoWorker::fanOut(const IoEvent& event) {
+    auto found = spectators_.find(event.tableId);
+    if (found != spectators_.end()) {
+        const SharedMessage& message = *event.shared;
+        for (size_t index : found->second) {
+            Connection& connection = *connections_[index];
+            if (connection.awaitingSnapshot) {
+                skippedDeltas_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            // Медленный зритель не должен тормозить стол и раздувать буфер:
+            // дальше он пропускает дельты и получит снимок, когда догонит
+            if (connection.output.getPending() > SPECTATOR_LAG_LIMIT) {
+                connection.awaitingSnapshot = true;
+                connection.resyncRequested = false;
+                skippedDeltas_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            sendToConnection(index, message.data, message.length);
+        }
+    }
+    event.shared->release();
+}
+
+void IoWorker::resyncSpectators(uint32_t tableId) {
+    auto found = spectators_.find(tableId);
+    if (found == spectators_.end()) {
+        return;
+    }
+
+    // Шард отбросил сообщение для этого потока: прежний запрос снимка мог
+    // пропасть вместе с ним, поэтому каждый зритель стола запрашивает заново
+    for (size_t index : found->second) {
+        Connection& connection = *connections_[index];
+        connection.awaitingSnapshot = true;
+        connection.resyncRequested = false;
+        if (!connection.output.hasPending()) {
+            requestSnapshot(connection);
+        }
+    }
+}
+
+void IoWorker::subscribe(size_t index, uint32_t tableId) {
+    Connection& connection = *connections_[index];
+    // Подписка только на стол, за который уже садился игрок: номер от
+    // клиента не должен заставлять шард создавать столы
+    if (tableId == 0 || tableId == connection.tableId || tableId > seats_.getTableCount()) {
+        return;
+    }
+    unsubscribe(index);
+
+    connection.tableId = tableId;
+    spectators_[tableId].push_back(index);
+    postToShard(connection, ShardEventType::SpectatorJoined, 0, 0);
+
+    // Первые данные зрителя - полный снимок, дальше только дельты
+    connection.awaitingSnapshot = true;
+    requestSnapshot(connection);
+}
+
+void IoWorker::unsubscribe(size_t index) {
+    Connection& connection = *connections_[index];
+    if (connection.tableId == 0) {
+        return;
+    }
+
+    auto found = spectators_.find(connection.tableId);
+    if (found != spectators_.end()) {
+        std::vector<size_t>& list = found->second;
+        for (size_t i = 0; i < list.size(); ++i) {
+            if (list[i] == index) {
+                list[i] = list.back();
+                list.pop_back();
+                break;
+            }
+        }
+        if (list.empty()) {
+            spectators_.erase(found);
+        }
+    }
+
+    postToShard(connection, ShardEventType::SpectatorLeft, 0, 0);
+    connection.tableId = 0;
+    connection.resyncRequested = false;
+}
+
+void IoWorker::requestSnapshot(Connection& connection) {
+    if (connection.resyncRequested || connection.tableId == 0) {
+        return;
+    }
+    connection.resyncRequested = true;
+    postToShard(connection, ShardEventType::SpectatorResync, 0, 0);
+}
+
+// ==================== ПОДКЛЮЧЕНИЯ ====================
+
+void IoWorker::acceptConnections(SOCKET listener, bool spectators) {
+    while (true) {
+        SOCKET client = accept(listener, nullptr, nullptr);
+        if (client == INVALID_SOCKET) {
+            return;
+        }
+
+        // Раздаем подключения потокам по кругу; зрители нумеруются отдельно,
+        // чтобы не сбивать рассадку игроков
+        uint32_t id = spectators ? (SPECTATOR_ID_FLAG | nextSpectatorId_++) : nextConnectionId_++;
+        size_t target = (id & ~SPECTATOR_ID_FLAG) % channels_.size();
+        if (target == index_) {
+            addConnection(client, id);
+            continue;
+        }
+        channels_[target]->push([&](IoEvent& event) {
+            event.type = IoEventType::NewConnection;
+            event.connectionId = id;
+            event.socket = client;
+            event.length = 0;
+        });
+        channels_[target]->notify(wakeSender_);
+    }
+}
+
+void IoWorker::addConnection(SOCKET socket, uint32_t connectionId) {
+    if (!configureSocket(socket)) {
+        closesocket(socket);
+        return;
+    }
+
+    size_t index;
+    if (!freeSlots_.empty()) {
+        index = freeSlots_.back();
+        freeSlots_.pop_back();
+    }
+    else {
+        index = connections_.size();
+        connections_.emplace_back();
+        pollFds_.push_back(WSAPOLLFD());
+    }
+
+    connections_[index].reset(new Connection());
+    Connection& connection = *connections_[index];
+    connection.socket = socket;
+    connection.id = connectionId;
+    connection.spectator = (connectionId & SPECTATOR_ID_FLAG) != 0;
+    if (!connection.spectator) {
+        seats_.acquire(connection.tableId, connection.seat);
+    }
+
+    pollFds_[pollBase_ + index].fd = socket;
+    pollFds_[pollBase_ + index].events = POLLRDNORM;
+    pollFds_[pollBase_ + index].revents = 0;
+    slotById_[connectionId] = index;
+    connectionCount_.fetch_add(1, std::memory_order_relaxed);
+
+    if (!connection.spectator) {
+        postToShard(connection, ShardEventType::SeatJoined, 0, 0);
+    }
+}
+
+void IoWorker::readConnection(size_t index) {
+    Connection& connection = *connections_[index];
+    bool open = connection.input.receive(connection.socket);
+
+    const uint8_t* message = nullptr;
+    MessageHeader header;
+    while (connection.input.nextMessage(message, header)) {
+        if (connection.spectator) {
+            SubscribeView request;
+            if (header.type == MessageType::Subscribe && request.parse(message, header.length)) {
+                subscribe(index, request.tableId());
+            }
+            continue;
+        }
+
+        DecisionView decision;
+        if (header.type != MessageType::Decision || !decision.parse(message, header.length)) {
+            continue;
+        }
+
+        // Решение принимается только для своего стола и места
+        if (decision.tableId() == connection.tableId && decision.seat() == connection.seat) {
+            postToShard(connection, ShardEventType::Decision, decision.roundId(), decision.actionCode());
+        }
+    }
+
+    if (!open || connection.input.isCorrupted()) {
+        closeConnection(index);
+    }
+}
+
+void IoWorker::closeConnection(size_t index) {
+    Connection& connection = *connections_[index];
+    closesocket(connection.socket);
+    if (connection.spectator) {
+        unsubscribe(index);
+    }
+    else {
+        // Место отдается только после SeatLeft в очереди шарда: SeatJoined
+        // следующего игрока на этом месте всегда придет позже
+        postToShard(connection, ShardEventType::SeatLeft, 0, 0);
+        seats_.release(connection.tableId, connection.seat);
+    }
+
+    slotById_.erase(connection.id);
+    connections_[index].reset();
+    pollFds_[pollBase_ + index].fd = INVALID_SOCKET;
+    pollFds_[pollBase_ + index].revents = 0;
+    freeSlots_.push_back(index);
+    connectionCount_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void IoWorker::postToShard(const Connection& connection, ShardEventType type, uint32_t roundId, uint8_t actionCode) {
+    TableShard& shard = *shards_[(connection.tableId - 1) % shards_.size()];
+    while (!shard.getInput().tryPush([&](ShardEvent& event) {
+        event.type = type;
+        event.ioThread = static_cast<uint8_t>(index_);
+        event.seat = connection.seat;
+        event.actionCode = actionCode;
+        event.connectionId = connection.id;
+        event.tableId = connection.tableId;
+        event.roundId = roundId;
+    })) {
+        if (!running_.load(std::memory_order_relaxed)) {
+            return; // Сервер останавливается
+        }
+        std::this_thread::yield(); // Шард перегружен - ждем место в очереди
+    }
+}
+
+// ==================== СЕРВЕР ====================
+
+/**
+ * @brief Конструктор сервера
+ * @param config Параметры
+ */
+TableServer::TableServer(const ServerConfig& config)
+    : config_(config) {
+    if (config_.seatsPerTable < 1) config_.seatsPerTable = 1;
+    if (config_.seatsPerTable > Table::MAX_SEATS) config_.seatsPerTable = Table::MAX_SEATS;
+    if (config_.ioThreads < 1) config_.ioThreads = 1;
+    if (config_.ioThreads > 255) config_.ioThreads = 255;
+    if (config_.seed == 0) {
+        std::random_device rd;
+        config_.seed = rd();
+    }
+
+    // По умолчанию - по шарду на каждое ядро, не занятое вводом-выводом
+    if (config_.shards == 0) {
+        size_t cores = std::thread::hardware_concurrency();
+        config_.shards = (cores > config_.ioThreads) ? cores - config_.ioThreads : 1;
+    }
+}
+
+TableServer::~TableServer() {
+    stop();
+    if (listener_ != INVALID_SOCKET) {
+        closesocket(listener_);
+    }
+    if (spectatorListener_ != INVALID_SOCKET) {
+        closesocket(spectatorListener_);
+    }
+}
+
+bool TableServer::start() {
+    listener_ = listenOn(config_.port);
+    if (listener_ == INVALID_SOCKET) {
+        return false;
+    }
+    if (config_.spectatorPort != 0) {
+        spectatorListener_ = listenOn(config_.spectatorPort);
+        if (spectatorListener_ == INVALID_SOCKET) {
+            return false;
+        }
+    }
+
+    std::vector<IoChannel*> channels;
+    for (size_t i = 0; i < config_.ioThreads; ++i) {
+        channels_.emplace_back(new IoChannel(IO_QUEUE_CAPACITY));
+        if (!channels_.back()->open()) {
+            return false;
+        }
+        channels.push_back(channels_.back().get());
+    }
+
+    seats_.reset(new SeatAllocator(config_.seatsPerTable));
+    std::vector<TableShard*> shards;
+    for (size_t i = 0; i < config_.shards; ++i) {
+        shards_.emplace_back(new TableShard(i, config_.shards, config_.seatsPerTable, config_.seed,
+            config_.actionTimeoutMs, channels));
+        shards.push_back(shards_.back().get());
+    }
+
+    for (size_t i = 0; i < config_.ioThreads; ++i) {
+        workers_.emplace_back(new IoWorker(i, config_, channels, shards, *seats_,
+            i == 0 ? listener_ : INVALID_SOCKET, i == 0 ? spectatorListener_ : INVALID_SOCKET));
+    }
+
+    // Потоки ввода-вывода на первых ядрах, шарды - на следующих
+    size_t core = 0;
+    for (auto& worker : workers_) {
+        worker->start(config_.pinThreads ? static_cast<int>(core++) : -1);
+    }
+    for (auto& shard : shards_) {
+        shard->start(config_.pinThreads ? static_cast<int>(core++) : -1);
+    }
+    return true;
+}
+
+void TableServer::stop() {
+    // Сначала шарды: пока работают потоки ввода-вывода, их очереди разбираются
+    // и отправки шардов не отбрасываются
+    for (auto& shard : shards_) {
+        shard->stop();
+    }
+    for (auto& worker : workers_) {
+        worker->stop();
+    }
+}
+
+void TableServer::run() {
+    using Clock = std::chrono::steady_clock;
+    auto startTime = Clock::now();
+    auto lastStats = startTime;
+
+    std::cout << "Table server listening on 127.0.0.1:" << config_.port;
+    if (config_.spectatorPort != 0) {
+        std::cout << ", spectators on " << config_.spectatorPort;
+    }
+    std::cout << " (" << config_.seatsPerTable << " seat(s) per table, "
+        << config_.shards << " shard(s), " << config_.ioThreads << " I/O thread(s))\n";
+
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        auto now = Clock::now();
+        double sinceStats = std::chrono::duration<double>(now - lastStats).count();
+        if (config_.statsIntervalSeconds > 0 && sinceStats >= config_.statsIntervalSeconds) {
+            printStats(sinceStats);
+            lastStats = now;
+        }
+        if (config_.durationSeconds > 0 &&
+            now - startTime >= std::chrono::seconds(config_.durationSeconds)) {
+            break;
+        }
+    }
+    stop();
+}
+
+void TableServer::printStats(double seconds) {
+    size_t connections = 0;
+    for (const auto& worker : workers_) {
+        connections += worker->getConnectionCount();
+    }
+
+    uint64_t rounds = 0;
+    uint64_t decisions = 0;
+    uint64_t timeouts = 0;
+    uint64_t deltas = 0;
+    uint64_t snapshots = 0;
+    uint64_t dropped = 0;
+    for (const auto& shard : shards_) {
+        rounds += shard->getRounds();
+        decisions += shard->getDecisions();
+        timeouts += shard->getTimeouts();
+        deltas += shard->getDeltas();
+        snapshots += shard->getSnapshots();
+        dropped += shard->getDropped();
+    }
+
+    uint64_t skipped = 0;
+    for (const auto& worker : workers_) {
+        skipped += worker->getSkippedDeltas();
+    }
+
+    std::cout << std::fixed << std::setprecision(0)
+        << "Connections: " << connections
+        << " | Rounds/s: " << (rounds - lastRounds_) / seconds
+        << " | Decisions/s: " << (decisions - lastDecisions_) / seconds
+        << " | Timeouts: " << (timeouts - lastTimeouts_);
+    if (dropped > 0) {
+        std::cout << " | Dropped: " << dropped; // Сообщения в переполненные каналы ввода-вывода
+    }
+    if (config_.spectatorPort != 0) {
+        std::cout << " | Deltas/s: " << (deltas - lastDeltas_) / seconds
+            << " | Snapshots: " << snapshots << " | Skipped: " << skipped;
+    }
+    std::cout << "\n";
+    lastDeltas_ = deltas;
+    lastRounds_ = rounds;
+    lastDecisions_ = decisions;
+    lastTimeouts_ = timeouts;
+}
+
+// ==================== ТОЧКА ВХОДА ====================
+
+int runTableServer(int argc, char* argv[]) {
+    CommandLine options(argc, argv);
+
+    ServerConfig config;
+    config.port = static_cast<uint16_t>(options.getInt("port", DEFAULT_SERVER_PORT));
+    config.spectatorPort = static_cast<uint16_t>(options.getInt("spectator-port", config.port + 1));
+    config.seatsPerTable = static_cast<size_t>(options.getInt("seats", 1));
+    config.seed = static_cast<uint32_t>(options.getInt("seed", 0));
+    config.durationSeconds = static_cast<int>(options.getInt("duration", 0));
+    config.statsIntervalSeconds = static_cast<int>(options.getInt("stats-interval", 5));
+    config.shards = static_cast<size_t>(options.getInt("shards", 0));
+    config.ioThreads = static_cast<size_t>(options.getInt("io-threads", 1));
+    config.pinThreads = !options.has("no-pin");
+    config.actionTimeoutMs = static_cast<uint32_t>(options.getInt("action-timeout", 15000));
+
+    if (!initNetwork()) {
+        std::cerr << "Failed to initialize Winsock.\n";
+        return 1;
+    }
+
+    int exitCode = 0;
+    {
+        TableServer server(config);
+        if (server.start()) {
+            server.run();
+        }
+        else {
+            std::cerr << "Failed to listen on port " << config.port << ".\n";
+            exitCode = 1;
+        }
+    }
+
+    shutdownNetwork();
+    return exitCode;
+}
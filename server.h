@@ -0,0 +1,248 @@
+#pragma once
+#include "network.h"
+#include "shard.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Параметры сервера столов
+ */
+struct ServerConfig {
+    uint16_t port = DEFAULT_SERVER_PORT; ///< Порт на localhost
+    uint16_t spectatorPort = DEFAULT_SERVER_PORT + 1; ///< Порт зрителей (0 - без зрителей)
+    size_t seatsPerTable = 1;            ///< Мест за столом (1-Table::MAX_SEATS)
+    uint32_t seed = 0;                   ///< Зерно перемешивания (0 - случайное)
+    int durationSeconds = 0;             ///< Время работы (0 - без ограничения)
+    int statsIntervalSeconds = 5;        ///< Период вывода статистики
+    size_t shards = 0;                   ///< Шардов столов (0 - по числу свободных ядер)
+    size_t ioThreads = 1;                ///< Потоков ввода-вывода
+    bool pinThreads = true;              ///< Закреплять потоки за ядрами
+    uint32_t actionTimeoutMs = 15000;    ///< Время на ход до автоматического Stand (0 - без ограничения)
+};
+
+/**
+ * @brief Рассадка игроков по столам с повторным использованием мест
+ *
+ * Игрок получает освободившееся место с наименьшим номером, а если таких
+ * нет - следующее новое. Столы заполняются по порядку, поэтому при
+ * текучке подключений число столов ограничено наибольшим числом игроков
+ * одновременно, а не числом подключений за все время. Места берут и
+ * отдают все потоки ввода-вывода, но только при подключении и
+ * отключении, поэтому хватает мьютекса.
+ */
+class SeatAllocator {
+public:
+    /**
+     * @brief Конструктор
+     * @param seatsPerTable Мест за столом
+     */
+    explicit SeatAllocator(size_t seatsPerTable) : seatsPerTable_(seatsPerTable) {}
+
+    /**
+     * @brief Занять место
+     * @param tableId [out] Стол (с 1)
+     * @param seat [out] Место за столом
+     */
+    void acquire(uint32_t& tableId, uint8_t& seat);
+
+    /**
+     * @brief Освободить место (после SeatLeft в очереди шарда)
+     */
+    void release(uint32_t tableId, uint8_t seat);
+
+    /**
+     * @brief Наибольший номер стола, за который когда-либо садились (граница подписки зрителей)
+     */
+    uint32_t getTableCount() const { return tableCount_.load(std::memory_order_acquire); }
+
+private:
+    size_t seatsPerTable_;  ///< Мест за столом
+    std::mutex mutex_;      ///< Защита свободных мест
+    std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> free_; ///< Освободившиеся места ((стол - 1) * мест + место)
+    uint32_t next_ = 0;     ///< Следующее ни разу не занятое место
+    std::atomic<uint32_t> tableCount_{0}; ///< Столов, за которые садились
+};
+
+/**
+ * @brief Поток ввода-вывода сервера
+ *
+ * Владеет своей частью подключений: читает сообщения, передает решения
+ * в шарды и отправляет исходящие сообщения из своего канала. Поток 0
+ * дополнительно принимает подключения и распределяет их по потокам.
+ *
+ * Зрители подписываются на стол сообщением Subscribe и получают дельты.
+ * Подписка на стол, за который еще не садился ни один игрок, отбрасывается.
+ * Зритель, у которого скопился неотправленный хвост, дельты пропускает
+ * (стол его не ждет), а когда догонит - получает полный снимок.
+ */
+class IoWorker {
+public:
+    /**
+     * @brief Конструктор потока ввода-вывода
+     * @param index Номер потока
+     * @param config Параметры сервера
+     * @param channels Каналы всех потоков ввода-вывода
+     * @param shards Шарды столов
+     * @param seats Рассадка игроков (общая для всех потоков)
+     * @param listener Слушающий сокет (только для потока 0, иначе INVALID_SOCKET)
+     * @param spectatorListener Слушающий сокет зрителей (только для потока 0)
+     */
+    IoWorker(size_t index, const ServerConfig& config, const std::vector<IoChannel*>& channels,
+        const std::vector<TableShard*>& shards, SeatAllocator& seats, SOCKET listener, SOCKET spectatorListener);
+
+    /**
+     * @brief Деструктор закрывает подключения потока
+     */
+    ~IoWorker();
+
+    /**
+     * @brief Запустить поток
+     * @param core Ядро для закрепления (-1 - без закрепления)
+     */
+    void start(int core);
+
+    /**
+     * @brief Остановить поток и дождаться его завершения
+     */
+    void stop();
+
+    /**
+     * @brief Число активных подключений потока
+     */
+    size_t getConnectionCount() const { return connectionCount_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Число дельт, пропущенных отстающими зрителями
+     */
+    uint64_t getSkippedDeltas() const { return skippedDeltas_.load(std::memory_order_relaxed); }
+
+private:
+    /**
+     * @brief Подключение, принадлежащее потоку
+     */
+    struct Connection {
+        SOCKET socket = INVALID_SOCKET; ///< Сокет клиента
+        uint32_t id = 0;                ///< Идентификатор подключения
+        uint32_t tableId = 0;           ///< Стол подключения
+        uint8_t seat = 0;               ///< Место за столом
+        bool spectator = false;         ///< Подключение зрителя (tableId - стол подписки, 0 - нет)
+        bool awaitingSnapshot = false;  ///< Зритель пропускает дельты до снимка
+        bool resyncRequested = false;   ///< Снимок уже запрошен у шарда
+        MessageBuffer input;            ///< Буфер приема
+        SendBuffer output;              ///< Буфер отправки
+    };
+
+    void run(int core);
+    bool drainChannel();
+    void acceptConnections(SOCKET listener, bool spectators);
+    void addConnection(SOCKET socket, uint32_t connectionId);
+    void readConnection(size_t index);
+    void closeConnection(size_t index);
+    void postToShard(const Connection& connection, ShardEventType type, uint32_t roundId, uint8_t actionCode);
+
+    /// @name Зрители
+    /// @{
+    void subscribe(size_t index, uint32_t tableId);
+    void unsubscribe(size_t index);
+    void fanOut(const IoEvent& event);
+    void resyncSpectators(uint32_t tableId);
+    void sendToConnection(size_t index, const uint8_t* message, size_t length);
+    void requestSnapshot(Connection& connection);
+    /// @}
+
+    size_t index_;                                         ///< Номер потока
+    ServerConfig config_;                                  ///< Параметры сервера
+    std::vector<IoChannel*> channels_;                     ///< Каналы всех потоков ввода-вывода
+    std::vector<TableShard*> shards_;                      ///< Шарды
+    SeatAllocator& seats_;                                 ///< Рассадка игроков
+    SOCKET listener_;                                      ///< Слушающий сокет (только поток 0)
+    SOCKET spectatorListener_;                             ///< Слушающий сокет зрителей (только поток 0)
+    size_t spectatorPoll_ = 0;                             ///< Индекс слушателя зрителей в pollFds_
+    SOCKET wakeSender_ = INVALID_SOCKET;                   ///< Сокет пробуждения других потоков
+    uint32_t nextConnectionId_ = 0;                        ///< Следующий идентификатор (только поток 0)
+    uint32_t nextSpectatorId_ = 0;                         ///< Следующий номер зрителя (только поток 0)
+
+    std::vector<std::unique_ptr<Connection>> connections_; ///< Подключения (nullptr - свободный слот)
+    std::vector<WSAPOLLFD> pollFds_;                       ///< Служебные сокеты, затем подключения
+    size_t pollBase_ = 0;                                  ///< Индекс первого подключения в pollFds_
+    std::vector<size_t> freeSlots_;                        ///< Свободные слоты подключений
+    std::unordered_map<uint32_t, size_t> slotById_;        ///< Идентификатор -> слот
+    std::unordered_map<uint32_t, std::vector<size_t>> spectators_; ///< Стол -> слоты зрителей потока
+
+    std::thread thread_;                                   ///< Поток
+    std::atomic<bool> running_{false};                     ///< Флаг работы
+    std::atomic<size_t> connectionCount_{0};               ///< Число подключений
+    std::atomic<uint64_t> skippedDeltas_{0};               ///< Дельт пропущено отстающими зрителями
+};
+
+/**
+ * @brief Сервер столов Blackjack по бинарному протоколу
+ *
+ * Столы разбиты на шарды, по одному потоку на ядро; каждый шард
+ * единолично владеет своими столами. Потоки ввода-вывода передают
+ * решения в шарды через lock-free очереди, поэтому пропускная
+ * способность растет с числом ядер, а не упирается в общую блокировку.
+ *
+ * Игрок занимает свободное место с наименьшим номером (SeatAllocator);
+ * место ушедшего игрока достается следующему. Стол начинает раунд,
+ * когда заняты все места. Зрители подключаются к отдельному порту
+ * и мест не занимают.
+ */
+class TableServer {
+public:
+    /**
+     * @brief Конструктор сервера
+     * @param config Параметры
+     */
+    explicit TableServer(const ServerConfig& config);
+
+    /**
+     * @brief Деструктор останавливает потоки и закрывает сокеты
+     */
+    ~TableServer();
+
+    /**
+     * @brief Открыть слушающий сокет и запустить потоки
+     * @return true при успехе
+     */
+    bool start();
+
+    /**
+     * @brief Выводить статистику до истечения времени работы
+     */
+    void run();
+
+private:
+    void stop();
+    void printStats(double seconds);
+
+    ServerConfig config_;                              ///< Параметры
+    SOCKET listener_ = INVALID_SOCKET;                 ///< Слушающий сокет
+    SOCKET spectatorListener_ = INVALID_SOCKET;        ///< Слушающий сокет зрителей
+    std::vector<std::unique_ptr<IoChannel>> channels_; ///< Каналы потоков ввода-вывода
+    std::vector<std::unique_ptr<TableShard>> shards_;  ///< Шарды столов
+    std::unique_ptr<SeatAllocator> seats_;             ///< Рассадка игроков
+    std::vector<std::unique_ptr<IoWorker>> workers_;   ///< Потоки ввода-вывода
+
+    uint64_t lastRounds_ = 0;                          ///< Раунды на момент прошлой статистики
+    uint64_t lastDecisions_ = 0;                       ///< Решения на момент прошлой статистики
+    uint64_t lastTimeouts_ = 0;                        ///< Таймауты на момент прошлой статистики
+    uint64_t lastDeltas_ = 0;                          ///< Дельты на момент прошлой статистики
+};
+
+/**
+ * @brief Точка входа режима сервера (--server)
+ * @param argc Число аргументов
+ * @param argv Аргументы: --port, --spectator-port (0 - без зрителей), --seats, --seed,
+ *             --duration, --stats-interval, --shards, --io-threads, --no-pin,
+ *             --action-timeout (мс)
+ * @return Код завершения
+ */
+int runTableServer(int argc, char* argv[]);
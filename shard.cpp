@@ -0,0 +1,459 @@
+#include "network.h"
+#include "shard.h"
+#include <cstring>
+
+constexpr size_t SHARD_QUEUE_CAPACITY = 65536; ///< Емкость входной очереди шарда
+constexpr size_t SHARD_BATCH_SIZE = 256;       ///< Событий за одну пачку до отправки пробуждений
+
+// ==================== КАНАЛ ВВОДА-ВЫВОДА ====================
+
+IoChannel::IoChannel(size_t capacity)
+    : queue(capacity) {
+    std::memset(&wakeAddress_, 0, sizeof(wakeAddress_));
+}
+
+IoChannel::~IoChannel() {
+    // Недоставленные дельты держат ссылки - отпускаем их
+    while (queue.tryPop([](IoEvent& event) {
+        if (event.shared) event.shared->release();
+    })) {
+    }
+    if (wakeReceiver_ != INVALID_SOCKET) {
+        closesocket(wakeReceiver_);
+    }
+}
+
+bool IoChannel::open() {
+    wakeReceiver_ = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (wakeReceiver_ == INVALID_SOCKET) {
+        return false;
+    }
+
+    // Порт выбирает система, затем узнаем его для писателей
+    wakeAddress_.sin_family = AF_INET;
+    wakeAddress_.sin_port = 0;
+    wakeAddress_.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    socklen_t length = sizeof(wakeAddress_);
+    return bind(wakeReceiver_, reinterpret_cast<sockaddr*>(&wakeAddress_), sizeof(wakeAddress_)) == 0 &&
+        getsockname(wakeReceiver_, reinterpret_cast<sockaddr*>(&wakeAddress_), &length) == 0 &&
+        configureSocket(wakeReceiver_);
+}
+
+void IoChannel::notify(SOCKET wakeSender) {
+    // Барьер в паре с prepareToSleep(): либо читатель увидит событие,
+    // либо мы увидим флаг сна
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed) && sleeping_.exchange(false)) {
+        char byte = 1;
+        sendto(wakeSender, &byte, 1, 0,
+            reinterpret_cast<const sockaddr*>(&wakeAddress_), sizeof(wakeAddress_));
+    }
+}
+
+bool IoChannel::prepareToSleep() {
+    sleeping_.store(true);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!queue.empty()) {
+        sleeping_.store(false);
+        return false;
+    }
+    return true;
+}
+
+void IoChannel::wakeUp() {
+    sleeping_.store(false);
+
+    char bytes[64];
+    while (recv(wakeReceiver_, bytes, sizeof(bytes), 0) > 0) {
+    }
+}
+
+SOCKET createWakeSender() {
+    return socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+}
+
+bool pinThreadToCore(size_t core) {
+    if (core >= sizeof(DWORD_PTR) * 8) {
+        return false;
+    }
+    return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << core) != 0;
+}
+
+// ==================== РАЗДЕЛЯЕМЫЕ СООБЩЕНИЯ ====================
+
+SharedMessage* SharedMessage::create(uint32_t references) {
+    return new SharedMessage(references);
+}
+
+void SharedMessage::release() {
+    if (references_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete this;
+    }
+}
+
+// ==================== ШАРД СТОЛОВ ====================
+
+TableShard::TableShard(size_t index, size_t shardCount, size_t seatsPerTable, uint32_t seed,
+    uint32_t actionTimeoutMs, const std::vector<IoChannel*>& ioChannels)
+    : index_(index), shardCount_(shardCount), seatsPerTable_(seatsPerTable), seed_(seed),
+    actionTimeoutMs_(actionTimeoutMs), epoch_(std::chrono::steady_clock::now()),
+    input_(SHARD_QUEUE_CAPACITY), io_(ioChannels), ioPending_(ioChannels.size(), false) {
+}
+
+TableShard::~TableShard() {
+    stop();
+}
+
+void TableShard::start(int core) {
+    wakeSender_ = createWakeSender();
+    running_ = true;
+    thread_ = std::thread(&TableShard::run, this, core);
+}
+
+void TableShard::stop() {
+    running_ = false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    if (wakeSender_ != INVALID_SOCKET) {
+        closesocket(wakeSender_);
+        wakeSender_ = INVALID_SOCKET;
+    }
+}
+
+void TableShard::run(int core) {
+    if (core >= 0) {
+        pinThreadToCore(static_cast<size_t>(core));
+    }
+
+    while (running_.load(std::memory_order_relaxed)) {
+        size_t processed = 0;
+        while (processed < SHARD_BATCH_SIZE &&
+            input_.tryPop([this](ShardEvent& event) { handleEvent(event); })) {
+            ++processed;
+        }
+        expireTimers();
+        sendResyncs();
+
+        // Будим потоки ввода-вывода один раз на пачку, а не на сообщение
+        for (size_t i = 0; i < io_.size(); ++i) {
+            if (ioPending_[i]) {
+                io_[i]->notify(wakeSender_);
+                ioPending_[i] = false;
+            }
+        }
+
+        if (processed == 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+TableShard::TableSlot& TableShard::getTable(uint32_t tableId) {
+    size_t local = (tableId - 1) / shardCount_;
+    while (tables_.size() <= local) {
+        uint32_t id = static_cast<uint32_t>(tables_.size() * shardCount_ + index_ + 1);
+        tables_.emplace_back(new TableSlot(id, seatsPerTable_, seed_ + id, io_.size()));
+    }
+    return *tables_[local];
+}
+
+TableShard::TableSlot* TableShard::findTable(uint32_t tableId) {
+    if (tableId == 0 || (tableId - 1) % shardCount_ != index_) {
+        return nullptr;
+    }
+    size_t local = (tableId - 1) / shardCount_;
+    return local < tables_.size() ? tables_[local].get() : nullptr;
+}
+
+void TableShard::handleEvent(const ShardEvent& event) {
+    // Столы создает только игрок, садящийся за стол; остальные события
+    // для несозданного стола (например, подписка зрителя) отбрасываются
+    TableSlot* found = event.type == ShardEventType::SeatJoined ? &getTable(event.tableId) : findTable(event.tableId);
+    if (found == nullptr) {
+        return;
+    }
+    TableSlot& slot = *found;
+    if (event.type >= ShardEventType::SpectatorJoined) {
+        handleSpectator(slot, event);
+        return;
+    }
+    if (event.seat >= slot.links.size()) {
+        return;
+    }
+    SeatLink& link = slot.links[event.seat];
+
+    switch (event.type) {
+    case ShardEventType::SeatJoined:
+        // Место освобождается после SeatLeft, так что занятым оно быть не должно
+        if (!link.connected) {
+            slot.occupied++;
+        }
+        link.connectionId = event.connectionId;
+        link.ioThread = event.ioThread;
+        link.connected = true;
+        if (slot.occupied == seatsPerTable_ && slot.table.isRoundOver()) {
+            startRound(slot);
+        }
+        break;
+
+    case ShardEventType::SeatLeft:
+        if (!link.connected || link.connectionId != event.connectionId) {
+            return;
+        }
+        link.connected = false;
+        slot.occupied--;
+        if (!slot.table.isRoundOver()) {
+            continueRound(slot); // Доигрываем за ушедшего игрока
+        }
+        break;
+
+    case ShardEventType::Decision:
+        if (!link.connected || link.connectionId != event.connectionId ||
+            event.roundId != slot.table.getRoundId()) {
+            return;
+        }
+        if (slot.table.applyDecision(event.seat, event.actionCode)) {
+            decisions_.store(decisions_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            continueRound(slot);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+void TableShard::handleSpectator(TableSlot& slot, const ShardEvent& event) {
+    if (event.ioThread >= slot.spectators.size()) {
+        return;
+    }
+
+    switch (event.type) {
+    case ShardEventType::SpectatorJoined:
+        slot.spectators[event.ioThread]++;
+        slot.spectatorCount++;
+        break;
+
+    case ShardEventType::SpectatorLeft:
+        if (slot.spectators[event.ioThread] > 0) {
+            slot.spectators[event.ioThread]--;
+            slot.spectatorCount--;
+        }
+        break;
+
+    case ShardEventType::SpectatorResync: {
+        // Снимок кодируется только по запросу: новому или отставшему зрителю.
+        // Он встает в ту же очередь, что и дельты, поэтому следующая дельта
+        // гарантированно продолжает именно его
+        size_t length = slot.table.encodeState(scratch_, sizeof(scratch_));
+        if (length == 0) {
+            return;
+        }
+        if (!tryPushIo(event.ioThread, [&](IoEvent& out) {
+            out.type = IoEventType::Snapshot;
+            out.connectionId = event.connectionId;
+            out.tableId = event.tableId;
+            out.length = static_cast<uint16_t>(length);
+            std::memcpy(out.data, scratch_, length);
+        })) {
+            markLost(slot, event.ioThread); // Пометка Resync снимет с зрителя запрос и даст запросить снова
+            return;
+        }
+        snapshots_.store(snapshots_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+// ==================== ИГРОВОЙ ПРОЦЕСС ====================
+
+void TableShard::startRound(TableSlot& slot) {
+    slot.table.startRound();
+    publishDelta(slot);
+
+    size_t length = slot.table.encodeState(scratch_, sizeof(scratch_));
+    broadcast(slot, scratch_, length);
+
+    requestAction(slot);
+}
+
+void TableShard::continueRound(TableSlot& slot) {
+    Table& table = slot.table;
+
+    // Места без игрока автоматически останавливаются
+    while (!table.isRoundOver() && !slot.links[table.getActiveSeat()].connected) {
+        table.applyDecision(table.getActiveSeat(), static_cast<uint8_t>(PlayerAction::Stand));
+    }
+    publishDelta(slot);
+
+    size_t length = table.encodeState(scratch_, sizeof(scratch_));
+    broadcast(slot, scratch_, length);
+
+    if (!table.isRoundOver()) {
+        requestAction(slot);
+        return;
+    }
+
+    timers_.cancel(slot.actionTimer);
+    slot.actionTimer = NO_TIMER;
+
+    length = table.encodeResult(scratch_, sizeof(scratch_));
+    broadcast(slot, scratch_, length);
+    rounds_.store(rounds_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    if (slot.occupied == seatsPerTable_) {
+        startRound(slot);
+    }
+}
+
+void TableShard::requestAction(TableSlot& slot) {
+    const Table& table = slot.table;
+    size_t length = table.encodeActionRequest(scratch_, sizeof(scratch_));
+    sendTo(slot.links[table.getActiveSeat()], scratch_, length);
+
+    // Один таймер на стол: ходит всегда только одно место
+    timers_.cancel(slot.actionTimer);
+    slot.actionTimer = NO_TIMER;
+    if (actionTimeoutMs_ > 0) {
+        uint64_t payload = (static_cast<uint64_t>(table.getId()) << 32) |
+            ((static_cast<uint64_t>(table.getRoundId()) & 0xFFFFFF) << 8) | table.getActiveSeat();
+        slot.actionTimer = timers_.schedule(currentTick() + actionTimeoutMs_, payload);
+    }
+}
+
+void TableShard::expireTimers() {
+    if (timers_.size() == 0) {
+        return;
+    }
+
+    expired_.clear();
+    timers_.advance(currentTick(), expired_);
+    for (uint64_t payload : expired_) {
+        TableSlot* found = findTable(static_cast<uint32_t>(payload >> 32));
+        if (found == nullptr) {
+            continue;
+        }
+        TableSlot& slot = *found;
+        Table& table = slot.table;
+        uint8_t seat = static_cast<uint8_t>(payload & 0xFF);
+        uint32_t round = static_cast<uint32_t>((payload >> 8) & 0xFFFFFF);
+
+        // Таймер мог устареть, если ход уже сделан в том же тике
+        if (table.isRoundOver() || table.getActiveSeat() != seat ||
+            (table.getRoundId() & 0xFFFFFF) != round) {
+            continue;
+        }
+
+        // Игрок не успел - автоматический Stand, как для перебора в Player::getPlayerAction()
+        slot.actionTimer = NO_TIMER;
+        table.applyDecision(seat, static_cast<uint8_t>(PlayerAction::Stand));
+        timeouts_.store(timeouts_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        continueRound(slot);
+    }
+}
+
+uint64_t TableShard::currentTick() const {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - epoch_).count());
+}
+
+void TableShard::publishDelta(TableSlot& slot) {
+    Table& table = slot.table;
+    const std::vector<TableEvent>& events = table.getEvents();
+    if (events.empty()) {
+        return;
+    }
+    if (slot.spectatorCount == 0) {
+        table.clearEvents(); // Никто не смотрит - дельты не кодируем
+        return;
+    }
+
+    uint32_t receivers = 0;
+    for (uint32_t count : slot.spectators) {
+        if (count > 0) ++receivers;
+    }
+
+    // Длинный журнал (раздача за большим столом) режется на несколько дельт
+    for (size_t first = 0; first < events.size(); first += PROTOCOL_MAX_DELTA_EVENTS) {
+        size_t count = events.size() - first;
+        if (count > PROTOCOL_MAX_DELTA_EVENTS) count = PROTOCOL_MAX_DELTA_EVENTS;
+
+        SharedMessage* message = SharedMessage::create(receivers);
+        message->length = static_cast<uint16_t>(encodeTableDelta(message->data, sizeof(message->data),
+            table.getId(), table.getRoundId(), slot.deltaSequence++, events.data() + first, count));
+
+        for (size_t i = 0; i < slot.spectators.size(); ++i) {
+            if (slot.spectators[i] == 0) {
+                continue;
+            }
+            // После пропуска дельты идут только следом за пометкой Resync
+            if (slot.lost[i] || !tryPushIo(i, [&](IoEvent& out) {
+                out.type = IoEventType::Broadcast;
+                out.tableId = table.getId();
+                out.shared = message;
+                out.length = 0;
+            })) {
+                markLost(slot, i);
+                message->release();
+            }
+        }
+        deltas_.store(deltas_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    table.clearEvents();
+}
+
+void TableShard::broadcast(const TableSlot& slot, const uint8_t* message, size_t length) {
+    for (const auto& link : slot.links) {
+        sendTo(link, message, length);
+    }
+}
+
+void TableShard::sendTo(const SeatLink& link, const uint8_t* message, size_t length) {
+    if (!link.connected || length == 0 || length > IO_MESSAGE_CAPACITY) {
+        return;
+    }
+
+    // Игроку хватит следующего состояния стола: пропуск только считается
+    if (!tryPushIo(link.ioThread, [&](IoEvent& event) {
+        event.type = IoEventType::Send;
+        event.connectionId = link.connectionId;
+        event.length = static_cast<uint16_t>(length);
+        std::memcpy(event.data, message, length);
+    })) {
+        dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+}
+
+// ==================== ПЕРЕПОЛНЕНИЕ КАНАЛОВ ====================
+
+void TableShard::markLost(TableSlot& slot, size_t thread) {
+    dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (!slot.lost[thread]) {
+        slot.lost[thread] = 1;
+        resyncs_.emplace_back(slot.table.getId(), static_cast<uint8_t>(thread));
+    }
+}
+
+void TableShard::sendResyncs() {
+    size_t kept = 0;
+    for (const auto& entry : resyncs_) {
+        TableSlot& slot = *findTable(entry.first); // Пометку ставит существующий стол, а столы не удаляются
+        bool sent = slot.spectators[entry.second] == 0 || tryPushIo(entry.second, [&](IoEvent& out) {
+            out.type = IoEventType::Resync;
+            out.tableId = entry.first;
+            out.length = 0;
+        });
+        if (sent) {
+            slot.lost[entry.second] = 0;
+        }
+        else {
+            resyncs_[kept++] = entry;
+        }
+    }
+    resyncs_.resize(kept);
+}
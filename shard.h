@@ -0,0 +1,355 @@
+#pragma once
+#include "network.h"
+#include "mpscqueue.h"
+#include "table.h"
+#include "timerwheel.h"
+#include <chrono>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+constexpr size_t IO_MESSAGE_CAPACITY = 256; ///< Максимальный размер исходящего сообщения в очереди
+
+/**
+ * @brief Неизменяемое сообщение, разделяемое потоками ввода-вывода
+ *
+ * Шард кодирует дельту один раз, и все потоки ввода-вывода отправляют
+ * один и тот же буфер своим зрителям. Каждый поток держит одну ссылку
+ * и отпускает ее после рассылки; последний освобождает память.
+ */
+class SharedMessage {
+public:
+    /**
+     * @brief Создать сообщение с заданным числом ссылок
+     * @param references Число потоков-получателей
+     */
+    static SharedMessage* create(uint32_t references);
+
+    /**
+     * @brief Отпустить ссылку (последняя удаляет сообщение)
+     */
+    void release();
+
+    uint8_t data[PROTOCOL_MAX_MESSAGE_SIZE]; ///< Закодированное сообщение
+    uint16_t length = 0;                     ///< Длина сообщения
+
+private:
+    explicit SharedMessage(uint32_t references) : references_(references) {}
+
+    std::atomic<uint32_t> references_; ///< Число ссылок
+};
+
+// ==================== СОБЫТИЯ МЕЖДУ ПОТОКАМИ ====================
+
+/**
+ * @brief Типы событий, поступающих в шард от потоков ввода-вывода
+ */
+enum class ShardEventType : uint8_t {
+    SeatJoined, ///< Подключение заняло место
+    SeatLeft,   ///< Подключение закрыто
+    Decision,         ///< Решение игрока
+    SpectatorJoined,  ///< Зритель подписался на стол
+    SpectatorLeft,    ///< Зритель отписался или отключился
+    SpectatorResync   ///< Зрителю нужен полный снимок стола
+};
+
+/**
+ * @brief Событие для шарда (маленькое, копируется в очередь целиком)
+ */
+struct ShardEvent {
+    ShardEventType type = ShardEventType::Decision; ///< Тип события
+    uint8_t ioThread = 0;       ///< Поток ввода-вывода, владеющий подключением
+    uint8_t seat = 0;           ///< Номер места
+    uint8_t actionCode = 0;     ///< Код действия (для Decision)
+    uint32_t connectionId = 0;  ///< Идентификатор подключения
+    uint32_t tableId = 0;       ///< Идентификатор стола
+    uint32_t roundId = 0;       ///< Номер раунда (для Decision)
+};
+
+/**
+ * @brief Типы событий для потока ввода-вывода
+ */
+enum class IoEventType : uint8_t {
+    NewConnection, ///< Передача принятого сокета
+    Send,          ///< Отправка сообщения подключению
+    Broadcast,     ///< Рассылка разделяемой дельты зрителям стола
+    Snapshot,      ///< Полный снимок стола для отстающего зрителя
+    Resync         ///< Зрители стола на потоке пропустили сообщения - всем нужен новый снимок
+};
+
+/**
+ * @brief Событие для потока ввода-вывода
+ *
+ * Сообщение протокола кодируется прямо в поле data ячейки очереди
+ */
+struct IoEvent {
+    IoEventType type = IoEventType::Send;  ///< Тип события
+    uint16_t length = 0;                   ///< Длина сообщения
+    uint32_t connectionId = 0;             ///< Идентификатор подключения
+    uint32_t tableId = 0;                  ///< Стол (для Broadcast, Snapshot и Resync)
+    SOCKET socket = INVALID_SOCKET;        ///< Сокет (для NewConnection)
+    SharedMessage* shared = nullptr;       ///< Разделяемая дельта (для Broadcast)
+    uint8_t data[IO_MESSAGE_CAPACITY];     ///< Закодированное сообщение
+};
+
+/**
+ * @brief Входной канал потока ввода-вывода
+ *
+ * Очередь событий плюс UDP-сокет пробуждения: поток ввода-вывода спит
+ * в WSAPoll, и писатель будит его одним датаграммным байтом, только
+ * если поток действительно объявил что засыпает.
+ */
+class IoChannel {
+public:
+    /**
+     * @brief Конструктор канала
+     * @param capacity Емкость очереди событий
+     */
+    explicit IoChannel(size_t capacity);
+
+    /**
+     * @brief Деструктор закрывает сокет пробуждения
+     */
+    ~IoChannel();
+
+    /**
+     * @brief Создать сокет пробуждения на 127.0.0.1
+     * @return true при успехе
+     */
+    bool open();
+
+    /**
+     * @brief Поставить событие в очередь, ожидая место при переполнении
+     * @param fill Функция fill(IoEvent&)
+     *
+     * Только для событий потоков ввода-вывода друг другу: шард в канал
+     * не ждет (TableShard::tryPushIo()), иначе поток ввода-вывода, ждущий
+     * места во входной очереди шарда, и шард ждали бы друг друга
+     */
+    template <typename Fill>
+    void push(Fill&& fill) {
+        while (!queue.tryPush(fill)) {
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * @brief Разбудить поток ввода-вывода если он спит
+     * @param wakeSender UDP-сокет вызывающего потока
+     */
+    void notify(SOCKET wakeSender);
+
+    /**
+     * @brief Объявить о засыпании (только поток-читатель)
+     * @return false если в очереди уже есть события и спать нельзя
+     */
+    bool prepareToSleep();
+
+    /**
+     * @brief Отметить пробуждение и вычитать байты пробуждения
+     */
+    void wakeUp();
+
+    /**
+     * @brief Сокет пробуждения для набора WSAPoll
+     */
+    SOCKET getWakeSocket() const { return wakeReceiver_; }
+
+    MpscQueue<IoEvent> queue; ///< Очередь событий
+
+private:
+    std::atomic<bool> sleeping_{false};        ///< Поток спит в WSAPoll
+    SOCKET wakeReceiver_ = INVALID_SOCKET;     ///< Принимающий UDP-сокет
+    sockaddr_in wakeAddress_;                  ///< Адрес сокета пробуждения
+};
+
+/**
+ * @brief Создать UDP-сокет для отправки байтов пробуждения
+ */
+SOCKET createWakeSender();
+
+/**
+ * @brief Закрепить текущий поток за ядром
+ * @param core Номер ядра
+ * @return true при успехе
+ */
+bool pinThreadToCore(size_t core);
+
+// ==================== ШАРД СТОЛОВ ====================
+
+/**
+ * @brief Шард: поток, единолично владеющий своими столами
+ *
+ * Колоды, игроки и дилеры шарда не видны другим потокам. Решения
+ * приходят через lock-free очередь, исходящие сообщения уходят в
+ * очереди потоков ввода-вывода. На горячем пути нет мьютексов и общего
+ * изменяемого состояния - только счетчики статистики, которые пишет
+ * один шард.
+ *
+ * Зрителям стола шард рассылает не полные снимки, а дельты из журнала
+ * событий стола: каждая кодируется один раз в SharedMessage и уходит
+ * только в те потоки ввода-вывода, где есть зрители этого стола.
+ *
+ * Шард никогда не ждет места в канале ввода-вывода: сообщение в
+ * переполненный канал отбрасывается (getDropped()). Игрок получит
+ * следующее состояние стола (а ход за него сделает таймер), зрители
+ * стола на этом потоке - пометку Resync, как только в канале будет
+ * место, и по ней новый снимок; до пометки их дельты не отправляются.
+ */
+class TableShard {
+public:
+    /**
+     * @brief Конструктор шарда
+     * @param index Номер шарда
+     * @param shardCount Число шардов (стол N принадлежит шарду (N-1) % shardCount)
+     * @param seatsPerTable Мест за столом
+     * @param seed Базовое зерно перемешивания
+     * @param actionTimeoutMs Время на ход, после которого место играет Stand (0 - без ограничения)
+     * @param ioChannels Каналы потоков ввода-вывода
+     */
+    TableShard(size_t index, size_t shardCount, size_t seatsPerTable, uint32_t seed,
+        uint32_t actionTimeoutMs, const std::vector<IoChannel*>& ioChannels);
+
+    /**
+     * @brief Деструктор останавливает поток
+     */
+    ~TableShard();
+
+    /**
+     * @brief Запустить поток шарда
+     * @param core Ядро для закрепления (-1 - без закрепления)
+     */
+    void start(int core);
+
+    /**
+     * @brief Остановить поток и дождаться его завершения
+     */
+    void stop();
+
+    /**
+     * @brief Входная очередь событий (пишут потоки ввода-вывода)
+     */
+    MpscQueue<ShardEvent>& getInput() { return input_; }
+
+    /// @name Статистика (читается другими потоками)
+    /// @{
+    uint64_t getRounds() const { return rounds_.load(std::memory_order_relaxed); }
+    uint64_t getDecisions() const { return decisions_.load(std::memory_order_relaxed); }
+    uint64_t getTimeouts() const { return timeouts_.load(std::memory_order_relaxed); }
+    uint64_t getDeltas() const { return deltas_.load(std::memory_order_relaxed); }
+    uint64_t getSnapshots() const { return snapshots_.load(std::memory_order_relaxed); }
+    uint64_t getDropped() const { return dropped_.load(std::memory_order_relaxed); }
+    /// @}
+
+private:
+    /**
+     * @brief Связь места с подключением
+     */
+    struct SeatLink {
+        uint32_t connectionId = 0; ///< Идентификатор подключения
+        uint8_t ioThread = 0;      ///< Поток ввода-вывода подключения
+        bool connected = false;    ///< Место занято
+    };
+
+    /**
+     * @brief Стол шарда
+     */
+    struct TableSlot {
+        TableSlot(uint32_t id, size_t seats, uint32_t seed, size_t ioThreads)
+            : table(id, seats, seed), links(seats), spectators(ioThreads, 0), lost(ioThreads, 0) {
+        }
+
+        Table table;                 ///< Состояние стола
+        std::vector<SeatLink> links; ///< Подключения по местам
+        size_t occupied = 0;         ///< Занято мест
+        TimerId actionTimer = NO_TIMER; ///< Таймер хода активного места
+        std::vector<uint32_t> spectators; ///< Зрителей стола на каждом потоке ввода-вывода
+        std::vector<uint8_t> lost;   ///< Зрители на потоке пропустили сообщение и ждут пометки Resync
+        size_t spectatorCount = 0;   ///< Всего зрителей стола
+        uint32_t deltaSequence = 0;  ///< Номер следующей дельты
+    };
+
+    void run(int core);
+    void handleEvent(const ShardEvent& event);
+    void handleSpectator(TableSlot& slot, const ShardEvent& event);
+    TableSlot& getTable(uint32_t tableId);  ///< Стол с созданием (только для SeatJoined)
+    TableSlot* findTable(uint32_t tableId); ///< Уже созданный стол (nullptr - нет)
+    void startRound(TableSlot& slot);
+    void continueRound(TableSlot& slot);
+
+    /**
+     * @brief Запросить ход активного места и взвести таймер хода
+     */
+    void requestAction(TableSlot& slot);
+
+    /**
+     * @brief Обработать истекшие таймеры хода (автоматический Stand)
+     */
+    void expireTimers();
+
+    /**
+     * @brief Разослать зрителям накопленные события стола и очистить журнал
+     */
+    void publishDelta(TableSlot& slot);
+
+    /**
+     * @brief Поставить событие в канал потока ввода-вывода без ожидания
+     * @param thread Поток ввода-вывода
+     * @param fill Функция fill(IoEvent&)
+     * @return false если канал переполнен
+     */
+    template <typename Fill>
+    bool tryPushIo(size_t thread, Fill&& fill) {
+        // Ячейки очереди переиспользуются: чужая дельта не должна остаться в поле shared
+        if (!io_[thread]->queue.tryPush([&](IoEvent& out) { out.shared = nullptr; fill(out); })) {
+            return false;
+        }
+        ioPending_[thread] = true;
+        return true;
+    }
+
+    /**
+     * @brief Отметить, что зрители стола на потоке пропустили сообщение
+     */
+    void markLost(TableSlot& slot, size_t thread);
+
+    /**
+     * @brief Отправить отложенные пометки Resync, для которых появилось место
+     */
+    void sendResyncs();
+
+    /**
+     * @brief Текущее время шарда в миллисекундах (тик колеса таймеров)
+     */
+    uint64_t currentTick() const;
+    void broadcast(const TableSlot& slot, const uint8_t* message, size_t length);
+    void sendTo(const SeatLink& link, const uint8_t* message, size_t length);
+
+    size_t index_;                                    ///< Номер шарда
+    size_t shardCount_;                               ///< Число шардов
+    size_t seatsPerTable_;                            ///< Мест за столом
+    uint32_t seed_;                                   ///< Базовое зерно
+    uint32_t actionTimeoutMs_;                        ///< Время на ход, мс
+    std::chrono::steady_clock::time_point epoch_;     ///< Начало отсчета тиков
+    TimerWheel timers_;                               ///< Таймеры ходов всех столов шарда
+    std::vector<uint64_t> expired_;                   ///< Сработавшие таймеры (буфер переиспользуется)
+    MpscQueue<ShardEvent> input_;                     ///< Входная очередь
+    std::vector<IoChannel*> io_;                      ///< Каналы потоков ввода-вывода
+    std::vector<bool> ioPending_;                     ///< Каналы, куда отправлены события в этой пачке
+    std::vector<std::pair<uint32_t, uint8_t>> resyncs_; ///< Стол и поток, ждущие пометки Resync
+    std::vector<std::unique_ptr<TableSlot>> tables_;  ///< Столы шарда (индекс (id-1)/shardCount)
+    SOCKET wakeSender_ = INVALID_SOCKET;              ///< Сокет пробуждения потоков ввода-вывода
+    std::thread thread_;                              ///< Поток шарда
+    std::atomic<bool> running_{false};                ///< Флаг работы потока
+    uint8_t scratch_[IO_MESSAGE_CAPACITY];            ///< Буфер кодирования рассылок
+
+    alignas(64) std::atomic<uint64_t> rounds_{0};     ///< Сыграно раундов
+    std::atomic<uint64_t> decisions_{0};              ///< Принято решений
+    std::atomic<uint64_t> timeouts_{0};               ///< Автоматических Stand по таймауту
+    std::atomic<uint64_t> deltas_{0};                 ///< Закодировано дельт для зрителей
+    std::atomic<uint64_t> snapshots_{0};              ///< Отправлено снимков зрителям
+    std::atomic<uint64_t> dropped_{0};                ///< Отброшено сообщений в переполненные каналы
+};
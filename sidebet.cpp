@@ -0,0 +1,125 @@
+#include "sidebet.h"
+#include <cstring>
+
+namespace {
+    constexpr size_t STRAIGHTS = 12; ///< Последовательностей: A23, 234, ..., QKA
+
+    /**
+     * @brief Достоинства стрита по номеру (индексы достоинств: 0 - двойка, 12 - туз)
+     */
+    void straightRanks(size_t straight, size_t* ranks) {
+        ranks[0] = straight == 0 ? 12 : straight - 1; // A23: туз как единица
+        ranks[1] = straight;
+        ranks[2] = straight + 1;
+    }
+
+    int64_t pairs(int64_t x) { return x * (x - 1); }
+    int64_t triples(int64_t x) { return x * (x - 1) * (x - 2); }
+
+    /**
+     * @brief Изменить слагаемое суммы f(x) при x -> x + delta
+     */
+    template <typename F>
+    void shift(int64_t& sum, int64_t before, int delta, F f) {
+        sum += f(before + delta) - f(before);
+    }
+}
+
+void SideBetOdds::clear() {
+    *this = SideBetOdds();
+}
+
+size_t SideBetOdds::getRemaining(Rank rank, Suit suit) const {
+    return cards_[static_cast<size_t>(rank) - static_cast<size_t>(Rank::Two)][static_cast<size_t>(suit)];
+}
+
+void SideBetOdds::update(const Card& card, int delta) {
+    size_t rank = static_cast<size_t>(card.getRank()) - static_cast<size_t>(Rank::Two);
+    size_t suit = static_cast<size_t>(card.getSuit());
+    size_t color = (card.getSuit() == Suit::Hearts || card.getSuit() == Suit::Diamonds) ? 0 : 1;
+
+    // Стриты с этим достоинством (не больше трех): остальные два достоинства не меняются
+    size_t containing[3];
+    size_t count = 0;
+    if (rank == 12) {
+        containing[count++] = 0;  // A23
+        containing[count++] = 11; // QKA
+    }
+    else {
+        if (rank >= 1) containing[count++] = rank - 1;
+        containing[count++] = rank;
+        if (rank + 1 < STRAIGHTS) containing[count++] = rank + 1;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        size_t members[3];
+        straightRanks(containing[i], members);
+        size_t others[2];
+        size_t used = 0;
+        for (size_t member : members) {
+            if (member != rank) others[used++] = member;
+        }
+        straights_ += delta * static_cast<int64_t>(ranks_[others[0]]) * ranks_[others[1]];
+        straightFlushes_ += delta * static_cast<int64_t>(cards_[others[0]][suit]) * cards_[others[1]][suit];
+    }
+
+    shift(sameCardPairs_, cards_[rank][suit], delta, pairs);
+    shift(sameCardTriples_, cards_[rank][suit], delta, triples);
+    shift(colorPairs_, colors_[rank][color], delta, pairs);
+    shift(rankPairs_, ranks_[rank], delta, pairs);
+    shift(rankTriples_, ranks_[rank], delta, triples);
+    shift(suitTriples_, suits_[suit], delta, triples);
+
+    cards_[rank][suit] = static_cast<uint16_t>(cards_[rank][suit] + delta);
+    colors_[rank][color] = static_cast<uint16_t>(colors_[rank][color] + delta);
+    ranks_[rank] = static_cast<uint16_t>(ranks_[rank] + delta);
+    suits_[suit] = static_cast<uint16_t>(suits_[suit] + delta);
+    total_ = static_cast<uint32_t>(total_ + delta);
+}
+
+PerfectPairsOdds SideBetOdds::perfectPairs(const PerfectPairsPaytable& paytable) const {
+    PerfectPairsOdds odds;
+    if (total_ < 2) {
+        return odds;
+    }
+
+    // Упорядоченные пары различных карт: одинаковые карты входят в пары цвета, те - в пары достоинства
+    double orderedPairs = static_cast<double>(pairs(total_));
+    odds.perfect = sameCardPairs_ / orderedPairs;
+    odds.colored = (colorPairs_ - sameCardPairs_) / orderedPairs;
+    odds.mixed = (rankPairs_ - colorPairs_) / orderedPairs;
+
+    double win = odds.perfect * paytable.perfect + odds.colored * paytable.colored + odds.mixed * paytable.mixed;
+    double lose = 1.0 - odds.perfect - odds.colored - odds.mixed;
+    odds.houseEdge = lose - win;
+    return odds;
+}
+
+TwentyOnePlusThreeOdds SideBetOdds::twentyOnePlusThree(const TwentyOnePlusThreePaytable& paytable) const {
+    TwentyOnePlusThreeOdds odds;
+    if (total_ < 3) {
+        return odds;
+    }
+
+    // Суммы троек упорядоченные (x(x-1)(x-2) = 6 * C(x, 3)), стриты - неупорядоченные
+    double orderedTriples = static_cast<double>(triples(total_));
+    double unorderedTriples = orderedTriples / 6.0;
+    odds.suitedTrips = sameCardTriples_ / orderedTriples;
+    odds.straightFlush = straightFlushes_ / unorderedTriples;
+    odds.trips = (rankTriples_ - sameCardTriples_) / orderedTriples;
+    odds.straight = (straights_ - straightFlushes_) / unorderedTriples;
+    odds.flush = (suitTriples_ - sameCardTriples_ - 6 * straightFlushes_) / orderedTriples;
+
+    double win = odds.suitedTrips * paytable.suitedTrips + odds.straightFlush * paytable.straightFlush +
+        odds.trips * paytable.trips + odds.straight * paytable.straight + odds.flush * paytable.flush;
+    double lose = 1.0 - odds.suitedTrips - odds.straightFlush - odds.trips - odds.straight - odds.flush;
+    odds.houseEdge = lose - win;
+    return odds;
+}
+
+bool SideBetOdds::operator==(const SideBetOdds& other) const {
+    return std::memcmp(cards_, other.cards_, sizeof(cards_)) == 0 &&
+        sameCardPairs_ == other.sameCardPairs_ && colorPairs_ == other.colorPairs_ &&
+        rankPairs_ == other.rankPairs_ && sameCardTriples_ == other.sameCardTriples_ &&
+        rankTriples_ == other.rankTriples_ && suitTriples_ == other.suitTriples_ &&
+        straights_ == other.straights_ && straightFlushes_ == other.straightFlushes_;
+}
@@ -0,0 +1,135 @@
+#pragma once
+#include "card.h"
+#include <cstddef>
+#include <cstdint>
+
+// ==================== ТАБЛИЦЫ ВЫПЛАТ ====================
+
+/**
+ * @brief Выплаты Perfect Pairs (первые две карты игрока), к 1
+ */
+struct PerfectPairsPaytable {
+    int perfect = 25; ///< Одинаковые достоинство и масть
+    int colored = 12; ///< Одно достоинство, разные масти одного цвета
+    int mixed = 6;    ///< Одно достоинство, масти разного цвета
+};
+
+/**
+ * @brief Выплаты 21+3 (две карты игрока и открытая карта дилера), к 1
+ */
+struct TwentyOnePlusThreePaytable {
+    int suitedTrips = 100;  ///< Три одинаковые карты
+    int straightFlush = 40; ///< Стрит одной масти
+    int trips = 30;         ///< Три одного достоинства
+    int straight = 10;      ///< Три достоинства подряд (туз - A23 и QKA)
+    int flush = 5;          ///< Три одной масти
+};
+
+/**
+ * @brief Вероятности исходов Perfect Pairs и преимущество казино
+ */
+struct PerfectPairsOdds {
+    double perfect = 0.0;   ///< Вероятность идеальной пары
+    double colored = 0.0;   ///< Вероятность цветной пары
+    double mixed = 0.0;     ///< Вероятность смешанной пары
+    double houseEdge = 0.0; ///< Преимущество казино, доля ставки
+};
+
+/**
+ * @brief Вероятности исходов 21+3 (исходы не пересекаются: платит старший)
+ */
+struct TwentyOnePlusThreeOdds {
+    double suitedTrips = 0.0;   ///< Три одинаковые карты
+    double straightFlush = 0.0; ///< Стрит одной масти
+    double trips = 0.0;         ///< Тройка разных мастей
+    double straight = 0.0;      ///< Стрит не одной масти
+    double flush = 0.0;         ///< Флеш без стрита и тройки
+    double houseEdge = 0.0;     ///< Преимущество казино, доля ставки
+};
+
+// ==================== ТОЧНЫЕ ШАНСЫ ====================
+
+/**
+ * @brief Точные шансы побочных ставок по составу оставшихся карт
+ *
+ * Хранит остаток по каждой паре (достоинство, масть) и суммы, из которых
+ * вероятности получаются формулами, без перебора комбинаций:
+ * - упорядоченные пары различных карт одного достоинства, одной масти
+ *   и одного достоинства в масти того же цвета: sum x(x - 1);
+ * - тройки одного достоинства, одинаковых карт и одной масти: sum x(x - 1)(x - 2);
+ * - стриты: по 12 последовательностям (A23 ... QKA) произведение остатков
+ *   достоинств, стриты одной масти - то же по каждой масти.
+ *
+ * Выход или возврат карты меняет суммы за O(1): разность слагаемого
+ * для ее достоинства, масти и цвета и до трех последовательностей со
+ * стритом. Все суммы целые, поэтому шансы после любой истории выдачи
+ * совпадают с пересчетом по составу. Масти Hearts и Diamonds - красные,
+ * Clubs и Spades - черные.
+ */
+class SideBetOdds {
+public:
+    static constexpr size_t RANKS = 13; ///< Достоинств (2..A)
+    static constexpr size_t SUITS = 4;  ///< Мастей
+
+    /**
+     * @brief Убрать все карты
+     */
+    void clear();
+
+    /**
+     * @brief Вернуть карту в остаток
+     */
+    void add(const Card& card) { update(card, 1); }
+
+    /**
+     * @brief Карта вышла из остатка
+     */
+    void remove(const Card& card) { update(card, -1); }
+
+    /**
+     * @brief Осталось карт
+     */
+    size_t getCardCount() const { return total_; }
+
+    /**
+     * @brief Осталось карт данных достоинства и масти
+     */
+    size_t getRemaining(Rank rank, Suit suit) const;
+
+    /**
+     * @brief Шансы Perfect Pairs на две следующие карты
+     */
+    PerfectPairsOdds perfectPairs(const PerfectPairsPaytable& paytable = PerfectPairsPaytable()) const;
+
+    /**
+     * @brief Шансы 21+3 на три следующие карты
+     */
+    TwentyOnePlusThreeOdds twentyOnePlusThree(
+        const TwentyOnePlusThreePaytable& paytable = TwentyOnePlusThreePaytable()) const;
+
+    /**
+     * @brief Совпадают ли остатки и все суммы (для сверки с пересчетом)
+     */
+    bool operator==(const SideBetOdds& other) const;
+
+private:
+    /**
+     * @brief Изменить остаток карты на delta (+1 или -1) и суммы
+     */
+    void update(const Card& card, int delta);
+
+    uint16_t cards_[RANKS][SUITS] = {};   ///< Остаток по достоинству и масти
+    uint16_t ranks_[RANKS] = {};          ///< Остаток по достоинству
+    uint16_t colors_[RANKS][2] = {};      ///< Остаток достоинства по цвету (0 - красные, 1 - черные)
+    uint16_t suits_[SUITS] = {};          ///< Остаток по масти
+    uint32_t total_ = 0;                  ///< Всего карт
+
+    int64_t sameCardPairs_ = 0;   ///< sum x(x - 1) по (достоинство, масть)
+    int64_t colorPairs_ = 0;      ///< sum x(x - 1) по (достоинство, цвет)
+    int64_t rankPairs_ = 0;       ///< sum x(x - 1) по достоинству
+    int64_t sameCardTriples_ = 0; ///< sum x(x - 1)(x - 2) по (достоинство, масть)
+    int64_t rankTriples_ = 0;     ///< sum x(x - 1)(x - 2) по достоинству
+    int64_t suitTriples_ = 0;     ///< sum x(x - 1)(x - 2) по масти
+    int64_t straights_ = 0;       ///< Неупорядоченных троек-стритов
+    int64_t straightFlushes_ = 0; ///< Из них одной масти
+};
@@ -0,0 +1,470 @@
+#include "simulator.h"
+#include "game.h"
+#include "options.h"
+#include "strategy.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+// ==================== ПОТОКОВАЯ СТАТИСТИКА ====================
+
+double RunningStats::getVariance() const {
+    if (count_ < 2) {
+        return 0.0;
+    }
+    double n = static_cast<double>(count_);
+    double mean = getMean();
+    double variance = (static_cast<double>(sumSquares_) - n * mean * mean) / (n - 1.0);
+    return variance > 0.0 ? variance : 0.0;
+}
+
+double RunningStats::getStdDev() const {
+    return std::sqrt(getVariance());
+}
+
+double RunningStats::getStdError() const {
+    return count_ > 0 ? std::sqrt(getVariance() / static_cast<double>(count_)) : 0.0;
+}
+
+void RunningStats::write(std::ostream& os) const {
+    os << count_ << " " << sum_ << " " << sumSquares_;
+}
+
+bool RunningStats::read(std::istream& is) {
+    RunningStats loaded;
+    if (!(is >> loaded.count_ >> loaded.sum_ >> loaded.sumSquares_)) {
+        return false;
+    }
+    *this = loaded;
+    return true;
+}
+
+void BatchMeans::write(std::ostream& os) const {
+    os << batches_ << " " << sum_ << " " << count_
+        << " " << sumSquares_.high << " " << sumSquares_.low
+        << " " << sumProducts_.high << " " << sumProducts_.low << " " << countSquares_;
+}
+
+bool BatchMeans::read(std::istream& is) {
+    BatchMeans loaded;
+    if (!(is >> loaded.batches_ >> loaded.sum_ >> loaded.count_
+        >> loaded.sumSquares_.high >> loaded.sumSquares_.low
+        >> loaded.sumProducts_.high >> loaded.sumProducts_.low >> loaded.countSquares_)) {
+        return false;
+    }
+    *this = loaded;
+    return true;
+}
+
+double BatchMeans::getStdError() const {
+    if (batches_ < 2 || count_ == 0) {
+        return 0.0;
+    }
+    // Разброс пачек вокруг ratio * размер: sum (S - r N)^2 / (B - 1)
+    double b = static_cast<double>(batches_);
+    double ratio = getMean();
+    double spread = sumSquares_.toDouble() - 2.0 * ratio * sumProducts_.toDouble()
+        + ratio * ratio * static_cast<double>(countSquares_);
+    double variance = std::max(spread, 0.0) / (b - 1.0);
+    double meanCount = static_cast<double>(count_) / b;
+    return std::sqrt(variance / b) / meanCount;
+}
+
+// ==================== ШУЗ И РАУНД ====================
+
+RoundSimulator::RoundSimulator(const SimulationRules& rules)
+    : rules_(rules), fullShoe_(rules.deckCount), shoe_(fullShoe_), player_("Simulated") {
+    double penetration = std::min(std::max(rules_.penetration, 0.1), 1.0);
+    cutCard_ = static_cast<size_t>(fullShoe_.size() * (1.0 - penetration));
+    fullShoe_.setCountSystem(rules_.countSystem);
+    shoe_ = fullShoe_;
+    dealer_.restoreStrategy(rules_.dealerStrategy);
+    dealer_.setHitSoft17(rules_.dealerHitsSoft17);
+}
+
+void RoundSimulator::shuffle(std::mt19937& generator) {
+    shoe_ = fullShoe_; // Емкость шуза сохраняется - без выделений, счет снова нулевой
+    shoe_.shuffle(generator);
+}
+
+void RoundSimulator::deal(Player& target, std::mt19937& generator) {
+    if (shoe_.isEmpty()) {
+        shuffle(generator); // Только при отрезной карте в самом конце шуза
+    }
+    if (stream_) {
+        shoe_.swapToTop(stream_->pick(shoe_.size(), generator));
+    }
+    target.takeCard(shoe_);
+}
+
+void RoundSimulator::rememberInitialCards() {
+    initialCards_[0] = player_.getHand()[0];
+    initialCards_[1] = player_.getHand()[1];
+    initialCards_[2] = dealer_.getHand()[0];
+    initialCards_[3] = dealer_.getHand()[1];
+}
+
+Chips RoundSimulator::playRound(Chips stake, Chips reserve, std::mt19937& generator) {
+    player_.clearHand();
+    dealer_.clearHand();
+
+    // Раздача как в Game::dealInitialCards(): две карты игроку, затем две дилеру
+    deal(player_, generator);
+    deal(player_, generator);
+    deal(dealer_, generator);
+    deal(dealer_, generator);
+    rememberInitialCards();
+
+    stakes_[0] = stake;
+    return playHands(reserve, LegalActions(), generator);
+}
+
+Chips RoundSimulator::playFreshRound(const Deck& source, Chips stake, CardStream& stream, std::mt19937& generator) {
+    shoe_ = source; // Емкость шуза сохраняется - без выделений
+    stream_ = &stream;
+    player_.clearHand();
+    dealer_.clearHand();
+
+    deal(player_, generator);
+    deal(player_, generator);
+    deal(dealer_, generator);
+    deal(dealer_, generator);
+    rememberInitialCards();
+
+    stakes_[0] = stake;
+    Chips net = playHands(Chips(1) << 50, LegalActions(), generator);
+    stream_ = nullptr;
+    return net;
+}
+
+Chips RoundSimulator::playDecision(const Deck& shoe, const Card& first, const Card& second, const Card& upcard,
+    PlayerAction firstAction, Chips stake, std::mt19937& generator) {
+    shoe_ = shoe; // Емкость шуза сохраняется - без выделений
+    player_.clearHand();
+    dealer_.clearHand();
+    player_.addCard(first);
+    player_.addCard(second);
+    dealer_.addCard(upcard);
+    deal(dealer_, generator);
+    rememberInitialCards();
+
+    stakes_[0] = stake;
+    return playHands(Chips(1) << 50, LegalActions().with(firstAction), generator);
+}
+
+Chips RoundSimulator::playHands(Chips reserve, LegalActions firstAction, std::mt19937& generator) {
+    int up = upcardValue(dealer_.getHand()[0]);
+
+    for (size_t hand = 0; hand < player_.getHandCount(); ++hand) {
+        player_.selectHand(hand);
+
+        while (true) {
+            LegalActions legal = player_.getLegalActions();
+            if (stakes_[hand] > reserve) {
+                legal = legal.without(PlayerAction::DoubleDown).without(PlayerAction::Split);
+            }
+            if (legal.empty()) {
+                break;
+            }
+
+            PlayerAction action = policyAction(rules_.playerPolicy, summarizeHand(player_.getHand()), up, legal);
+            if (!firstAction.empty()) {
+                // Заданное первое решение заменяет базовую стратегию, если оно допустимо
+                if (legal.contains(*firstAction.begin())) {
+                    action = *firstAction.begin();
+                }
+                firstAction = LegalActions();
+            }
+            if (action == PlayerAction::Stand) {
+                break;
+            }
+            if (action == PlayerAction::Hit) {
+                deal(player_, generator);
+                continue;
+            }
+
+            reserve -= stakes_[hand];
+            if (action == PlayerAction::DoubleDown) {
+                stakes_[hand] *= 2;
+                deal(player_, generator);
+                break;
+            }
+
+            // Split: новая рука в конце списка играется в этом же цикле
+            if (shoe_.size() < 2) {
+                shuffle(generator);
+            }
+            if (stream_) {
+                // Обе карты Split - тоже со случайных позиций, в порядке выдачи
+                shoe_.swapToTop(stream_->pick(shoe_.size(), generator), 0);
+                shoe_.swapToTop(stream_->pick(shoe_.size() - 1, generator), 1);
+            }
+            player_.splitActiveHand(shoe_);
+            stakes_[player_.getHandCount() - 1] = stakes_[hand];
+        }
+    }
+
+    // Дилер добирает всегда, как в Game::dealerTurn()
+    while (dealer_.mustDrawCard()) {
+        deal(dealer_, generator);
+    }
+
+    bool dealerNatural = dealer_.hasNatural();
+    Chips net = 0;
+    for (size_t hand = 0; hand < player_.getHandCount(); ++hand) {
+        player_.selectHand(hand);
+        WagerResult result = wagerResult(Game::judgeHand(player_, dealer_), player_.hasNatural(), dealerNatural);
+        net += wagerReturn(stakes_[hand], result) - stakes_[hand];
+    }
+    player_.selectHand(0);
+    return net;
+}
+
+// ==================== ШКАЛА СТАВОК ====================
+
+bool BettingRamp::parse(const std::string& text, BettingRamp& ramp) {
+    BettingRamp parsed;
+    bool haveBase = false;
+    std::istringstream stream(text);
+    std::string token;
+
+    while (std::getline(stream, token, ',')) {
+        size_t colon = token.find(':');
+        Chips units = 0;
+
+        if (colon == std::string::npos) {
+            // Ступень без порога - ставка ниже всех порогов, только первой
+            if (haveBase || !parsed.steps_.empty() || !parseChips(token, units) || units <= 0) {
+                return false;
+            }
+            parsed.baseUnits_ = units;
+            haveBase = true;
+            continue;
+        }
+
+        char* end = nullptr;
+        std::string threshold = token.substr(0, colon);
+        long trueCount = std::strtol(threshold.c_str(), &end, 10);
+        if (threshold.empty() || *end != '\0' || !parseChips(token.substr(colon + 1), units) || units <= 0) {
+            return false;
+        }
+        parsed.steps_.emplace_back(static_cast<int>(trueCount), units);
+    }
+
+    std::sort(parsed.steps_.begin(), parsed.steps_.end());
+    ramp = parsed;
+    return true;
+}
+
+Chips BettingRamp::betFor(double trueCount) const {
+    int floored = static_cast<int>(std::floor(trueCount));
+    Chips units = baseUnits_;
+    for (const auto& step : steps_) {
+        if (step.first > floored) break;
+        units = step.second;
+    }
+    return units;
+}
+
+Chips BettingRamp::minimumBet() const {
+    Chips minimum = baseUnits_;
+    for (const auto& step : steps_) {
+        minimum = std::min(minimum, step.second);
+    }
+    return minimum;
+}
+
+std::string BettingRamp::describe() const {
+    if (steps_.empty()) {
+        return "flat " + formatChips(baseUnits_);
+    }
+    std::string text = formatChips(baseUnits_);
+    for (const auto& step : steps_) {
+        text += ", TC " + std::to_string(step.first) + "+: " + formatChips(step.second);
+    }
+    return text;
+}
+
+// ==================== ТРАЕКТОРИИ БАНКРОЛЛА ====================
+
+void BankrollTotals::merge(const BankrollTotals& other) {
+    trajectories += other.trajectories;
+    ruined += other.ruined;
+    finishedAhead += other.finishedAhead;
+    handResult.merge(other.handResult);
+    handsToRuin.merge(other.handsToRuin);
+    finalBankroll.merge(other.finalBankroll);
+}
+
+BankrollSimulator::BankrollSimulator(const BankrollConfig& config)
+    : config_(config) {
+    if (config_.threads == 0) {
+        config_.threads = std::thread::hardware_concurrency();
+    }
+    if (config_.threads == 0) config_.threads = 1;
+    if (config_.threads > config_.trajectories) config_.threads = static_cast<size_t>(config_.trajectories);
+    if (config_.threads == 0) config_.threads = 1;
+}
+
+void BankrollSimulator::run() {
+    // Траектории раздаются пачками: соседние потоки не дерутся за счетчик
+    constexpr uint64_t CHUNK = 64;
+    std::atomic<uint64_t> next(0);
+    std::vector<BankrollTotals> partial(config_.threads);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < config_.threads; ++t) {
+        workers.emplace_back([this, &next, &partial, t]() {
+            RoundSimulator simulator(config_.rules);
+            BankrollTotals& totals = partial[t];
+            uint64_t begin;
+            while ((begin = next.fetch_add(CHUNK)) < config_.trajectories) {
+                uint64_t end = std::min(begin + CHUNK, config_.trajectories);
+                for (uint64_t index = begin; index < end; ++index) {
+                    playTrajectory(index, simulator, totals);
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    totals_ = BankrollTotals();
+    for (const auto& totals : partial) {
+        totals_.merge(totals);
+    }
+}
+
+void BankrollSimulator::playTrajectory(uint64_t index, RoundSimulator& simulator, BankrollTotals& totals) const {
+    std::seed_seq sequence{ config_.seed, static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32) };
+    std::mt19937 generator(sequence);
+    simulator.shuffle(generator);
+
+    Chips start = static_cast<Chips>(std::llround(config_.bankrollUnits * CHIP_SCALE));
+    Chips bankroll = start;
+    Chips minimum = config_.ramp.minimumBet();
+
+    uint64_t hand = 0;
+    for (; hand < config_.hands && bankroll >= minimum; ++hand) {
+        if (simulator.needsShuffle()) {
+            simulator.shuffle(generator);
+        }
+
+        Chips stake = std::min(config_.ramp.betFor(simulator.getShoe().getTrueCount()), bankroll);
+        Chips net = simulator.playRound(stake, bankroll - stake, generator);
+        bankroll += net;
+        totals.handResult.add(net);
+    }
+
+    totals.trajectories++;
+    if (bankroll < minimum) {
+        totals.ruined++;
+        totals.handsToRuin.add(static_cast<int64_t>(hand));
+    }
+    if (bankroll > start) {
+        totals.finishedAhead++;
+    }
+    totals.finalBankroll.record(static_cast<uint64_t>(bankroll));
+}
+
+void BankrollSimulator::printReport(std::ostream& os) const {
+    static const char* STRATEGY_NAMES[] = { "Standard (stops at 17+)", "Aggressive (stops at 18+)", "Cautious (stops at 16+)" };
+
+    const BankrollTotals& t = totals_;
+    double trajectories = t.trajectories > 0 ? static_cast<double>(t.trajectories) : 1.0;
+    double hands = static_cast<double>(t.handResult.getCount());
+    double ruin = t.ruined / trajectories;
+    double ruinMargin = 1.96 * std::sqrt(ruin * (1.0 - ruin) / trajectories);
+    double scale = static_cast<double>(CHIP_SCALE);
+    double winRate = t.handResult.getMean() / scale;
+    double handSd = t.handResult.getStdDev() / scale;
+
+    os << "\n=== BANKROLL SIMULATION ===\n";
+    os << std::fixed << std::setprecision(2);
+    os << "Rules: " << config_.rules.deckCount << " decks, penetration "
+        << config_.rules.penetration * 100.0 << "%, dealer "
+        << STRATEGY_NAMES[static_cast<int>(config_.rules.dealerStrategy)] << "\n";
+    os << "Ramp (units): " << config_.ramp.describe() << " | Count: " << config_.rules.countSystem.name << "\n";
+    os << "Trajectories: " << t.trajectories << " x up to " << config_.hands << " hands"
+        << " | Bankroll: " << config_.bankrollUnits << " units | Threads: " << config_.threads << "\n";
+    os << "Time: " << seconds_ << " s (" << std::setprecision(0)
+        << hands / (seconds_ > 0.0 ? seconds_ : 1.0) << " hands/sec)\n";
+
+    os << std::setprecision(3);
+    os << "\nRisk of ruin: " << ruin * 100.0 << "% +/- " << ruinMargin * 100.0 << "% (95%), "
+        << t.ruined << " of " << t.trajectories << " trajectories\n";
+    if (t.ruined > 0) {
+        os << "Hands to ruin: mean " << std::setprecision(1) << t.handsToRuin.getMean() << "\n";
+    }
+
+    os << std::setprecision(4);
+    os << "Win rate: " << winRate << " +/- " << 1.96 * t.handResult.getStdError() / scale
+        << " units/hand (" << winRate * 100.0 << " per 100 hands)\n";
+    os << "SD: " << handSd << " units/hand\n";
+    if (winRate > 0.0) {
+        // N0 - раундов, за которые ожидаемый выигрыш сравнивается с одним стандартным отклонением
+        os << "N0: " << std::setprecision(0) << handSd * handSd / (winRate * winRate) << " hands\n";
+    }
+    else {
+        os << "N0: n/a (no positive edge)\n";
+    }
+
+    os << std::setprecision(2);
+    os << "\nFinal bankroll after up to " << config_.hands << " hands (units, +/-3% buckets):\n";
+    os << "Mean: " << t.finalBankroll.getMean() / scale
+        << "  Min: " << t.finalBankroll.getMin() / scale
+        << "  Max: " << t.finalBankroll.getMax() / scale << "\n";
+    for (double percentile : { 1.0, 5.0, 25.0, 50.0, 75.0, 95.0, 99.0 }) {
+        os << "  p" << std::setw(2) << static_cast<int>(percentile) << ": "
+            << std::setw(12) << t.finalBankroll.valueAtPercentile(percentile) / scale << "\n";
+    }
+    os << "Finished ahead: " << 100.0 * t.finishedAhead / trajectories << "%\n";
+}
+
+// ==================== ТОЧКА ВХОДА ====================
+
+int runBankrollSimulator(int argc, char* argv[]) {
+    CommandLine options(argc, argv);
+
+    BankrollConfig config;
+    config.trajectories = static_cast<uint64_t>(options.getInt("trajectories", static_cast<long long>(config.trajectories)));
+    config.hands = static_cast<uint64_t>(options.getInt("hands", static_cast<long long>(config.hands)));
+    config.bankrollUnits = options.getDouble("bankroll", config.bankrollUnits);
+    config.threads = static_cast<size_t>(options.getInt("threads", 0));
+    config.seed = static_cast<uint32_t>(options.getInt("seed", config.seed));
+    config.rules.deckCount = static_cast<size_t>(options.getInt("decks", static_cast<long long>(config.rules.deckCount)));
+    config.rules.penetration = options.getDouble("penetration", config.rules.penetration);
+
+    std::string countName = options.getString("count", "hi-lo");
+    const CountSystem* countSystem = findCountSystem(countName);
+    if (!countSystem) {
+        std::cerr << "Unknown count system \"" << countName << "\". Expected hi-lo, hi-opt-1, omega-2 or zen\n";
+        return 1;
+    }
+    config.rules.countSystem = *countSystem;
+
+    std::string rampText = options.getString("ramp", "1");
+    if (!BettingRamp::parse(rampText, config.ramp)) {
+        std::cerr << "Invalid ramp \"" << rampText << "\". Expected e.g. 1 or 1,2:2,3:4,4:8\n";
+        return 1;
+    }
+    if (config.trajectories == 0 || config.hands == 0 || config.bankrollUnits <= 0.0 ||
+        config.rules.deckCount == 0) {
+        std::cerr << "Usage: --bankroll [--trajectories N] [--hands N] [--bankroll units] [--ramp spec]"
+            " [--count system] [--decks N] [--penetration 0-1] [--threads N] [--seed N]\n";
+        return 1;
+    }
+
+    BankrollSimulator simulator(config);
+    simulator.run();
+    simulator.printReport(std::cout);
+    return 0;
+}
@@ -0,0 +1,452 @@
+#pragma once
+#include "player.h"
+#include "dealer.h"
+#include "deck.h"
+#include "histogram.h"
+#include "ledger.h"
+#include "strategy.h"
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// ==================== ПОТОКОВАЯ СТАТИСТИКА ====================
+
+/**
+ * @brief Среднее и дисперсия целых наблюдений без хранения выборки
+ *
+ * Копятся точные целые суммы, поэтому накопители потоков сливаются
+ * в любом порядке в один и тот же результат - итог прогона не зависит
+ * от числа потоков. Сумма квадратов помещается в 64 бита, пока
+ * count * max|value|^2 < 1.8e19 (миллиарды раундов по ставкам в сотнях единиц).
+ */
+class RunningStats {
+public:
+    /**
+     * @brief Добавить наблюдение
+     */
+    void add(int64_t value) {
+        ++count_;
+        sum_ += value;
+        sumSquares_ += static_cast<uint64_t>(value * value);
+    }
+
+    /**
+     * @brief Добавить накопитель другого потока
+     */
+    void merge(const RunningStats& other) {
+        count_ += other.count_;
+        sum_ += other.sum_;
+        sumSquares_ += other.sumSquares_;
+    }
+
+    uint64_t getCount() const { return count_; }
+    int64_t getSum() const { return sum_; }
+    uint64_t getSumSquares() const { return sumSquares_; }
+    double getMean() const { return count_ > 0 ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0; }
+    double getVariance() const; ///< Выборочная дисперсия
+    double getStdDev() const;
+    double getStdError() const; ///< Стандартная ошибка среднего
+
+    /**
+     * @brief Записать точные суммы одной строкой (для контрольных точек)
+     */
+    void write(std::ostream& os) const;
+
+    /**
+     * @brief Прочитать суммы, записанные write()
+     * @return false если формат не распознан
+     */
+    bool read(std::istream& is);
+
+private:
+    uint64_t count_ = 0;      ///< Наблюдений
+    int64_t sum_ = 0;         ///< Сумма
+    uint64_t sumSquares_ = 0; ///< Сумма квадратов
+};
+
+/**
+ * @brief Точная сумма 64-битных слагаемых в 128 битах
+ *
+ * Квадраты сумм пачек помещаются в 64 бита, а их сумма за миллионы пачек - нет.
+ * Целая сумма не зависит от порядка слагаемых, поэтому накопители сливаются
+ * в любом порядке в один и тот же результат.
+ */
+struct WideSum {
+    uint64_t low = 0;  ///< Младшее слово
+    int64_t high = 0;  ///< Старшее слово (со знаком)
+
+    void add(int64_t value) {
+        uint64_t before = low;
+        low += static_cast<uint64_t>(value);
+        high += (value < 0 ? -1 : 0) + (low < before ? 1 : 0);
+    }
+
+    void add(const WideSum& other) {
+        uint64_t before = low;
+        low += other.low;
+        high += other.high + (low < before ? 1 : 0);
+    }
+
+    double toDouble() const { return static_cast<double>(high) * 18446744073709551616.0 + static_cast<double>(low); }
+};
+
+/**
+ * @brief Среднее за раунд по пачкам с ошибкой методом средних по пачкам
+ *
+ * Раунды одного шуза зависимы (общий остаток карт), поэтому ошибка
+ * по отдельным раундам занижена. Пачка - сумма и число раундов
+ * нескольких целых шузов; среднее - отношение сумм, дисперсия - по
+ * разбросу пачек (оценка отношения). Все суммы целые и точные, как
+ * в RunningStats: накопители потоков, контрольных точек и процессов
+ * сливаются в любом порядке в один результат.
+ */
+class BatchMeans {
+public:
+    /**
+     * @brief Добавить пачку
+     * @param sum Сумма наблюдений пачки
+     * @param count Наблюдений в пачке
+     */
+    void add(int64_t sum, uint64_t count) {
+        int64_t n = static_cast<int64_t>(count);
+        ++batches_;
+        sum_ += sum;
+        count_ += count;
+        sumSquares_.add(sum * sum);
+        sumProducts_.add(sum * n);
+        countSquares_ += count * count;
+    }
+
+    /**
+     * @brief Добавить накопитель другого потока или процесса
+     */
+    void merge(const BatchMeans& other) {
+        batches_ += other.batches_;
+        sum_ += other.sum_;
+        count_ += other.count_;
+        sumSquares_.add(other.sumSquares_);
+        sumProducts_.add(other.sumProducts_);
+        countSquares_ += other.countSquares_;
+    }
+
+    uint64_t getBatches() const { return batches_; }
+    uint64_t getCount() const { return count_; }
+    double getMean() const { return count_ > 0 ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0; }
+    double getStdError() const; ///< Стандартная ошибка среднего (0 при меньше чем двух пачках)
+
+    /**
+     * @brief Записать точные суммы одной строкой (для контрольных точек и файлов результатов)
+     */
+    void write(std::ostream& os) const;
+
+    /**
+     * @brief Прочитать суммы, записанные write()
+     * @return false если формат не распознан
+     */
+    bool read(std::istream& is);
+
+private:
+    uint64_t batches_ = 0;       ///< Пачек
+    int64_t sum_ = 0;            ///< Сумма наблюдений
+    uint64_t count_ = 0;         ///< Наблюдений
+    WideSum sumSquares_;         ///< Сумма квадратов сумм пачек
+    WideSum sumProducts_;        ///< Сумма произведений суммы и размера пачки
+    uint64_t countSquares_ = 0;  ///< Сумма квадратов размеров пачек
+};
+
+// ==================== ШУЗ И РАУНД ====================
+
+/**
+ * @brief Правила стола для симуляций
+ */
+struct SimulationRules {
+    size_t deckCount = 6;                               ///< Колод в шузе
+    double penetration = 0.75;                          ///< Доля шуза до перемешивания
+    DealerStrategy dealerStrategy = DealerStrategy::Standard; ///< Стратегия дилера
+    CountSystem countSystem = HI_LO_COUNT;              ///< Система счета для шкалы ставок
+    PlayerPolicy playerPolicy = PlayerPolicy::Basic;    ///< Стратегия игрока
+    bool dealerHitsSoft17 = false;                      ///< Дилер добирает мягкие 17 (H17)
+};
+
+/**
+ * @brief Заранее вытянутые случайные числа для позиций карт одного раунда
+ *
+ * Раунды, сыгранные по одному и тому же потоку из одного шуза, получают
+ * одни и те же карты по порядку выдачи, как бы ни играли руки: k-я выдача
+ * берет позицию из k-го числа. Так две стратегии сравниваются на общих
+ * случайных числах. Чисел с запасом на любой реальный раунд; если их
+ * не хватит, дальше берется генератор.
+ */
+class CardStream {
+public:
+    static constexpr size_t SIZE = 64; ///< Чисел на раунд
+
+    /**
+     * @brief Вытянуть новые числа
+     */
+    void fill(std::mt19937& generator) {
+        for (auto& value : values_) {
+            value = static_cast<uint32_t>(generator());
+        }
+        position_ = 0;
+    }
+
+    /**
+     * @brief Начать поток сначала (для следующей стратегии)
+     */
+    void rewind() { position_ = 0; }
+
+    /**
+     * @brief Позиция в [0, bound): умножение и сдвиг вместо деления
+     */
+    size_t pick(size_t bound, std::mt19937& generator) {
+        uint64_t value = position_ < SIZE ? values_[position_++] : static_cast<uint32_t>(generator());
+        return static_cast<size_t>((value * bound) >> 32);
+    }
+
+private:
+    uint32_t values_[SIZE] = {}; ///< Случайные числа
+    size_t position_ = 0;        ///< Следующее число
+};
+
+/**
+ * @brief Раунды одного места против дилера из многоколодного шуза
+ *
+ * Правила те же что и в Game: по 2 карты игроку и дилеру, игрок играет
+ * базовую стратегию (Split до Player::MAX_HANDS рук, удвоение на двух
+ * картах), дилер добирает по своей стратегии без подглядывания, выплаты -
+ * wagerReturn() с 3:2 за блэкджек. Объекты переиспользуются, поэтому
+ * раунд не выделяет память. Счет ведет сам шуз (Deck). Вместо базовой
+ * стратегии можно задать другую (SimulationRules::playerPolicy).
+ */
+class RoundSimulator {
+public:
+    /**
+     * @brief Конструктор
+     * @param rules Правила стола
+     */
+    explicit RoundSimulator(const SimulationRules& rules);
+
+    /**
+     * @brief Собрать и перемешать шуз заново (счет обнуляется)
+     */
+    void shuffle(std::mt19937& generator);
+
+    /**
+     * @brief Начать шуз с заранее перемешанного
+     * @param shoe Шуз того же числа колод (например, общий для нескольких правил)
+     */
+    void loadShoe(const Deck& shoe) { shoe_ = shoe; }
+
+    /**
+     * @brief Дошли ли до отрезной карты
+     */
+    bool needsShuffle() const { return shoe_.size() <= cutCard_; }
+
+    /**
+     * @brief Сыграть раунд
+     * @param stake Начальная ставка
+     * @param reserve Сколько еще можно доставить на удвоения и Split
+     * @param generator Генератор для аварийной перетасовки, если шуз кончился посреди раунда
+     * @return Выигрыш игрока (отрицательный - проигрыш)
+     */
+    Chips playRound(Chips stake, Chips reserve, std::mt19937& generator);
+
+    /**
+     * @brief Сыграть заданную руку из подготовленного шуза
+     *
+     * Первое решение - firstAction (если допустимо), дальше базовая стратегия.
+     * Один и тот же шуз с разными firstAction дает сравнение действий
+     * на одинаковых картах.
+     *
+     * @param shoe Шуз; верхняя карта станет закрытой картой дилера
+     * @param first Первая карта игрока
+     * @param second Вторая карта игрока
+     * @param upcard Открытая карта дилера
+     * @param firstAction Первое решение
+     * @param stake Ставка (удвоения и Split без ограничения банкролла)
+     * @param generator Генератор для аварийной перетасовки
+     * @return Выигрыш игрока
+     */
+    Chips playDecision(const Deck& shoe, const Card& first, const Card& second, const Card& upcard,
+        PlayerAction firstAction, Chips stake, std::mt19937& generator);
+
+    /**
+     * @brief Сыграть раунд из свежеперетасованного шуза
+     *
+     * Шуз копируется из source, каждая карта выдается со случайной позиции
+     * из stream (ленивая перетасовка). Одинаковые source и stream дают
+     * одинаковую последовательность карт при любой игре рук.
+     *
+     * @param source Шуз перед раундом
+     * @param stake Ставка (удвоения и Split без ограничения банкролла)
+     * @param stream Позиции карт раунда (перед вызовом - rewind() или fill())
+     * @param generator Генератор, если позиций в stream не хватит
+     * @return Выигрыш игрока
+     */
+    Chips playFreshRound(const Deck& source, Chips stake, CardStream& stream, std::mt19937& generator);
+
+    /**
+     * @brief Первые карты последнего раунда: две игрока, открытая и закрытая дилера
+     */
+    const Card* getInitialCards() const { return initialCards_; }
+
+    /**
+     * @brief Текущий шуз: счет и остаток карт
+     */
+    const Deck& getShoe() const { return shoe_; }
+
+private:
+    /**
+     * @brief Дать карту, при пустом шузе перетасовать полный шуз
+     */
+    void deal(Player& target, std::mt19937& generator);
+
+    /**
+     * @brief Запомнить начальную раздачу раунда
+     */
+    void rememberInitialCards();
+
+    /**
+     * @brief Доиграть розданный раунд: руки игрока, дилер, расчет
+     * @param reserve Сколько еще можно доставить на удвоения и Split
+     * @param firstAction Первое решение (одно действие) или пустой набор - базовая стратегия
+     * @return Выигрыш игрока
+     */
+    Chips playHands(Chips reserve, LegalActions firstAction, std::mt19937& generator);
+
+    SimulationRules rules_;  ///< Правила
+    Deck fullShoe_;          ///< Несмешанный полный шуз (образец для shuffle)
+    Deck shoe_;              ///< Текущий шуз
+    size_t cutCard_ = 0;     ///< Остаток шуза, на котором перемешиваем
+    Player player_;          ///< Место игрока
+    Dealer dealer_;          ///< Дилер
+    Chips stakes_[Player::MAX_HANDS] = {}; ///< Ставки рук раунда
+    Card initialCards_[4] = { Card(Suit::Hearts, Rank::Two), Card(Suit::Hearts, Rank::Two),
+        Card(Suit::Hearts, Rank::Two), Card(Suit::Hearts, Rank::Two) }; ///< Начальная раздача
+    CardStream* stream_ = nullptr; ///< Позиции карт (только внутри playFreshRound)
+};
+
+// ==================== ШКАЛА СТАВОК ====================
+
+/**
+ * @brief Шкала ставок по истинному счету
+ *
+ * Строка "1" - ровная ставка в 1 единицу; "1,2:2,3:4,4:8" - 1 единица,
+ * с истинного счета 2 (округление вниз) - 2 единицы, с 3 - 4, с 4 - 8
+ */
+class BettingRamp {
+public:
+    BettingRamp() = default;
+
+    /**
+     * @brief Разобрать шкалу
+     * @param text Описание шкалы
+     * @param ramp [out] Шкала
+     * @return false если формат не распознан
+     */
+    static bool parse(const std::string& text, BettingRamp& ramp);
+
+    /**
+     * @brief Ставка при данном истинном счете (единица ставки = CHIP_SCALE)
+     */
+    Chips betFor(double trueCount) const;
+
+    /**
+     * @brief Наименьшая ставка шкалы - ниже нее банкролл считается разоренным
+     */
+    Chips minimumBet() const;
+
+    /**
+     * @brief Ставка не зависит от счета
+     */
+    bool isFlat() const { return steps_.empty(); }
+
+    /**
+     * @brief Описание шкалы для отчета
+     */
+    std::string describe() const;
+
+private:
+    Chips baseUnits_ = CHIP_SCALE; ///< Ставка ниже всех ступеней
+    std::vector<std::pair<int, Chips>> steps_; ///< (порог истинного счета, единиц) по возрастанию
+};
+
+// ==================== ТРАЕКТОРИИ БАНКРОЛЛА ====================
+
+/**
+ * @brief Параметры симуляции банкролла
+ */
+struct BankrollConfig {
+    SimulationRules rules;         ///< Правила стола
+    BettingRamp ramp;              ///< Шкала ставок
+    uint64_t trajectories = 10000; ///< Независимых траекторий
+    uint64_t hands = 1000;         ///< Раундов в траектории (если не разорились раньше)
+    double bankrollUnits = 100.0;  ///< Начальный банкролл в единицах ставки
+    size_t threads = 0;            ///< Рабочих потоков (0 - по числу ядер)
+    uint32_t seed = 1;             ///< Зерно (траектория i - свой поток чисел от seed и i)
+};
+
+/**
+ * @brief Итоги потока (или всего прогона после слияния)
+ */
+struct BankrollTotals {
+    uint64_t trajectories = 0;   ///< Сыграно траекторий
+    uint64_t ruined = 0;         ///< Разорились до конца траектории
+    uint64_t finishedAhead = 0;  ///< Закончили с банкроллом больше начального
+    RunningStats handResult;     ///< Выигрыш за раунд (Chips)
+    RunningStats handsToRuin;    ///< Раундов до разорения (только разорившиеся)
+    LatencyHistogram finalBankroll; ///< Банкролл в конце траектории, в сотых единицы
+
+    void merge(const BankrollTotals& other);
+};
+
+/**
+ * @brief Параллельная симуляция траекторий банкролла
+ *
+ * Каждая траектория - свой шуз и генератор, засеянный от (seed, номер),
+ * поэтому итог не зависит от числа потоков. Траектория хранит только
+ * баланс и счетчики; потоки копят потоковую статистику, память
+ * не растет с длиной прогона.
+ *
+ * Разорение - банкролл меньше минимальной ставки шкалы. Ставка больше
+ * банкролла урезается до банкролла; удвоение и Split, на которые не
+ * хватает, убираются из допустимых действий.
+ */
+class BankrollSimulator {
+public:
+    explicit BankrollSimulator(const BankrollConfig& config);
+
+    /**
+     * @brief Прогнать все траектории
+     */
+    void run();
+
+    /**
+     * @brief Отчет: риск разорения, выигрыш и N0, распределение банкролла
+     */
+    void printReport(std::ostream& os) const;
+
+    const BankrollTotals& getTotals() const { return totals_; }
+
+private:
+    /**
+     * @brief Сыграть одну траекторию
+     */
+    void playTrajectory(uint64_t index, RoundSimulator& simulator, BankrollTotals& totals) const;
+
+    BankrollConfig config_;   ///< Параметры
+    BankrollTotals totals_;   ///< Итоги после слияния потоков
+    double seconds_ = 0.0;    ///< Время прогона
+};
+
+/**
+ * @brief Точка входа режима симуляции банкролла (--bankroll)
+ * @param argc Число аргументов
+ * @param argv Аргументы: --trajectories, --hands, --bankroll (единиц), --ramp, --count,
+ *             --decks, --penetration, --threads, --seed
+ * @return 0 при успехе
+ */
+int runBankrollSimulator(int argc, char* argv[]);
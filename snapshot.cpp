@@ -0,0 +1,171 @@
+#include "snapshot.h"
+#include "protocol.h"
+#include <cstring>
+
+// ==================== РУКИ И МЕСТА ====================
+
+bool saveHand(HandSnapshot& out, const std::vector<Card>& hand) {
+    if (hand.size() > SNAPSHOT_MAX_HAND_CARDS) {
+        return false;
+    }
+
+    std::memset(&out, 0, sizeof(out));
+    out.count = static_cast<uint8_t>(hand.size());
+    for (size_t i = 0; i < hand.size(); ++i) {
+        out.cards[i] = encodeCard(hand[i]);
+    }
+    return true;
+}
+
+/**
+ * @brief Дописать карты снимка в активную руку игрока
+ */
+static bool appendHand(const HandSnapshot& in, Player& player) {
+    for (size_t i = 0; i < in.count; ++i) {
+        Card card(Suit::Hearts, Rank::Two);
+        if (!decodeCard(in.cards[i], card)) {
+            return false;
+        }
+        player.addCard(card);
+    }
+    return true;
+}
+
+bool restoreHand(const HandSnapshot& in, Player& player) {
+    player.clearHand();
+    return appendHand(in, player);
+}
+
+bool saveSeat(SeatSnapshot& out, const Player& player) {
+    std::memset(&out, 0, sizeof(out));
+
+    std::string name = player.getName();
+    std::strncpy(out.name, name.c_str(), SNAPSHOT_NAME_SIZE - 1);
+
+    out.gamesPlayed = player.getGamesPlayed();
+    out.gamesWon = player.getGamesWon();
+    out.gamesLost = player.getGamesLost();
+    out.gamesPushed = player.getGamesPushed();
+    out.maxScore = player.getMaxScore();
+
+    out.handCount = static_cast<uint8_t>(player.getHandCount());
+    out.activeHand = static_cast<uint8_t>(player.getActiveHand());
+    bool saved = true;
+    for (size_t i = 0; i < player.getHandCount() && saved; ++i) {
+        saved = saveHand(out.hands[i], player.getHand(i));
+    }
+    return saved;
+}
+
+bool restoreSeat(const SeatSnapshot& in, Player& player) {
+    // Имя сравниваем до присваивания: обычно оно не меняется и строку не трогаем
+    size_t length = strnlen(in.name, SNAPSHOT_NAME_SIZE - 1);
+    if (player.getName().compare(0, std::string::npos, in.name, length) != 0) {
+        player.setName(std::string(in.name, length));
+    }
+
+    player.setGamesPlayed(in.gamesPlayed);
+    player.setGamesWon(in.gamesWon);
+    player.setGamesLost(in.gamesLost);
+    player.setGamesPushed(in.gamesPushed);
+    player.setGamesScore(in.maxScore);
+
+    player.clearHand();
+    bool valid = appendHand(in.hands[0], player);
+    for (size_t i = 1; i < in.handCount && valid; ++i) {
+        valid = player.addHand() && appendHand(in.hands[i], player);
+    }
+    player.selectHand(in.activeHand);
+    return valid;
+}
+
+// ==================== СЧЕТ И СТАВКИ ====================
+
+void saveWagers(SeatSnapshot& out, const ChipLedger& ledger, uint32_t account, const size_t* wagers) {
+    out.balance = ledger.getBalance(account);
+    for (size_t hand = 0; hand < out.handCount; ++hand) {
+        if (wagers[hand] == NO_WAGER) {
+            continue;
+        }
+        const Wager& entry = ledger.getWager(wagers[hand]);
+        out.wagered |= static_cast<uint8_t>(1u << hand);
+        if (entry.doubled) {
+            out.doubled |= static_cast<uint8_t>(1u << hand);
+        }
+        out.stakes[hand] = entry.stake;
+    }
+}
+
+uint32_t restoreWagers(const SeatSnapshot& in, ChipLedger& ledger, size_t* wagers) {
+    Chips staked = 0;
+    for (size_t hand = 0; hand < in.handCount; ++hand) {
+        if (in.wagered >> hand & 1) {
+            staked += in.stakes[hand];
+        }
+    }
+    uint32_t account = ledger.openAccount(in.balance + staked);
+
+    for (size_t hand = 0; hand < in.handCount; ++hand) {
+        if (!(in.wagered >> hand & 1)) {
+            continue;
+        }
+        bool doubled = (in.doubled >> hand & 1) != 0;
+        ledger.placeBet(account, doubled ? in.stakes[hand] / 2 : in.stakes[hand], wagers[hand]);
+        if (doubled) {
+            ledger.doubleBet(wagers[hand]);
+        }
+    }
+    return account;
+}
+
+// ==================== КОЛОДА ====================
+
+void saveDeck(GameSnapshot& out, const Deck& deck) {
+    const std::vector<Card>& cards = deck.getCards();
+    out.deckSize = static_cast<uint8_t>(cards.size());
+    for (size_t i = 0; i < cards.size(); ++i) {
+        out.deck[i] = encodeCard(cards[i]);
+    }
+}
+
+bool restoreDeck(const GameSnapshot& in, Deck& deck) {
+    deck.clear();
+    for (size_t i = 0; i < in.deckSize; ++i) {
+        Card card(Suit::Hearts, Rank::Two);
+        if (!decodeCard(in.deck[i], card)) {
+            return false;
+        }
+        deck.addCard(card);
+    }
+    return true;
+}
+
+bool isValidSnapshot(const GameSnapshot& snapshot) {
+    if (snapshot.version != SNAPSHOT_VERSION ||
+        snapshot.seatCount > SNAPSHOT_MAX_SEATS ||
+        snapshot.deckSize > SNAPSHOT_DECK_CARDS ||
+        snapshot.dealer.count > SNAPSHOT_MAX_HAND_CARDS ||
+        snapshot.dealerStrategy > static_cast<uint8_t>(DealerStrategy::Cautious)) {
+        return false;
+    }
+    for (size_t i = 0; i < snapshot.seatCount; ++i) {
+        const SeatSnapshot& seat = snapshot.seats[i];
+        if (seat.handCount < 1 || seat.handCount > SNAPSHOT_MAX_HANDS || seat.activeHand >= seat.handCount) {
+            return false;
+        }
+        for (size_t hand = 0; hand < seat.handCount; ++hand) {
+            if (seat.hands[hand].count > SNAPSHOT_MAX_HAND_CARDS ||
+                seat.stakes[hand] < 0 || seat.stakes[hand] > SNAPSHOT_MAX_CHIPS ||
+                ((seat.doubled >> hand & 1) && seat.stakes[hand] % 2 != 0)) {
+                return false;
+            }
+        }
+        // Ставки только у существующих рук, удвоение - только у руки со ставкой
+        uint8_t hands = static_cast<uint8_t>((1u << seat.handCount) - 1);
+        if ((seat.wagered & ~hands) != 0 || (seat.doubled & ~seat.wagered) != 0 ||
+            seat.balance < 0 || seat.balance > SNAPSHOT_MAX_CHIPS) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,138 @@
+#pragma once
+#include "player.h"
+#include "dealer.h"
+#include "deck.h"
+#include "ledger.h"
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+constexpr uint16_t SNAPSHOT_VERSION = 3;        ///< Версия формата снимка (3 - счета и ставки рук)
+constexpr size_t SNAPSHOT_MAX_SEATS = 4;        ///< Мест в снимке (до 4 игроков у Game и Table)
+constexpr size_t SNAPSHOT_MAX_HANDS = Player::MAX_HANDS; ///< Рук у места после Split
+constexpr size_t SNAPSHOT_MAX_HAND_CARDS = 12;  ///< Карт в руке (больше из одной колоды не набрать)
+constexpr size_t SNAPSHOT_NAME_SIZE = 32;       ///< Размер поля имени с завершающим нулем
+constexpr size_t SNAPSHOT_DECK_CARDS = 52;      ///< Карт в полной колоде
+constexpr int64_t SNAPSHOT_MAX_CHIPS = int64_t(1) << 50; ///< Наибольший баланс или ставка (сумма не переполняется)
+
+/**
+ * @brief Рука в снимке: коды карт encodeCard() по порядку получения
+ */
+struct HandSnapshot {
+    uint8_t count;                           ///< Число карт
+    uint8_t cards[SNAPSHOT_MAX_HAND_CARDS];  ///< Коды карт
+};
+
+/**
+ * @brief Место в снимке: имя, руки, статистика игрока, счет и ставки рук
+ *
+ * Счет и ставки пишут Game и Table (saveWagers)
+ */
+struct SeatSnapshot {
+    char name[SNAPSHOT_NAME_SIZE]; ///< Имя (обрезается до SNAPSHOT_NAME_SIZE - 1 символов)
+    uint8_t handCount;             ///< Рук (1-SNAPSHOT_MAX_HANDS)
+    uint8_t activeHand;            ///< Активная рука
+    HandSnapshot hands[SNAPSHOT_MAX_HANDS]; ///< Руки по порядку появления
+    int32_t gamesPlayed;           ///< Сыграно игр
+    int32_t gamesWon;              ///< Побед
+    int32_t gamesLost;             ///< Поражений
+    int32_t gamesPushed;           ///< Ничьих
+    int32_t maxScore;              ///< Максимум очков
+    uint8_t wagered;               ///< Руки со ставкой (бит на руку)
+    uint8_t doubled;               ///< Руки с удвоенной ставкой (бит на руку)
+    int64_t balance;               ///< Баланс счета без ставок в игре
+    int64_t stakes[SNAPSHOT_MAX_HANDS]; ///< Ставки рук с учетом удвоения
+};
+
+/**
+ * @brief Плоский снимок стола посреди раунда
+ *
+ * Колода в порядке раздачи и позиция в ней, все руки, закрытая карта
+ * дилера (в руке дилера она вторая), статистика игроков, их счета
+ * и открытые ставки рук. Структура
+ * без указателей и строк: копируется memcpy, пишется в файл или сокет
+ * как есть, а из одного снимка можно развернуть сколько угодно веток
+ * "что если" без цепочки выделений памяти.
+ */
+struct GameSnapshot {
+    uint16_t version;                            ///< SNAPSHOT_VERSION
+    uint8_t seatCount;                           ///< Занятых мест
+    uint8_t activeSeat;                          ///< Место, ожидающее хода (NO_ACTIVE_SEAT - нет)
+    uint8_t roundOver;                           ///< Раунд завершен
+    uint8_t dealerStrategy;                      ///< DealerStrategy
+    uint8_t deckSize;                            ///< Оставшихся карт в колоде
+    uint8_t reserved;                            ///< Выравнивание
+    uint32_t tableId;                            ///< Идентификатор стола (0 для Game)
+    uint32_t roundId;                            ///< Номер раунда
+    uint32_t seed;                               ///< Зерно перемешивания будущих раундов
+    uint8_t deck[SNAPSHOT_DECK_CARDS];           ///< Оставшиеся карты, последняя - верхняя
+    uint8_t outcomes[SNAPSHOT_MAX_SEATS];        ///< RoundOutcome мест (если раунд завершен)
+    HandSnapshot dealer;                         ///< Рука дилера
+    SeatSnapshot seats[SNAPSHOT_MAX_SEATS];      ///< Места
+};
+
+static_assert(std::is_trivially_copyable<GameSnapshot>::value, "GameSnapshot must stay flat");
+
+/// @name Сохранение и восстановление частей снимка
+/// @{
+
+/**
+ * @brief Сохранить руку
+ * @return false если в руке больше SNAPSHOT_MAX_HAND_CARDS карт
+ */
+bool saveHand(HandSnapshot& out, const std::vector<Card>& hand);
+
+/**
+ * @brief Восстановить руку игрока (емкость руки переиспользуется)
+ * @return false если в снимке неверный код карты
+ */
+bool restoreHand(const HandSnapshot& in, Player& player);
+
+/**
+ * @brief Сохранить имя, руки и статистику игрока
+ */
+bool saveSeat(SeatSnapshot& out, const Player& player);
+
+/**
+ * @brief Восстановить имя, руки и статистику игрока
+ */
+bool restoreSeat(const SeatSnapshot& in, Player& player);
+
+/**
+ * @brief Сохранить баланс счета и открытые ставки рук места
+ * @param out Место, уже сохраненное saveSeat()
+ * @param ledger Книга фишек
+ * @param account Счет места
+ * @param wagers Номера ставок рук места (NO_WAGER - без ставки)
+ */
+void saveWagers(SeatSnapshot& out, const ChipLedger& ledger, uint32_t account, const size_t* wagers);
+
+/**
+ * @brief Открыть счет места и поставить ставки рук заново, как до снимка
+ * @param in Место снимка
+ * @param ledger Книга фишек
+ * @param wagers [out] Номера ставок рук (руки без ставки не трогаются)
+ * @return Номер счета
+ *
+ * На счет вносится баланс вместе со ставками; удвоенная ставка ставится
+ * половиной и удваивается doubleBet()
+ */
+uint32_t restoreWagers(const SeatSnapshot& in, ChipLedger& ledger, size_t* wagers);
+
+/**
+ * @brief Сохранить оставшиеся карты колоды
+ */
+void saveDeck(GameSnapshot& out, const Deck& deck);
+
+/**
+ * @brief Восстановить колоду в сохраненном порядке
+ * @return false если в снимке неверный код карты
+ */
+bool restoreDeck(const GameSnapshot& in, Deck& deck);
+
+/**
+ * @brief Проверить заголовок и размеры снимка перед восстановлением
+ */
+bool isValidSnapshot(const GameSnapshot& snapshot);
+
+/// @}
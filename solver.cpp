@@ -0,0 +1,398 @@
+#include "solver.h"
+#include "corpus.h"
+#include "options.h"
+#include "game.h"
+#include "table.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <limits>
+#include <random>
+
+namespace {
+    constexpr Chips UNREACHED = std::numeric_limits<Chips>::min() / 4; ///< Позиция слоя не достигнута
+
+    constexpr size_t DEALER_BUST = 0;    ///< Класс: дилер перебрал
+    constexpr size_t DEALER_NATURAL = 7; ///< Класс: блэкджек дилера
+    constexpr int DEALER_LOWEST = 16;    ///< Наименьшие очки, на которых дилер останавливается (Cautious)
+}
+
+PerfectPlaySolver::PerfectPlaySolver(const SimulationRules& rules, size_t maxSeats)
+    : rules_(rules), maxSeats_(std::min(std::max<size_t>(maxSeats, 1), Table::MAX_SEATS)) {
+    dealer_.restoreStrategy(rules_.dealerStrategy);
+    dealer_.setHitSoft17(rules_.dealerHitsSoft17);
+
+    // Выигрыш руки против каждого класса - по тем же правилам, что judgeHand() и wagerResult()
+    for (int score = 0; score <= 21; ++score) {
+        for (int natural = 0; natural < 2; ++natural) {
+            for (int doubled = 0; doubled < 2; ++doubled) {
+                Chips stake = doubled ? 2 * CHIP_SCALE : CHIP_SCALE;
+                for (size_t c = 0; c < CLASSES; ++c) {
+                    RoundOutcome outcome = RoundOutcome::Push;
+                    if (score == 0) {
+                        outcome = RoundOutcome::Loss;
+                    }
+                    else if (c == DEALER_BUST) {
+                        outcome = RoundOutcome::Win;
+                    }
+                    else {
+                        int dealerScore = c == DEALER_NATURAL ? 21 : DEALER_LOWEST + static_cast<int>(c) - 1;
+                        outcome = score > dealerScore ? RoundOutcome::Win :
+                            score < dealerScore ? RoundOutcome::Loss : RoundOutcome::Push;
+                    }
+                    WagerResult result = wagerResult(outcome, natural != 0, c == DEALER_NATURAL);
+                    payoff_[score][natural][doubled][c] = wagerReturn(stake, result) - stake;
+                }
+            }
+        }
+    }
+}
+
+// ==================== РУКИ МЕСТА ====================
+
+void PerfectPlaySolver::addValue(SeatHand& hand, uint8_t value) {
+    // Пара - две карты одного значения, как в Player::canSplit()
+    hand.pairValue = (hand.cards == 1 && hand.points == value) ? value : 0;
+    hand.points = static_cast<uint8_t>(hand.points + value);
+    hand.ace = hand.ace || value == 1;
+    ++hand.cards;
+}
+
+int PerfectPlaySolver::handScore(const SeatHand& hand) {
+    if (hand.points > 21) {
+        return 0;
+    }
+    return (hand.ace && hand.points + 10 <= 21) ? hand.points + 10 : hand.points;
+}
+
+void PerfectPlaySolver::searchSeat(SeatPlay play, size_t position) {
+    // Перебранные руки больше не играют
+    while (play.active < play.count && handScore(play.hands[play.active]) == 0) {
+        ++play.active;
+    }
+    if (play.active == play.count) {
+        recordSeat(play, position);
+        return;
+    }
+
+    const SeatHand& hand = play.hands[play.active];
+    SeatPlay next = play;
+    ++next.active;
+    searchSeat(next, position); // Stand
+
+    if (position >= values_.size()) {
+        return;
+    }
+    next = play;
+    addValue(next.hands[next.active], values_[position]);
+    searchSeat(next, position + 1); // Hit
+
+    if (hand.cards != 2) {
+        return;
+    }
+    next = play;
+    addValue(next.hands[next.active], values_[position]);
+    next.hands[next.active].doubled = true;
+    ++next.active;
+    searchSeat(next, position + 1); // DoubleDown
+
+    // Split: по карте пары в каждую руку, затем по карте из шуза - сначала активной
+    if (hand.pairValue != 0 && play.count < Player::MAX_HANDS && position + 2 <= values_.size()) {
+        next = play;
+        SeatHand single;
+        addValue(single, hand.pairValue);
+        next.hands[next.active] = single;
+        next.hands[next.count] = single;
+        addValue(next.hands[next.active], values_[position]);
+        addValue(next.hands[next.count], values_[position + 1]);
+        ++next.count;
+        searchSeat(next, position + 2);
+    }
+}
+
+void PerfectPlaySolver::recordSeat(const SeatPlay& play, size_t position) {
+    // Блэкджек - только две карты на 21 без Split, как в Player::hasNatural()
+    int natural = (play.count == 1 && play.hands[0].cards == 2 && handScore(play.hands[0]) == 21) ? 1 : 0;
+
+    Chips sum[CLASSES] = {};
+    for (size_t h = 0; h < play.count; ++h) {
+        const SeatHand& hand = play.hands[h];
+        const Chips* payoff = payoff_[handScore(hand)][natural][hand.doubled ? 1 : 0];
+        for (size_t c = 0; c < CLASSES; ++c) {
+            sum[c] += payoff[c];
+        }
+    }
+
+    const Chips* before = &(*from_)[start_ * CLASSES];
+    Chips* after = &(*to_)[position * CLASSES];
+    for (size_t c = 0; c < CLASSES; ++c) {
+        after[c] = std::max(after[c], before[c] + sum[c]);
+    }
+    reachedLow_ = std::min(reachedLow_, position);
+    reachedHigh_ = std::max(reachedHigh_, position);
+}
+
+// ==================== РАУНД И ШУЗ ====================
+
+size_t PerfectPlaySolver::playDealer(size_t position, size_t& end) {
+    dealer_.clearHand();
+    dealer_.addCard(order_[dealerCards_]);
+    dealer_.addCard(order_[dealerCards_ + 1]);
+    while (dealer_.mustDrawCard()) {
+        if (position >= order_.size()) {
+            return CLASSES;
+        }
+        dealer_.addCard(order_[position++]);
+    }
+    end = position;
+
+    if (dealer_.hasNatural()) {
+        return DEALER_NATURAL;
+    }
+    if (dealer_.isBusted()) {
+        return DEALER_BUST;
+    }
+    int score = dealer_.calculateScore();
+    return score < DEALER_LOWEST ? CLASSES : static_cast<size_t>(1 + score - DEALER_LOWEST);
+}
+
+bool PerfectPlaySolver::solveRound(size_t position, size_t seats, Chips& total, Chips& round, size_t& next) {
+    size_t first = position + 2 * seats + 2;
+    if (first > values_.size()) {
+        return false;
+    }
+    dealerCards_ = position + 2 * seats;
+
+    from_ = &layers_[0];
+    to_ = &layers_[1];
+    std::fill_n(from_->begin() + first * CLASSES, CLASSES, Chips(0));
+    size_t low = first;
+    size_t high = first;
+
+    for (size_t seat = 0; seat < seats; ++seat) {
+        SeatPlay play;
+        addValue(play.hands[0], values_[position + 2 * seat]);
+        addValue(play.hands[0], values_[position + 2 * seat + 1]);
+
+        reachedLow_ = std::numeric_limits<size_t>::max();
+        reachedHigh_ = 0;
+        for (size_t q = low; q <= high; ++q) {
+            if ((*from_)[q * CLASSES] != UNREACHED) {
+                start_ = q;
+                searchSeat(play, q);
+            }
+        }
+
+        // Слой до хода места больше не нужен: очищаем только затронутые строки
+        std::fill(from_->begin() + low * CLASSES, from_->begin() + (high + 1) * CLASSES, UNREACHED);
+        std::swap(from_, to_);
+        low = reachedLow_;
+        high = reachedHigh_;
+    }
+
+    // Дилер начинает добор с позиции конца хода мест - его исход известен заранее
+    bool found = false;
+    for (size_t q = low; q <= high; ++q) {
+        const Chips* row = &(*from_)[q * CLASSES];
+        size_t end = 0;
+        size_t dealerClass = row[0] == UNREACHED ? CLASSES : playDealer(q, end);
+        if (dealerClass == CLASSES) {
+            continue;
+        }
+        Chips value = row[dealerClass] + best_[end];
+        if (!found || value > total) {
+            found = true;
+            total = value;
+            round = row[dealerClass];
+            next = end;
+        }
+    }
+    std::fill(from_->begin() + low * CLASSES, from_->begin() + (high + 1) * CLASSES, UNREACHED);
+    return found;
+}
+
+ShoeSolution PerfectPlaySolver::solve(const Deck& shoe) {
+    const std::vector<Card>& cards = shoe.getCards();
+    size_t size = cards.size();
+    order_.assign(cards.rbegin(), cards.rend());
+    values_.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+        values_[i] = static_cast<uint8_t>(order_[i].getValue());
+    }
+
+    // Отрезная карта как в RoundSimulator: раунды начинаются, пока в шузе больше cutCard карт
+    double penetration = std::min(std::max(rules_.penetration, 0.1), 1.0);
+    size_t cutCard = static_cast<size_t>(size * (1.0 - penetration));
+
+    best_.assign(size + 1, 0);
+    bestSeats_.assign(size + 1, 0);
+    bestNext_.assign(size + 1, static_cast<uint16_t>(size));
+    bestRound_.assign(size + 1, 0);
+    layers_[0].assign((size + 1) * CLASSES, UNREACHED);
+    layers_[1].assign((size + 1) * CLASSES, UNREACHED);
+
+    // От конца шуза к началу: раунд с позиции p опирается на уже решенные позиции после него
+    for (size_t p = size + 1; p-- > 0;) {
+        if (size - p <= cutCard) {
+            continue;
+        }
+        for (size_t seats = 1; seats <= maxSeats_; ++seats) {
+            Chips total = 0;
+            Chips round = 0;
+            size_t next = 0;
+            if (solveRound(p, seats, total, round, next) && (bestSeats_[p] == 0 || total > best_[p])) {
+                best_[p] = total;
+                bestSeats_[p] = static_cast<uint8_t>(seats);
+                bestNext_[p] = static_cast<uint16_t>(next);
+                bestRound_[p] = round;
+            }
+        }
+    }
+
+    ShoeSolution solution;
+    solution.result = best_[0];
+    for (size_t p = 0; p < size && bestSeats_[p] != 0; p = bestNext_[p]) {
+        SolvedRound round;
+        round.position = static_cast<uint16_t>(p);
+        round.cards = static_cast<uint16_t>(bestNext_[p] - p);
+        round.seats = bestSeats_[p];
+        round.result = bestRound_[p];
+        solution.rounds.push_back(round);
+    }
+    return solution;
+}
+
+// ==================== ТОЧКА ВХОДА ====================
+
+int runShoeSolver(int argc, char* argv[]) {
+    CommandLine options(argc, argv);
+
+    SolverConfig config;
+    config.rules.deckCount = static_cast<size_t>(options.getInt("decks", static_cast<long long>(config.rules.deckCount)));
+    config.rules.penetration = options.getDouble("penetration", config.rules.penetration);
+    config.maxSeats = static_cast<size_t>(options.getInt("seats", static_cast<long long>(config.maxSeats)));
+    config.shoes = static_cast<uint64_t>(options.getInt("shoes", static_cast<long long>(config.shoes)));
+    config.seed = static_cast<uint32_t>(options.getInt("seed", config.seed));
+    config.showRounds = options.has("rounds");
+
+    // Шузы из файла: число колод - из файла, по умолчанию все шузы файла
+    ShoeCorpus corpus;
+    if (options.has("corpus")) {
+        std::string error;
+        if (!corpus.open(options.getString("corpus", ""), error)) {
+            std::cerr << "Cannot open corpus: " << error << "\n";
+            return 1;
+        }
+        config.rules.deckCount = corpus.getDeckCount();
+        if (!options.has("shoes")) {
+            config.shoes = corpus.getShoeCount();
+        }
+    }
+
+    bool valid = parseDealerStrategy(options.getString("dealer", "standard"), config.rules.dealerStrategy);
+    valid = valid && parsePlayerPolicy(options.getString("player", "basic"), config.rules.playerPolicy);
+    std::string soft17 = options.getString("soft17", "stand");
+    if (soft17 == "hit") config.rules.dealerHitsSoft17 = true;
+    else if (soft17 != "stand") valid = false;
+
+    // Позиции в шузе хранятся в 16 битах
+    if (!valid || config.rules.deckCount < 1 || config.rules.deckCount > 16 ||
+        config.maxSeats < 1 || config.maxSeats > Table::MAX_SEATS || config.shoes == 0 ||
+        (corpus.isOpen() && (config.shoes > corpus.getShoeCount() ||
+            (options.has("decks") && options.getInt("decks", 0) != static_cast<long long>(corpus.getDeckCount()))))) {
+        std::cerr << "Usage: --solve [--decks 6] [--dealer standard|aggressive|cautious] [--soft17 stand|hit]"
+            " [--seats 1-" << Table::MAX_SEATS << "] [--penetration 0.75] [--player basic|mimic|never-bust]"
+            " [--shoes N] [--seed N] [--corpus file] [--rounds]\n"
+            "With --corpus: --shoes up to the corpus size, --decks as in the corpus\n";
+        return 1;
+    }
+
+    PerfectPlaySolver solver(config.rules, config.maxSeats);
+    RoundSimulator simulator(config.rules);
+    Deck shoe(config.rules.deckCount);
+
+    Chips perfectTotal = 0;
+    Chips policyTotal = 0;
+    uint64_t perfectRounds = 0;
+    uint64_t policyRounds = 0;
+    uint64_t seatRounds[Table::MAX_SEATS + 1] = {};
+    double seconds = 0.0;
+    ShoeSolution solution;
+
+    for (uint64_t i = 0; i < config.shoes; ++i) {
+        std::seed_seq sequence{ config.seed, static_cast<uint32_t>(i), static_cast<uint32_t>(i >> 32) };
+        std::mt19937 generator(sequence);
+        if (corpus.isOpen()) {
+            if (!corpus.loadShoe(i, shoe)) {
+                std::cerr << "Corpus shoe " << i << " is corrupt\n";
+                return 1;
+            }
+        }
+        else {
+            shoe = Deck(config.rules.deckCount);
+            shoe.shuffle(generator);
+        }
+
+        auto started = std::chrono::steady_clock::now();
+        solution = solver.solve(shoe);
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+        perfectTotal += solution.result;
+        perfectRounds += solution.rounds.size();
+        for (const SolvedRound& round : solution.rounds) {
+            ++seatRounds[round.seats];
+        }
+
+        // Та же последовательность карт стратегией игрока на одном месте
+        simulator.loadShoe(shoe);
+        while (!simulator.needsShuffle()) {
+            size_t before = simulator.getShoe().size();
+            Chips net = simulator.playRound(CHIP_SCALE, Chips(1) << 50, generator);
+            if (simulator.getShoe().size() > before) {
+                break; // Шуз кончился посреди раунда - такой раунд не играет и решатель
+            }
+            policyTotal += net;
+            ++policyRounds;
+        }
+    }
+
+    double scale = static_cast<double>(CHIP_SCALE);
+    double shoes = static_cast<double>(config.shoes);
+    std::cout << "\n=== PERFECT-INFORMATION SHOE SOLVER ===\n";
+    std::cout << "Decks: " << config.rules.deckCount << " | Dealer: " << dealerStrategyName(config.rules.dealerStrategy)
+        << (config.rules.dealerHitsSoft17 ? " H17" : " S17") << " | Penetration: " << std::fixed
+        << std::setprecision(0) << config.rules.penetration * 100.0 << "% | Seats: 1-" << config.maxSeats
+        << " | Shoes: " << config.shoes << "\n";
+    std::cout << std::setprecision(3) << "Solve time: " << seconds << " s (" << seconds / shoes * 1000.0
+        << " ms per shoe)\n\n";
+
+    std::cout << std::left << std::setw(22) << "Play" << std::right << std::setw(14) << "Units/shoe"
+        << std::setw(14) << "Rounds/shoe" << std::setw(14) << "Units/round" << "\n";
+    std::cout << std::setprecision(2) << std::left << std::setw(22) << "Perfect information" << std::right
+        << std::setw(14) << perfectTotal / scale / shoes << std::setw(14) << perfectRounds / shoes
+        << std::setw(14) << (perfectRounds > 0 ? perfectTotal / scale / perfectRounds : 0.0) << "\n";
+    std::cout << std::left << std::setw(22) << (std::string(playerPolicyName(config.rules.playerPolicy)) + ", 1 seat")
+        << std::right << std::setw(14) << policyTotal / scale / shoes << std::setw(14) << policyRounds / shoes
+        << std::setw(14) << (policyRounds > 0 ? policyTotal / scale / policyRounds : 0.0) << "\n";
+
+    std::cout << "\nSeats per round (perfect play):";
+    for (size_t seats = 1; seats <= config.maxSeats; ++seats) {
+        std::cout << "  " << seats << ": " << std::setprecision(1)
+            << (perfectRounds > 0 ? 100.0 * seatRounds[seats] / perfectRounds : 0.0) << "%";
+    }
+    std::cout << "\n";
+
+    // Раунды лучшей игры последнего (единственного) шуза
+    if (config.showRounds && config.shoes == 1) {
+        std::cout << "\n" << std::setw(6) << "Round" << std::setw(8) << "Cards" << std::setw(7) << "Seats"
+            << std::setw(10) << "Units" << "\n";
+        for (size_t r = 0; r < solution.rounds.size(); ++r) {
+            const SolvedRound& round = solution.rounds[r];
+            std::cout << std::setw(6) << r + 1 << std::setw(8)
+                << (std::to_string(round.position + 1) + "-" + std::to_string(round.position + round.cards))
+                << std::setw(7) << static_cast<int>(round.seats) << std::setw(10) << std::setprecision(1)
+                << round.result / scale << "\n";
+        }
+    }
+    return 0;
+}
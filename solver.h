@@ -0,0 +1,172 @@
+#pragma once
+#include "dealer.h"
+#include "deck.h"
+#include "ledger.h"
+#include "simulator.h"
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// ==================== ИГРА С ПОЛНОЙ ИНФОРМАЦИЕЙ ====================
+
+/**
+ * @brief Параметры решателя
+ */
+struct SolverConfig {
+    SimulationRules rules;   ///< Правила стола (колоды, дилер, отрезная карта; стратегия - для сравнения)
+    size_t maxSeats = 4;     ///< Наибольшее число мест за раунд (1..Table::MAX_SEATS)
+    uint64_t shoes = 1;      ///< Решаемых шузов
+    uint32_t seed = 1;       ///< Зерно (шуз i - свой поток чисел от seed и i)
+    bool showRounds = false; ///< Печатать раунды лучшей игры (только для одного шуза)
+};
+
+/**
+ * @brief Раунд лучшей игры
+ */
+struct SolvedRound {
+    uint16_t position = 0; ///< Первая карта раунда (0 - верхняя карта шуза)
+    uint16_t cards = 0;    ///< Карт раунда (с добором дилера)
+    uint8_t seats = 0;     ///< Мест в раунде
+    Chips result = 0;      ///< Выигрыш за раунд
+};
+
+/**
+ * @brief Лучшая игра одного шуза
+ */
+struct ShoeSolution {
+    Chips result = 0;                ///< Наибольший выигрыш за шуз (ставка CHIP_SCALE на место)
+    std::vector<SolvedRound> rounds; ///< Раунды лучшей игры по порядку
+};
+
+/**
+ * @brief Наибольший выигрыш за шуз с известным порядком карт
+ *
+ * Игрок знает весь порядок карт и выбирает число мест в каждом раунде
+ * (1..maxSeats, ставка CHIP_SCALE на место) и каждое действие каждой
+ * руки по правилам RoundSimulator: Hit и Stand на любой неперебранной
+ * руке, удвоение на двух картах, Split пары до Player::MAX_HANDS рук.
+ * Раздача как в Game и Table: по две карты местам по порядку, затем две
+ * дилеру; дилер добирает по своей стратегии всегда. Раунды начинаются,
+ * пока не дошли до отрезной карты; раунд, которому не хватает карт шуза,
+ * не играется.
+ *
+ * Динамика по позиции в шузе: лучший итог с позиции p - наибольшая сумма
+ * выигрыша раунда с p и лучшего итога с позиции после него. Таблица - один
+ * непрерывный массив по позициям, каждая считается один раз (от конца шуза).
+ *
+ * Внутри раунда исход дилера зависит только от позиции, с которой он
+ * начинает добирать, поэтому места решаются слоями: для каждой позиции
+ * конца хода мест и каждого класса исхода дилера (перебор, 16..21,
+ * блэкджек) - лучшая сумма выигрыша уже сыгравших мест. Место перебирает
+ * свои варианты игры с каждой достижимой позиции начала; рука хранится
+ * в нескольких байтах (очки с тузами за 1, есть ли туз, карт, пара,
+ * удвоение), слои - плоские массивы [позиция][класс].
+ */
+class PerfectPlaySolver {
+public:
+    static constexpr size_t CLASSES = 8; ///< Классов исхода дилера: перебор, 16..21, блэкджек
+
+    /**
+     * @brief Конструктор
+     * @param rules Правила стола
+     * @param maxSeats Наибольшее число мест за раунд
+     */
+    PerfectPlaySolver(const SimulationRules& rules, size_t maxSeats);
+
+    /**
+     * @brief Решить шуз
+     * @param shoe Шуз в порядке выдачи (верхняя карта - последняя в getCards())
+     * @return Лучший итог и его раунды
+     */
+    ShoeSolution solve(const Deck& shoe);
+
+private:
+    /**
+     * @brief Рука места в сжатом виде
+     */
+    struct SeatHand {
+        uint8_t points = 0;    ///< Очки, тузы за 1
+        uint8_t cards = 0;     ///< Карт
+        uint8_t pairValue = 0; ///< Значение пары на двух картах (0 - не пара)
+        bool ace = false;      ///< Есть туз
+        bool doubled = false;  ///< Ставка удвоена
+    };
+
+    /**
+     * @brief Все руки места по ходу игры
+     */
+    struct SeatPlay {
+        SeatHand hands[Player::MAX_HANDS]; ///< Руки (используются первые count)
+        uint8_t count = 1;                 ///< Рук
+        uint8_t active = 0;                ///< Играемая рука
+    };
+
+    /**
+     * @brief Лучшая игра раунда с позиции вместе с лучшим итогом после него
+     * @param seats Мест в раунде
+     * @param total [out] Выигрыш раунда плюс лучший итог с позиции после него
+     * @param round [out] Выигрыш самого раунда
+     * @param next [out] Позиция после раунда
+     * @return false если раунду не хватает карт
+     */
+    bool solveRound(size_t position, size_t seats, Chips& total, Chips& round, size_t& next);
+
+    /**
+     * @brief Перебрать игру места с текущей позиции и обновить следующий слой
+     * @param play Руки места
+     * @param position Следующая карта шуза
+     */
+    void searchSeat(SeatPlay play, size_t position);
+
+    /**
+     * @brief Добавить карту в руку
+     * @param value Значение карты (туз - 1)
+     */
+    static void addValue(SeatHand& hand, uint8_t value);
+
+    /**
+     * @brief Записать итог руки места в следующий слой
+     */
+    void recordSeat(const SeatPlay& play, size_t position);
+
+    /**
+     * @brief Очки руки (0 - перебор)
+     */
+    static int handScore(const SeatHand& hand);
+
+    /**
+     * @brief Класс исхода дилера, начинающего добор с позиции
+     * @param end [out] Позиция после добора дилера
+     * @return Класс или CLASSES, если картам шуза не хватило
+     */
+    size_t playDealer(size_t position, size_t& end);
+
+    SimulationRules rules_;      ///< Правила
+    size_t maxSeats_ = 1;        ///< Наибольшее число мест
+    Dealer dealer_;              ///< Дилер по правилам стола (для добора)
+    std::vector<Card> order_;    ///< Карты в порядке выдачи
+    std::vector<uint8_t> values_; ///< Значения карт в порядке выдачи (туз - 1)
+    size_t dealerCards_ = 0;     ///< Позиция первой карты дилера в текущем раунде
+
+    std::vector<Chips> best_;        ///< Лучший итог с позиции
+    std::vector<uint8_t> bestSeats_; ///< Мест в первом раунде лучшей игры с позиции (0 - шуз закончен)
+    std::vector<uint16_t> bestNext_; ///< Позиция после этого раунда
+    std::vector<Chips> bestRound_;   ///< Выигрыш этого раунда
+
+    std::vector<Chips> layers_[2];     ///< Слои мест: [позиция * CLASSES + класс]
+    std::vector<Chips>* from_ = nullptr; ///< Слой до хода места
+    std::vector<Chips>* to_ = nullptr;   ///< Слой после хода места
+    size_t start_ = 0;               ///< Позиция начала хода места (строка from_)
+    size_t reachedLow_ = 0;          ///< Наименьшая позиция, записанная в to_
+    size_t reachedHigh_ = 0;         ///< Наибольшая позиция, записанная в to_
+
+    /// Выигрыш руки по классу исхода дилера: [очки 0..21][блэкджек][удвоение][класс]
+    Chips payoff_[22][2][2][CLASSES] = {};
+};
+
+/**
+ * @brief Точка входа режима --solve
+ * @return Код завершения
+ */
+int runShoeSolver(int argc, char* argv[]);
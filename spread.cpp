@@ -0,0 +1,310 @@
+#include "spread.h"
+#include "options.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+// ==================== ИСХОДЫ ПО СЧЕТУ ====================
+
+int CountOutcomeTable::bucketOf(double trueCount) {
+    int floored = static_cast<int>(std::floor(trueCount));
+    return std::min(std::max(floored, MIN_COUNT), MAX_COUNT);
+}
+
+void CountOutcomeTable::merge(const CountOutcomeTable& other) {
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        buckets_[i].merge(other.buckets_[i]);
+    }
+}
+
+uint64_t CountOutcomeTable::getRounds() const {
+    uint64_t rounds = 0;
+    for (const auto& bucket : buckets_) {
+        rounds += bucket.getCount();
+    }
+    return rounds;
+}
+
+namespace {
+    /**
+     * @brief Выигрыш и дисперсия за раунд по суммам групп и ставкам групп
+     */
+    RampScore scoreSums(double rounds, double sum, double sumSquares, double betSum, double bankrollUnits) {
+        RampScore score;
+        if (rounds <= 0.0) {
+            return score;
+        }
+        score.winRate = sum / rounds;
+        score.variance = std::max(sumSquares / rounds - score.winRate * score.winRate, 0.0);
+        score.averageBet = betSum / rounds;
+        if (score.winRate > 0.0 && score.variance > 0.0) {
+            score.riskOfRuin = std::exp(-2.0 * score.winRate * bankrollUnits / score.variance);
+        }
+        return score;
+    }
+}
+
+RampScore scoreRamp(const CountOutcomeTable& table, const BettingRamp& ramp, double bankrollUnits) {
+    double scale = static_cast<double>(CHIP_SCALE);
+    double rounds = 0.0, sum = 0.0, sumSquares = 0.0, betSum = 0.0;
+    for (int count = CountOutcomeTable::MIN_COUNT; count <= CountOutcomeTable::MAX_COUNT; ++count) {
+        const RunningStats& bucket = table.getBucket(count);
+        double bet = ramp.betFor(count) / scale;
+        double n = static_cast<double>(bucket.getCount());
+        rounds += n;
+        sum += bet * bucket.getSum() / scale;
+        sumSquares += bet * bet * static_cast<double>(bucket.getSumSquares()) / scale / scale;
+        betSum += bet * n;
+    }
+    return scoreSums(rounds, sum, sumSquares, betSum, bankrollUnits);
+}
+
+// ==================== ОПТИМИЗАТОР ====================
+
+BetSpreadOptimizer::BetSpreadOptimizer(const SpreadConfig& config)
+    : config_(config) {
+    if (config_.threads == 0) {
+        config_.threads = std::thread::hardware_concurrency();
+    }
+    if (config_.threads == 0) config_.threads = 1;
+    if (config_.threads > config_.shoes) config_.threads = static_cast<size_t>(config_.shoes);
+    if (config_.threads == 0) config_.threads = 1;
+}
+
+void BetSpreadOptimizer::simulate() {
+    // Шузы раздаются пачками, как траектории в BankrollSimulator
+    constexpr uint64_t CHUNK = 256;
+    std::atomic<uint64_t> next(0);
+    std::vector<CountOutcomeTable> partial(config_.threads);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < config_.threads; ++t) {
+        workers.emplace_back([this, &next, &partial, t]() {
+            RoundSimulator simulator(config_.rules);
+            uint64_t begin;
+            while ((begin = next.fetch_add(CHUNK)) < config_.shoes) {
+                uint64_t end = std::min(begin + CHUNK, config_.shoes);
+                for (uint64_t index = begin; index < end; ++index) {
+                    playShoe(index, simulator, partial[t]);
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    simulateSeconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    table_ = CountOutcomeTable();
+    for (const auto& table : partial) {
+        table_.merge(table);
+    }
+}
+
+void BetSpreadOptimizer::playShoe(uint64_t index, RoundSimulator& simulator, CountOutcomeTable& table) const {
+    std::seed_seq sequence{ config_.seed, static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32) };
+    std::mt19937 generator(sequence);
+    simulator.shuffle(generator);
+
+    // Ровная ставка без ограничения банкролла: исход любой другой ставки ему пропорционален
+    while (!simulator.needsShuffle()) {
+        double trueCount = simulator.getShoe().getTrueCount();
+        table.record(trueCount, simulator.playRound(CHIP_SCALE, Chips(1) << 50, generator));
+    }
+}
+
+uint64_t BetSpreadOptimizer::search() {
+    auto start = std::chrono::steady_clock::now();
+    double scale = static_cast<double>(CHIP_SCALE);
+
+    // Группы корзин: ниже первого порога (ставка 1), по порогу на группу, последняя - все выше
+    size_t steps = static_cast<size_t>(config_.lastStep - config_.firstStep + 1);
+    std::vector<double> rounds(steps + 1, 0.0), sums(steps + 1, 0.0), squares(steps + 1, 0.0);
+    for (int count = CountOutcomeTable::MIN_COUNT; count <= CountOutcomeTable::MAX_COUNT; ++count) {
+        const RunningStats& bucket = table_.getBucket(count);
+        size_t group = count < config_.firstStep ? 0
+            : static_cast<size_t>(std::min(count, config_.lastStep) - config_.firstStep + 1);
+        double n = static_cast<double>(bucket.getCount());
+        rounds[group] += n;
+        sums[group] += bucket.getSum() / scale;
+        squares[group] += static_cast<double>(bucket.getSumSquares()) / scale / scale;
+    }
+    double totalRounds = 0.0;
+    for (double n : rounds) totalRounds += n;
+
+    best_.clear();
+    candidates_ = 0;
+    std::vector<int> bets(steps + 1, 1);
+
+    // Перебор неубывающих ставок в глубину: частичные суммы несут вклад уже выбранных групп
+    auto consider = [&](double sum, double sumSquares, double betSum) {
+        ++candidates_;
+        RampScore score = scoreSums(totalRounds, sum, sumSquares, betSum, config_.bankrollUnits);
+        if (score.riskOfRuin > config_.maxRiskOfRuin) {
+            return;
+        }
+        if (best_.size() == config_.top && score.winRate <= best_.back().score.winRate) {
+            return;
+        }
+
+        std::ostringstream ramp;
+        ramp << bets[0];
+        for (size_t group = 1; group <= steps; ++group) {
+            if (bets[group] != bets[group - 1]) {
+                ramp << "," << config_.firstStep + static_cast<int>(group) - 1 << ":" << bets[group];
+            }
+        }
+        SpreadCandidate candidate{ ramp.str(), score };
+        auto position = std::find_if(best_.begin(), best_.end(), [&score](const SpreadCandidate& other) {
+            return score.winRate > other.score.winRate;
+        });
+        best_.insert(position, candidate);
+        if (best_.size() > config_.top) {
+            best_.pop_back();
+        }
+    };
+
+    std::function<void(size_t, double, double, double)> descend =
+        [&](size_t group, double sum, double sumSquares, double betSum) {
+        if (group > steps) {
+            consider(sum, sumSquares, betSum);
+            return;
+        }
+        for (int bet = bets[group - 1]; bet <= config_.maxSpread; ++bet) {
+            bets[group] = bet;
+            descend(group + 1, sum + bet * sums[group], sumSquares + double(bet) * bet * squares[group],
+                betSum + bet * rounds[group]);
+        }
+    };
+    descend(1, sums[0], squares[0], rounds[0]);
+
+    searchSeconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return candidates_;
+}
+
+void BetSpreadOptimizer::printReport(std::ostream& os) const {
+    static const char* STRATEGY_NAMES[] = { "Standard (stops at 17+)", "Aggressive (stops at 18+)", "Cautious (stops at 16+)" };
+
+    double scale = static_cast<double>(CHIP_SCALE);
+    double rounds = static_cast<double>(table_.getRounds());
+
+    os << "\n=== BET SPREAD OPTIMIZER ===\n";
+    os << std::fixed << std::setprecision(2);
+    os << "Rules: " << config_.rules.deckCount << " decks, penetration "
+        << config_.rules.penetration * 100.0 << "%, dealer "
+        << STRATEGY_NAMES[static_cast<int>(config_.rules.dealerStrategy)]
+        << " | Count: " << config_.rules.countSystem.name << "\n";
+    os << "Simulated: " << config_.shoes << " shoes, " << table_.getRounds() << " rounds in "
+        << simulateSeconds_ << " s (" << std::setprecision(0)
+        << rounds / (simulateSeconds_ > 0.0 ? simulateSeconds_ : 1.0) << " rounds/sec) | Threads: "
+        << config_.threads << "\n";
+    os << std::setprecision(2);
+    os << "Constraint: risk of ruin <= " << config_.maxRiskOfRuin * 100.0 << "% with "
+        << config_.bankrollUnits << " units | Spread 1-" << config_.maxSpread
+        << " | Steps at TC " << config_.firstStep << ".." << config_.lastStep << "\n";
+
+    os << "\nTC        Rounds   Freq%   EV/hand    SD\n";
+    for (int count = CountOutcomeTable::MIN_COUNT; count <= CountOutcomeTable::MAX_COUNT; ++count) {
+        const RunningStats& bucket = table_.getBucket(count);
+        if (bucket.getCount() == 0) continue;
+        std::string label = count == CountOutcomeTable::MIN_COUNT ? "<" + std::to_string(count + 1)
+            : count == CountOutcomeTable::MAX_COUNT ? ">=" + std::to_string(count)
+            : std::to_string(count);
+        os << std::left << std::setw(5) << label << std::right
+            << std::setw(11) << bucket.getCount()
+            << std::setw(8) << std::setprecision(2) << 100.0 * bucket.getCount() / (rounds > 0.0 ? rounds : 1.0)
+            << std::setw(10) << std::setprecision(4) << bucket.getMean() / scale
+            << std::setw(8) << std::setprecision(3) << bucket.getStdDev() / scale << "\n";
+    }
+
+    os << "\nScored " << candidates_ << " ramps in " << std::setprecision(3) << searchSeconds_ * 1000.0 << " ms\n";
+    if (best_.empty()) {
+        os << "No ramp meets the risk of ruin constraint - raise --bankroll or --ror, or lower --max-spread\n";
+        return;
+    }
+
+    os << "\n#  " << std::left << std::setw(28) << "Ramp (--ramp)" << std::right
+        << "  Win/100    SD/hand  Avg bet     RoR       N0\n";
+    for (size_t i = 0; i < best_.size(); ++i) {
+        const RampScore& score = best_[i].score;
+        double sd = std::sqrt(score.variance);
+        os << std::left << std::setw(3) << i + 1 << std::setw(28) << best_[i].ramp << std::right
+            << std::setprecision(3) << std::setw(9) << score.winRate * 100.0
+            << std::setw(11) << sd
+            << std::setw(9) << score.averageBet
+            << std::setw(7) << std::setprecision(2) << score.riskOfRuin * 100.0 << "%"
+            << std::setw(9) << std::setprecision(0) << sd * sd / (score.winRate * score.winRate) << "\n";
+    }
+}
+
+// ==================== ТОЧКА ВХОДА ====================
+
+int runSpreadOptimizer(int argc, char* argv[]) {
+    CommandLine options(argc, argv);
+
+    SpreadConfig config;
+    config.shoes = static_cast<uint64_t>(options.getInt("shoes", static_cast<long long>(config.shoes)));
+    config.bankrollUnits = options.getDouble("bankroll", config.bankrollUnits);
+    config.maxRiskOfRuin = options.getDouble("ror", config.maxRiskOfRuin);
+    config.maxSpread = static_cast<int>(options.getInt("max-spread", config.maxSpread));
+    config.firstStep = static_cast<int>(options.getInt("from", config.firstStep));
+    config.lastStep = static_cast<int>(options.getInt("to", config.lastStep));
+    config.top = static_cast<size_t>(options.getInt("top", static_cast<long long>(config.top)));
+    config.threads = static_cast<size_t>(options.getInt("threads", 0));
+    config.seed = static_cast<uint32_t>(options.getInt("seed", config.seed));
+    config.rules.deckCount = static_cast<size_t>(options.getInt("decks", static_cast<long long>(config.rules.deckCount)));
+    config.rules.penetration = options.getDouble("penetration", config.rules.penetration);
+
+    std::string countName = options.getString("count", "hi-lo");
+    const CountSystem* countSystem = findCountSystem(countName);
+    if (!countSystem) {
+        std::cerr << "Unknown count system \"" << countName << "\". Expected hi-lo, hi-opt-1, omega-2 or zen\n";
+        return 1;
+    }
+    config.rules.countSystem = *countSystem;
+
+    if (config.shoes == 0 || config.bankrollUnits <= 0.0 || config.maxRiskOfRuin <= 0.0 ||
+        config.maxSpread < 1 || config.top == 0 || config.rules.deckCount == 0 ||
+        config.firstStep > config.lastStep || config.firstStep <= CountOutcomeTable::MIN_COUNT ||
+        config.lastStep > CountOutcomeTable::MAX_COUNT) {
+        std::cerr << "Usage: --spread [--shoes N] [--bankroll units] [--ror 0-1] [--max-spread units]"
+            " [--from TC] [--to TC] [--top N] [--count system] [--decks N] [--penetration 0-1]"
+            " [--verify trajectories] [--hands N] [--threads N] [--seed N]\n"
+            "Step thresholds must lie in " << CountOutcomeTable::MIN_COUNT + 1 << ".." << CountOutcomeTable::MAX_COUNT << "\n";
+        return 1;
+    }
+
+    BetSpreadOptimizer optimizer(config);
+    optimizer.simulate();
+    optimizer.search();
+    optimizer.printReport(std::cout);
+
+    // Проверка лучшей шкалы полной симуляцией траекторий
+    long long verify = options.getInt("verify", 0);
+    if (verify > 0 && !optimizer.getBest().empty()) {
+        BankrollConfig bankroll;
+        bankroll.rules = config.rules;
+        bankroll.trajectories = static_cast<uint64_t>(verify);
+        bankroll.hands = static_cast<uint64_t>(options.getInt("hands", 10000));
+        bankroll.bankrollUnits = config.bankrollUnits;
+        bankroll.threads = config.threads;
+        bankroll.seed = config.seed;
+        BettingRamp::parse(optimizer.getBest().front().ramp, bankroll.ramp);
+
+        RampScore predicted = scoreRamp(optimizer.getTable(), bankroll.ramp, config.bankrollUnits);
+        std::cout << "\nVerifying ramp " << optimizer.getBest().front().ramp << " (predicted win "
+            << std::setprecision(3) << predicted.winRate * 100.0 << " per 100 hands, risk of ruin "
+            << std::setprecision(2) << predicted.riskOfRuin * 100.0 << "% for unlimited play)\n";
+
+        BankrollSimulator simulator(bankroll);
+        simulator.run();
+        simulator.printReport(std::cout);
+    }
+    return 0;
+}
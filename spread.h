@@ -0,0 +1,151 @@
+#pragma once
+#include "simulator.h"
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// ==================== ИСХОДЫ ПО СЧЕТУ ====================
+
+/**
+ * @brief Выигрыш раунда ровной ставки по истинному счету перед раундом
+ *
+ * Корзина TC - раунды с истинным счетом в [TC, TC + 1), как округление
+ * вниз в BettingRamp::betFor(). Крайние корзины собирают все, что ниже
+ * MIN_COUNT + 1 и не ниже MAX_COUNT. Исход раунда пропорционален ставке,
+ * поэтому по суммам корзин выигрыш и дисперсия любой шкалы с порогами
+ * внутри диапазона считаются без новой симуляции.
+ */
+class CountOutcomeTable {
+public:
+    static constexpr int MIN_COUNT = -10; ///< Нижняя корзина
+    static constexpr int MAX_COUNT = 12;  ///< Верхняя корзина
+    static constexpr size_t BUCKETS = MAX_COUNT - MIN_COUNT + 1;
+
+    /**
+     * @brief Корзина истинного счета
+     */
+    static int bucketOf(double trueCount);
+
+    /**
+     * @brief Учесть раунд
+     * @param trueCount Истинный счет перед раундом
+     * @param net Выигрыш при ставке в одну единицу (Chips)
+     */
+    void record(double trueCount, Chips net) { buckets_[bucketOf(trueCount) - MIN_COUNT].add(net); }
+
+    /**
+     * @brief Добавить таблицу другого потока
+     */
+    void merge(const CountOutcomeTable& other);
+
+    const RunningStats& getBucket(int trueCount) const { return buckets_[trueCount - MIN_COUNT]; }
+    uint64_t getRounds() const;
+
+private:
+    RunningStats buckets_[BUCKETS]; ///< Исходы по корзинам
+};
+
+/**
+ * @brief Оценка шкалы ставок по таблице исходов
+ */
+struct RampScore {
+    double winRate = 0.0;     ///< Выигрыш за раунд, единиц
+    double variance = 0.0;    ///< Дисперсия выигрыша за раунд, единиц^2
+    double riskOfRuin = 1.0;  ///< Риск разорения при бесконечной игре (диффузия)
+    double averageBet = 0.0;  ///< Средняя ставка, единиц
+};
+
+/**
+ * @brief Оценить шкалу по таблице исходов
+ * @param table Исходы ровной ставки по счету
+ * @param ramp Шкала (пороги - внутри диапазона таблицы)
+ * @param bankrollUnits Банкролл в единицах ставки
+ *
+ * Риск разорения - exp(-2 * выигрыш * банкролл / дисперсия): броуновское
+ * приближение, раунды считаются независимыми
+ */
+RampScore scoreRamp(const CountOutcomeTable& table, const BettingRamp& ramp, double bankrollUnits);
+
+// ==================== ОПТИМИЗАТОР ====================
+
+/**
+ * @brief Параметры оптимизатора шкалы
+ */
+struct SpreadConfig {
+    SimulationRules rules;         ///< Правила стола и система счета
+    uint64_t shoes = 200000;       ///< Шузов в симуляции исходов
+    double bankrollUnits = 1000.0; ///< Банкролл в единицах ставки
+    double maxRiskOfRuin = 0.05;   ///< Допустимый риск разорения
+    int maxSpread = 12;            ///< Наибольшая ставка, единиц (наименьшая - 1)
+    int firstStep = 1;             ///< Первый порог шкалы (ниже - 1 единица)
+    int lastStep = 6;              ///< Последний порог шкалы
+    size_t top = 5;                ///< Лучших шкал в отчете
+    size_t threads = 0;            ///< Рабочих потоков (0 - по числу ядер)
+    uint32_t seed = 1;             ///< Зерно (шуз i - свой поток чисел от seed и i)
+};
+
+/**
+ * @brief Найденная шкала
+ */
+struct SpreadCandidate {
+    std::string ramp;  ///< Шкала в формате --ramp
+    RampScore score;   ///< Оценка
+};
+
+/**
+ * @brief Поиск шкалы ставок с наибольшим выигрышем при ограничении риска разорения
+ *
+ * Шузы играются один раз ровной ставкой на всех ядрах (шуз i засеян
+ * от (seed, i), итог не зависит от числа потоков), исходы копятся
+ * в CountOutcomeTable. Затем перебираются все неубывающие шкалы
+ * с целыми ставками 1..maxSpread на порогах firstStep..lastStep: каждая
+ * оценивается перевзвешиванием сумм корзин за O(порогов), так что
+ * десятки тысяч шкал проверяются за миллисекунды.
+ */
+class BetSpreadOptimizer {
+public:
+    explicit BetSpreadOptimizer(const SpreadConfig& config);
+
+    /**
+     * @brief Сыграть шузы и заполнить таблицу исходов
+     */
+    void simulate();
+
+    /**
+     * @brief Перебрать шкалы
+     * @return Число оцененных шкал
+     */
+    uint64_t search();
+
+    /**
+     * @brief Отчет: исходы по счету и лучшие шкалы
+     */
+    void printReport(std::ostream& os) const;
+
+    const CountOutcomeTable& getTable() const { return table_; }
+    const std::vector<SpreadCandidate>& getBest() const { return best_; }
+
+private:
+    /**
+     * @brief Сыграть шуз до отрезной карты
+     */
+    void playShoe(uint64_t index, RoundSimulator& simulator, CountOutcomeTable& table) const;
+
+    SpreadConfig config_;                ///< Параметры
+    CountOutcomeTable table_;            ///< Исходы после слияния потоков
+    std::vector<SpreadCandidate> best_;  ///< Лучшие шкалы по убыванию выигрыша
+    uint64_t candidates_ = 0;            ///< Оценено шкал
+    double simulateSeconds_ = 0.0;       ///< Время симуляции
+    double searchSeconds_ = 0.0;         ///< Время перебора
+};
+
+/**
+ * @brief Точка входа режима подбора шкалы ставок (--spread)
+ * @param argc Число аргументов
+ * @param argv Аргументы: --shoes, --bankroll (единиц), --ror, --max-spread, --from, --to,
+ *             --top, --count, --decks, --penetration, --verify (траекторий), --hands,
+ *             --threads, --seed
+ * @return 0 при успехе
+ */
+int runSpreadOptimizer(int argc, char* argv[]);
@@ -0,0 +1,154 @@
+#include "strategy.h"
+
+// ==================== ОПИСАНИЕ РУКИ ====================
+
+/**
+ * @brief Накопить описание руки по значениям карт (туз = 1)
+ */
+static HandSummary summarizeValues(const int* values, size_t count) {
+    HandSummary summary;
+    bool hasAce = false;
+
+    for (size_t i = 0; i < count; ++i) {
+        summary.score += values[i];
+        hasAce = hasAce || values[i] == 1;
+    }
+
+    // Один туз как 11 - та же логика что и в Player::calculateScore()
+    if (hasAce && summary.score + 10 <= 21) {
+        summary.score += 10;
+        summary.soft = true;
+    }
+
+    if (count == 2 && values[0] == values[1]) {
+        summary.pairValue = (values[0] == 1) ? 11 : values[0];
+    }
+    return summary;
+}
+
+HandSummary summarizeHand(const std::vector<Card>& hand) {
+    int values[32];
+    size_t count = 0;
+    for (const auto& card : hand) {
+        if (count == 32) break;
+        values[count++] = card.getValue();
+    }
+    return summarizeValues(values, count);
+}
+
+HandSummary summarizeHandCodes(const uint8_t* cardCodes, size_t count) {
+    int values[32];
+    size_t used = 0;
+    for (size_t i = 0; i < count && used < 32; ++i) {
+        Card card(Suit::Hearts, Rank::Two);
+        if (decodeCard(cardCodes[i], card)) {
+            values[used++] = card.getValue();
+        }
+    }
+    return summarizeValues(values, used);
+}
+
+int upcardValue(const Card& card) {
+    return card.isAce() ? 11 : card.getValue();
+}
+
+// ==================== ТАБЛИЦЫ СТРАТЕГИИ ====================
+
+/**
+ * @brief Удвоение если оно допустимо, иначе запасное действие
+ */
+static PlayerAction doubleOr(PlayerAction fallback, LegalActions legalActions) {
+    return legalActions.contains(PlayerAction::DoubleDown) ? PlayerAction::DoubleDown : fallback;
+}
+
+/**
+ * @brief Нужно ли разделять пару против открытой карты дилера
+ */
+static bool shouldSplit(int pairValue, int up) {
+    switch (pairValue) {
+    case 11: return true;                               // Тузы
+    case 8:  return true;                               // Восьмерки
+    case 10: return false;                              // Десятки
+    case 9:  return (up >= 2 && up <= 9 && up != 7);    // Кроме 7, 10, A
+    case 7:  return up <= 7;
+    case 6:  return up <= 6;
+    case 5:  return false;                              // Играется как жесткие 10
+    case 4:  return up == 5 || up == 6;
+    case 3:
+    case 2:  return up <= 7;
+    default: return false;
+    }
+}
+
+PlayerAction basicStrategyAction(const HandSummary& hand, int up, LegalActions legalActions) {
+    if (legalActions.empty()) {
+        return PlayerAction::Stand;
+    }
+
+    if (hand.pairValue != 0 && legalActions.contains(PlayerAction::Split) &&
+        shouldSplit(hand.pairValue, up)) {
+        return PlayerAction::Split;
+    }
+
+    int score = hand.score;
+
+    // Мягкие руки
+    if (hand.soft) {
+        if (score >= 19) return PlayerAction::Stand;
+        if (score == 18) {
+            if (up >= 3 && up <= 6) return doubleOr(PlayerAction::Stand, legalActions);
+            return (up <= 8) ? PlayerAction::Stand : PlayerAction::Hit;
+        }
+        if (score == 17 && up >= 3 && up <= 6) return doubleOr(PlayerAction::Hit, legalActions);
+        if ((score == 15 || score == 16) && up >= 4 && up <= 6) return doubleOr(PlayerAction::Hit, legalActions);
+        if ((score == 13 || score == 14) && up >= 5 && up <= 6) return doubleOr(PlayerAction::Hit, legalActions);
+        return PlayerAction::Hit;
+    }
+
+    // Жесткие руки
+    if (score >= 17) return PlayerAction::Stand;
+    if (score >= 13) return (up <= 6) ? PlayerAction::Stand : PlayerAction::Hit;
+    if (score == 12) return (up >= 4 && up <= 6) ? PlayerAction::Stand : PlayerAction::Hit;
+    if (score == 11) return (up <= 10) ? doubleOr(PlayerAction::Hit, legalActions) : PlayerAction::Hit;
+    if (score == 10) return (up <= 9) ? doubleOr(PlayerAction::Hit, legalActions) : PlayerAction::Hit;
+    if (score == 9) return (up >= 3 && up <= 6) ? doubleOr(PlayerAction::Hit, legalActions) : PlayerAction::Hit;
+    return PlayerAction::Hit;
+}
+
+PlayerAction basicStrategyAction(const Player& player, const Card& dealerUpcard) {
+    return basicStrategyAction(summarizeHand(player.getHand()), upcardValue(dealerUpcard),
+        player.getLegalActions());
+}
+
+// ==================== СТРАТЕГИИ СИМУЛЯЦИЙ ====================
+
+PlayerAction policyAction(PlayerPolicy policy, const HandSummary& hand, int up, LegalActions legalActions) {
+    switch (policy) {
+    case PlayerPolicy::MimicDealer:
+        // Правило дилера Standard: мягкие 17 тоже стоят
+        return hand.score < 17 ? PlayerAction::Hit : PlayerAction::Stand;
+    case PlayerPolicy::NeverBust:
+        if (hand.soft) {
+            return hand.score < 18 ? PlayerAction::Hit : PlayerAction::Stand;
+        }
+        return hand.score <= 11 ? PlayerAction::Hit : PlayerAction::Stand;
+    default:
+        return basicStrategyAction(hand, up, legalActions);
+    }
+}
+
+bool parsePlayerPolicy(const std::string& name, PlayerPolicy& policy) {
+    if (name == "basic") policy = PlayerPolicy::Basic;
+    else if (name == "mimic") policy = PlayerPolicy::MimicDealer;
+    else if (name == "never-bust") policy = PlayerPolicy::NeverBust;
+    else return false;
+    return true;
+}
+
+const char* playerPolicyName(PlayerPolicy policy) {
+    switch (policy) {
+    case PlayerPolicy::MimicDealer: return "mimic";
+    case PlayerPolicy::NeverBust:   return "never-bust";
+    default:                        return "basic";
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "player.h"
+#include "protocol.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Краткое описание руки для принятия решений
+ */
+struct HandSummary {
+    int score = 0;       ///< Лучший счет руки (как Player::calculateScore)
+    bool soft = false;   ///< Туз считается как 11
+    int pairValue = 0;   ///< Значение пары (0 если рука не пара)
+};
+
+/**
+ * @brief Получить описание руки из карт
+ * @param hand Карты руки
+ * @return Счет, мягкость и пара
+ */
+HandSummary summarizeHand(const std::vector<Card>& hand);
+
+/**
+ * @brief Получить описание руки из кодов карт протокола
+ * @param cardCodes Коды карт (см. encodeCard)
+ * @param count Число карт
+ * @return Счет, мягкость и пара
+ */
+HandSummary summarizeHandCodes(const uint8_t* cardCodes, size_t count);
+
+/**
+ * @brief Значение открытой карты дилера для таблиц стратегии
+ * @param card Карта
+ * @return 2-10, туз = 11
+ */
+int upcardValue(const Card& card);
+
+/**
+ * @brief Базовая стратегия (4-8 колод, дилер стоит на 17, удвоение после Split)
+ * @param hand Описание руки игрока
+ * @param dealerUpValue Значение открытой карты дилера (2-11)
+ * @param legalActions Допустимые действия
+ * @return Рекомендуемое действие из числа допустимых
+ */
+PlayerAction basicStrategyAction(const HandSummary& hand, int dealerUpValue, LegalActions legalActions);
+
+/**
+ * @brief Базовая стратегия для игрока за столом
+ * @param player Игрок
+ * @param dealerUpcard Открытая карта дилера
+ * @return Рекомендуемое действие
+ */
+PlayerAction basicStrategyAction(const Player& player, const Card& dealerUpcard);
+
+/**
+ * @brief Стратегия игрока в симуляциях
+ */
+enum class PlayerPolicy : uint8_t {
+    Basic,       ///< Базовая стратегия (basicStrategyAction)
+    MimicDealer, ///< Как дилер: берет до 17, без удвоений и Split
+    NeverBust    ///< Не рискует перебором: жесткие 12+ стоят, без удвоений и Split
+};
+
+/**
+ * @brief Действие по стратегии игрока
+ * @param policy Стратегия
+ * @param hand Описание руки игрока
+ * @param dealerUpValue Значение открытой карты дилера (2-11)
+ * @param legalActions Допустимые действия
+ * @return Действие из числа допустимых
+ */
+PlayerAction policyAction(PlayerPolicy policy, const HandSummary& hand, int dealerUpValue, LegalActions legalActions);
+
+/**
+ * @brief Разобрать имя стратегии игрока ("basic", "mimic", "never-bust")
+ * @return false если имя неизвестно
+ */
+bool parsePlayerPolicy(const std::string& name, PlayerPolicy& policy);
+
+/**
+ * @brief Имя стратегии игрока для отчетов
+ */
+const char* playerPolicyName(PlayerPolicy policy);
@@ -0,0 +1,622 @@
+#include "sweep.h"
+#include "options.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+#include <thread>
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+// ==================== ОБЩИЕ ШУЗЫ ====================
+
+SharedShoes::SharedShoes(const std::vector<size_t>& deckCounts, const CountSystem& countSystem)
+    : source_(*std::max_element(deckCounts.begin(), deckCounts.end())) {
+    order_.resize(source_.size());
+    for (size_t deckCount : deckCounts) {
+        shoes_.emplace_back(deckCount);
+        shoes_.back().setCountSystem(countSystem);
+    }
+}
+
+void SharedShoes::shuffle(std::mt19937& generator) {
+    // Перестановка каждый раз с тождественной: шуз зависит только от генератора
+    std::iota(order_.begin(), order_.end(), uint16_t(0));
+    std::shuffle(order_.begin(), order_.end(), generator);
+
+    // Колоды source_ идут подряд: карты первых d колод - позиции меньше 52 * d
+    const std::vector<Card>& cards = source_.getCards();
+    for (Deck& shoe : shoes_) {
+        size_t limit = shoe.getDeckCount() * 52;
+        shoe.clear();
+        for (uint16_t position : order_) {
+            if (position < limit) {
+                shoe.addCard(cards[position]);
+            }
+        }
+    }
+}
+
+bool SharedShoes::load(const ShoeCorpus& corpus, uint64_t index) {
+    // Все шузы сетки одного числа колод (проверено в RuleSweep::useCorpus()): первый отказ - на первом
+    for (Deck& shoe : shoes_) {
+        if (!corpus.loadShoe(index, shoe)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ==================== СЕТКА ПРАВИЛ ====================
+
+RuleSweep::RuleSweep(const SweepConfig& config)
+    : config_(config) {
+    if (config_.threads == 0) {
+        config_.threads = std::thread::hardware_concurrency();
+    }
+    if (config_.threads == 0) config_.threads = 1;
+
+    for (size_t deck = 0; deck < config_.deckCounts.size(); ++deck) {
+        for (bool hitSoft17 : config_.hitSoft17) {
+            for (DealerStrategy dealer : config_.dealers) {
+                SweepCell cell;
+                cell.deckIndex = deck;
+                cell.rules.deckCount = config_.deckCounts[deck];
+                cell.rules.penetration = config_.penetration;
+                cell.rules.dealerStrategy = dealer;
+                cell.rules.dealerHitsSoft17 = hitSoft17;
+                cell.rules.playerPolicy = config_.playerPolicy;
+                cells_.push_back(cell);
+            }
+        }
+    }
+}
+
+uint64_t RuleSweep::globalBatch(uint64_t local) const {
+    return config_.shardIndex + local * config_.shardCount;
+}
+
+uint64_t RuleSweep::shardBatches() const {
+    // Пачки всего пространства шузов, которые достаются этой доле: номер % shardCount == shardIndex
+    uint64_t total = (config_.shoes + BATCH_SHOES - 1) / BATCH_SHOES;
+    return total > config_.shardIndex ? (total - config_.shardIndex + config_.shardCount - 1) / config_.shardCount : 0;
+}
+
+uint64_t RuleSweep::shoesInBatches(uint64_t localBatches) const {
+    uint64_t shoes = 0;
+    if (localBatches > 0) {
+        // Неполной может быть только последняя пачка пространства
+        uint64_t last = globalBatch(localBatches - 1);
+        shoes = (localBatches - 1) * BATCH_SHOES + std::min(BATCH_SHOES, config_.shoes - last * BATCH_SHOES);
+    }
+    return shoes;
+}
+
+bool RuleSweep::run(std::string& error) {
+    uint64_t totalBatches = shardBatches();
+    std::atomic<uint64_t> next(batchesMerged_);
+    std::atomic<bool> stop(false);
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::map<uint64_t, std::vector<RunningStats>> pending; ///< Сданные пачки, еще не слитые по порядку
+    uint64_t badShoe = UINT64_MAX;                          ///< Первый неразложившийся шуз файла
+
+    // Контрольная точка могла быть записана уже после достижения цели
+    targetReached_ = config_.target > 0.0 && batchesMerged_ >= MIN_BATCHES && worstHalfWidth() <= config_.target;
+    if (targetReached_ || batchesMerged_ >= totalBatches) {
+        stop = true;
+    }
+
+    double previousSeconds = seconds_;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < config_.threads && !stop; ++t) {
+        workers.emplace_back([this, &next, &stop, &mutex, &ready, &pending, &badShoe, totalBatches]() {
+            SharedShoes shoes(config_.deckCounts, HI_LO_COUNT);
+            std::vector<RoundSimulator> simulators;
+            simulators.reserve(cells_.size());
+            for (const SweepCell& cell : cells_) {
+                simulators.emplace_back(cell.rules);
+            }
+
+            uint64_t batch;
+            while (!stop.load(std::memory_order_relaxed) && (batch = next.fetch_add(1)) < totalBatches) {
+                std::vector<RunningStats> results(cells_.size());
+                uint64_t first = globalBatch(batch) * BATCH_SHOES;
+                uint64_t end = std::min(first + BATCH_SHOES, config_.shoes);
+                uint64_t index = first;
+                while (index < end && playShoe(index, shoes, simulators, results)) {
+                    ++index;
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                if (index < end) {
+                    // Пачка не сдается: слитый префикс остается верным, прогон останавливается
+                    badShoe = std::min(badShoe, index);
+                    stop = true;
+                    ready.notify_one();
+                    break;
+                }
+                pending.emplace(batch, std::move(results));
+                ready.notify_one();
+            }
+        });
+    }
+
+    // Слияние строго по номерам пачек: проверка точности видит один и тот же префикс при любом числе потоков
+    auto lastProgress = start;
+    auto lastCheckpoint = start;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (batchesMerged_ < totalBatches && !stop) {
+        uint64_t merged = batchesMerged_;
+        ready.wait_for(lock, std::chrono::seconds(1), [&pending, merged]() { return pending.count(merged) != 0; });
+
+        auto found = pending.find(batchesMerged_);
+        while (found != pending.end()) {
+            mergeBatch(found->second);
+            pending.erase(found);
+            if (config_.target > 0.0 && batchesMerged_ >= MIN_BATCHES && worstHalfWidth() <= config_.target) {
+                targetReached_ = true;
+                stop = true;
+                break;
+            }
+            found = pending.find(batchesMerged_);
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        seconds_ = previousSeconds + std::chrono::duration<double>(now - start).count();
+        if (!config_.checkpointPath.empty() && !stop &&
+            std::chrono::duration<double>(now - lastCheckpoint).count() >= config_.checkpointSeconds) {
+            lastCheckpoint = now;
+            if (!saveCheckpoint(config_.checkpointPath)) {
+                std::cerr << "Failed to write checkpoint " << config_.checkpointPath << "\n";
+            }
+        }
+
+        // Долгие прогоны с целью отчитываются о ходе раз в 10 секунд
+        if (config_.target > 0.0 && !stop && now - lastProgress >= std::chrono::seconds(10)) {
+            lastProgress = now;
+            std::cerr << "Shoes " << shoesPlayed_ << ", worst +/- " << std::fixed << std::setprecision(4)
+                << worstHalfWidth() << "% (target " << config_.target << "%)\n";
+        }
+    }
+    stop = true;
+    lock.unlock();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    seconds_ = previousSeconds + std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Последняя точка - законченный прогон: повторный запуск сразу напечатает отчет
+    if (!config_.checkpointPath.empty() && !saveCheckpoint(config_.checkpointPath)) {
+        std::cerr << "Failed to write checkpoint " << config_.checkpointPath << "\n";
+    }
+    if (badShoe != UINT64_MAX) {
+        error = "corpus shoe " + std::to_string(badShoe) + " is corrupt";
+        return false;
+    }
+    if (!config_.outputPath.empty() && !saveCheckpoint(config_.outputPath)) {
+        std::cerr << "Failed to write result file " << config_.outputPath << "\n";
+    }
+    return true;
+}
+
+void RuleSweep::mergeBatch(const std::vector<RunningStats>& batch) {
+    for (size_t c = 0; c < cells_.size(); ++c) {
+        cells_[c].result.merge(batch[c]);
+        cells_[c].batches.add(batch[c].getSum(), batch[c].getCount());
+    }
+    ++batchesMerged_;
+    shoesPlayed_ = shoesInBatches(batchesMerged_);
+}
+
+double RuleSweep::worstHalfWidth() const {
+    double worst = 0.0;
+    for (const SweepCell& cell : cells_) {
+        worst = std::max(worst, 1.96 * cell.batches.getStdError() / static_cast<double>(CHIP_SCALE) * 100.0);
+    }
+    return worst;
+}
+
+bool RuleSweep::playShoe(uint64_t index, SharedShoes& shoes, std::vector<RoundSimulator>& simulators,
+    std::vector<RunningStats>& results) const {
+    std::seed_seq sequence{ config_.seed, static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32) };
+    std::mt19937 generator(sequence);
+    if (corpus_ != nullptr) {
+        if (!shoes.load(*corpus_, index)) {
+            return false;
+        }
+    }
+    else {
+        shoes.shuffle(generator);
+    }
+
+    // Ровная ставка без ограничения банкролла, каждый вариант - до своей отрезной карты
+    for (size_t c = 0; c < cells_.size(); ++c) {
+        RoundSimulator& simulator = simulators[c];
+        simulator.loadShoe(shoes.getShoe(cells_[c].deckIndex));
+        while (!simulator.needsShuffle()) {
+            results[c].add(simulator.playRound(CHIP_SCALE, Chips(1) << 50, generator));
+        }
+    }
+    return true;
+}
+
+// ==================== КОНТРОЛЬНЫЕ ТОЧКИ И ДОЛИ ====================
+
+namespace {
+    const char* const STATE_HEADER = "blackjack-sweep-state 2";
+
+    uint64_t doubleBits(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+}
+
+std::string RuleSweep::fingerprint() const {
+    std::ostringstream out;
+    out << "decks";
+    for (size_t deckCount : config_.deckCounts) out << " " << deckCount;
+    out << " | dealers";
+    for (DealerStrategy dealer : config_.dealers) out << " " << dealerStrategyName(dealer);
+    out << " | soft17";
+    for (bool hit : config_.hitSoft17) out << " " << (hit ? "hit" : "stand");
+    out << " | player " << playerPolicyName(config_.playerPolicy)
+        << " | penetration " << std::hex << doubleBits(config_.penetration) << std::dec
+        << " | shoes " << config_.shoes
+        << " | target " << std::hex << doubleBits(config_.target) << std::dec
+        << " | seed " << config_.seed << " | batch " << BATCH_SHOES;
+    if (corpus_ != nullptr) {
+        out << " | corpus " << corpus_->getDeckCount() << " " << corpus_->getSeed() << " " << corpus_->getShoeCount();
+    }
+    return out.str();
+}
+
+bool RuleSweep::saveCheckpoint(const std::string& path) const {
+    std::ostringstream text;
+    text << STATE_HEADER << "\n" << fingerprint() << "\n";
+    text << "shard " << config_.shardIndex << " " << config_.shardCount << "\n";
+    text << batchesMerged_ << " " << std::hex << doubleBits(seconds_) << std::dec << "\n";
+    for (const SweepCell& cell : cells_) {
+        cell.result.write(text);
+        text << " ";
+        cell.batches.write(text);
+        text << "\n";
+    }
+    text << "end\n";
+    std::string contents = text.str();
+
+    // Данные доводятся до диска до замены: MOVEFILE_WRITE_THROUGH ждет только
+    // саму замену, и без FlushFileBuffers после сбоя точка могла бы оказаться пустой
+    std::string temporary = path + ".tmp";
+    HANDLE file = CreateFileA(temporary.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    DWORD written = 0;
+    bool saved = WriteFile(file, contents.data(), static_cast<DWORD>(contents.size()), &written, nullptr) != 0 &&
+        written == contents.size() && FlushFileBuffers(file) != 0;
+    CloseHandle(file);
+    if (!saved) {
+        return false;
+    }
+
+    // Замена одним вызовом: после сбоя на диске либо старая, либо новая точка целиком
+    return MoveFileExA(temporary.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
+
+bool RuleSweep::readState(const std::string& path, SweepState& state, std::string& error) const {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        error = "cannot open file";
+        return false;
+    }
+
+    std::string header, parameters, shard;
+    std::getline(file, header);
+    std::getline(file, parameters);
+    if (header != STATE_HEADER) {
+        error = "not a sweep state file";
+        return false;
+    }
+    if (parameters != fingerprint()) {
+        error = "written for other parameters: " + parameters;
+        return false;
+    }
+
+    uint64_t seconds = 0;
+    state.cells = cells_;
+    if (!(file >> shard >> state.shardIndex >> state.shardCount) || shard != "shard" ||
+        !(file >> state.batches >> std::hex >> seconds >> std::dec)) {
+        error = "truncated file";
+        return false;
+    }
+    for (SweepCell& cell : state.cells) {
+        if (!cell.result.read(file) || !cell.batches.read(file)) {
+            error = "truncated file";
+            return false;
+        }
+    }
+    std::string end;
+    if (!(file >> end) || end != "end" || state.cells.empty() || state.cells.front().batches.getBatches() != state.batches) {
+        error = "truncated file";
+        return false;
+    }
+    std::memcpy(&state.seconds, &seconds, sizeof(state.seconds));
+    return true;
+}
+
+bool RuleSweep::resume(std::string& error) {
+    if (config_.checkpointPath.empty() || !std::ifstream(config_.checkpointPath)) {
+        return true; // Точки еще нет - прогон с начала
+    }
+
+    // Читаем в копию: при ошибке состояние не меняется
+    SweepState state;
+    if (!readState(config_.checkpointPath, state, error)) {
+        return false;
+    }
+    if (state.shardIndex != config_.shardIndex || state.shardCount != config_.shardCount) {
+        error = "checkpoint belongs to another shard";
+        return false;
+    }
+
+    cells_ = state.cells;
+    batchesMerged_ = state.batches;
+    shoesPlayed_ = shoesInBatches(batchesMerged_);
+    seconds_ = state.seconds;
+    resumed_ = true;
+    return true;
+}
+
+bool RuleSweep::useCorpus(const ShoeCorpus& corpus, std::string& error) {
+    for (size_t deckCount : config_.deckCounts) {
+        if (deckCount != corpus.getDeckCount()) {
+            error = "corpus holds " + std::to_string(corpus.getDeckCount()) + "-deck shoes only";
+            return false;
+        }
+    }
+    if (config_.shoes > corpus.getShoeCount()) {
+        error = "corpus holds only " + std::to_string(corpus.getShoeCount()) + " shoes";
+        return false;
+    }
+
+    // Один проход по используемым шузам до старта: потокам не нужно проверять коды карт
+    uint64_t bad = corpus.verify(config_.shoes);
+    if (bad != config_.shoes) {
+        error = "shoe " + std::to_string(bad) + " is corrupt";
+        return false;
+    }
+    corpus_ = &corpus;
+    return true;
+}
+
+bool RuleSweep::mergeShards(const std::vector<std::string>& paths, std::string& error) {
+    // Доли одного пространства шузов: каждая ровно один раз и целиком
+    std::vector<bool> seen;
+    std::vector<SweepCell> cells = cells_;
+    uint64_t shoes = 0;
+    double seconds = 0.0;
+    for (const std::string& path : paths) {
+        SweepState state;
+        if (!readState(path, state, error)) {
+            error = path + ": " + error;
+            return false;
+        }
+        if (seen.empty()) {
+            seen.assign(state.shardCount, false);
+        }
+        if (state.shardCount != seen.size() || state.shardIndex >= seen.size() || seen[state.shardIndex]) {
+            error = path + ": shard " + std::to_string(state.shardIndex) + " of " + std::to_string(state.shardCount) +
+                " does not fit the other files";
+            return false;
+        }
+        seen[state.shardIndex] = true;
+
+        RuleSweep shard(*this);
+        shard.config_.shardIndex = state.shardIndex;
+        shard.config_.shardCount = state.shardCount;
+        if (state.batches != shard.shardBatches()) {
+            error = path + ": shard is not finished (" + std::to_string(state.batches) + " of " +
+                std::to_string(shard.shardBatches()) + " batches)";
+            return false;
+        }
+
+        for (size_t c = 0; c < cells.size(); ++c) {
+            cells[c].result.merge(state.cells[c].result);
+            cells[c].batches.merge(state.cells[c].batches);
+        }
+        shoes += shard.shoesInBatches(state.batches);
+        seconds = std::max(seconds, state.seconds);
+    }
+    if (seen.empty() || std::find(seen.begin(), seen.end(), false) != seen.end()) {
+        error = "missing shard files (" + std::to_string(paths.size()) + " of " + std::to_string(seen.size()) + ")";
+        return false;
+    }
+
+    cells_ = cells;
+    shoesPlayed_ = shoes;
+    seconds_ = seconds;
+    mergedShards_ = seen.size();
+    return true;
+}
+
+// ==================== ОТЧЕТ ====================
+
+void RuleSweep::printReport(std::ostream& os) const {
+    double scale = static_cast<double>(CHIP_SCALE);
+    uint64_t rounds = 0;
+    for (const SweepCell& cell : cells_) {
+        rounds += cell.result.getCount();
+    }
+
+    os << "\n=== RULE VARIANT SWEEP ===\n";
+    os << "Variants: " << cells_.size() << " | Shoes: " << shoesPlayed_
+        << (corpus_ != nullptr ? " (from corpus file)" : " (each shuffled once for all variants)") << " | Penetration: " << std::fixed << std::setprecision(0)
+        << config_.penetration * 100.0 << "% | Player: " << playerPolicyName(config_.playerPolicy) << "\n";
+    if (config_.target > 0.0) {
+        os << std::setprecision(4) << "Target: +/- " << config_.target << "% "
+            << (targetReached_ ? "reached" : "NOT reached, shoe limit hit") << " (worst +/- "
+            << worstHalfWidth() << "%, " << batchesMerged_ << " batches of " << BATCH_SHOES << " shoes)\n";
+    }
+    if (resumed_) {
+        os << "Resumed from checkpoint " << config_.checkpointPath << "\n";
+    }
+    if (config_.shardCount > 1) {
+        os << "Shard " << config_.shardIndex << " of " << config_.shardCount << " (partial result)\n";
+    }
+    if (mergedShards_ > 0) {
+        os << "Merged from " << mergedShards_ << " shard files\n";
+    }
+    os << std::setprecision(2) << "Rounds: " << rounds << " | Time: " << seconds_ << " s ("
+        << std::setprecision(0) << rounds / (seconds_ > 0.0 ? seconds_ : 1.0)
+        << " rounds/sec) | Threads: " << config_.threads << "\n\n";
+
+    // Преимущество казино - минус выигрыш игрока, в процентах ставки; ошибка - по пачкам шузов
+    os << std::right << std::setw(6) << "Decks" << std::setw(12) << "Dealer" << std::setw(9) << "Soft 17"
+        << std::setw(14) << "Rounds" << std::setw(13) << "House edge" << std::setw(10) << "+/- 95%" << "\n";
+    for (const SweepCell& cell : cells_) {
+        const RunningStats& result = cell.result;
+        os << std::setw(6) << cell.rules.deckCount
+            << std::setw(12) << dealerStrategyName(cell.rules.dealerStrategy)
+            << std::setw(9) << (cell.rules.dealerHitsSoft17 ? "hit" : "stand")
+            << std::setw(14) << result.getCount()
+            << std::setprecision(4) << std::setw(12) << -result.getMean() / scale * 100.0 << "%"
+            << std::setw(9) << 1.96 * cell.batches.getStdError() / scale * 100.0 << "%" << "\n";
+    }
+}
+
+// ==================== ТОЧКА ВХОДА ====================
+
+namespace {
+    /**
+     * @brief Разобрать список через запятую
+     */
+    template <typename T, typename Parse>
+    bool parseList(const std::string& text, std::vector<T>& values, Parse parse) {
+        values.clear();
+        std::istringstream stream(text);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            T value{};
+            if (item.empty() || !parse(item, value)) {
+                return false;
+            }
+            values.push_back(value);
+        }
+        return !values.empty();
+    }
+}
+
+int runRuleSweep(int argc, char* argv[]) {
+    CommandLine options(argc, argv);
+
+    SweepConfig config;
+    config.shoes = static_cast<uint64_t>(options.getInt("shoes", static_cast<long long>(config.shoes)));
+    config.penetration = options.getDouble("penetration", config.penetration);
+    config.target = options.getDouble("target", 0.0);
+    if (config.target > 0.0 && !options.has("shoes")) {
+        config.shoes = 100000000; // С целью число шузов - только предохранитель
+    }
+    config.threads = static_cast<size_t>(options.getInt("threads", 0));
+    config.seed = static_cast<uint32_t>(options.getInt("seed", config.seed));
+    config.checkpointPath = options.getString("checkpoint", "");
+    config.checkpointSeconds = options.getDouble("checkpoint-every", config.checkpointSeconds);
+
+    bool valid = parseList(options.getString("decks", "1,2,6,8"), config.deckCounts,
+        [](const std::string& item, size_t& value) {
+            char* end = nullptr;
+            unsigned long parsed = std::strtoul(item.c_str(), &end, 10);
+            value = static_cast<size_t>(parsed);
+            return *end == '\0' && parsed >= 1 && parsed <= 16;
+        });
+    valid = valid && parseList(options.getString("dealers", "standard,aggressive,cautious"), config.dealers,
+        [](const std::string& item, DealerStrategy& value) { return parseDealerStrategy(item, value); });
+
+    std::string soft17 = options.getString("soft17", "both");
+    if (soft17 == "stand") config.hitSoft17 = { false };
+    else if (soft17 == "hit") config.hitSoft17 = { true };
+    else if (soft17 != "both") valid = false;
+
+    valid = valid && parsePlayerPolicy(options.getString("player", "basic"), config.playerPolicy);
+
+    // Доля пространства шузов "i/n": пачки с номером % n == i
+    std::string shard = options.getString("shard", "0/1");
+    unsigned shardIndex = 0, shardCount = 0;
+    char separator = 0;
+    std::istringstream shardStream(shard);
+    if (!(shardStream >> shardIndex >> separator >> shardCount) || separator != '/' ||
+        shardCount == 0 || shardIndex >= shardCount) {
+        valid = false;
+    }
+    config.shardIndex = shardIndex;
+    config.shardCount = shardCount;
+    config.outputPath = options.getString("output", "");
+
+    // Цель точности - свойство всего прогона, доля его не знает
+    if (!valid || config.shoes == 0 || config.target < 0.0 || (config.shardCount > 1 && config.target > 0.0)) {
+        std::cerr << "Usage: --sweep [--decks 1,2,6,8] [--dealers standard,aggressive,cautious]"
+            " [--soft17 stand|hit|both] [--player basic|mimic|never-bust] [--shoes N] [--target percent]"
+            " [--penetration 0.75] [--checkpoint file] [--checkpoint-every seconds]"
+            " [--shard i/n --output file] [--merge file,file,...] [--corpus file] [--threads N] [--seed N]\n"
+            "--target cannot be combined with --shard\n";
+        return 1;
+    }
+
+    // Шузы из файла: по умолчанию все шузы файла
+    ShoeCorpus corpus;
+    std::string error;
+    if (options.has("corpus")) {
+        if (!corpus.open(options.getString("corpus", ""), error)) {
+            std::cerr << "Cannot open corpus: " << error << "\n";
+            return 1;
+        }
+        if (!options.has("shoes")) {
+            config.shoes = corpus.getShoeCount();
+        }
+    }
+
+    RuleSweep sweep(config);
+    if (corpus.isOpen() && !sweep.useCorpus(corpus, error)) {
+        std::cerr << "Cannot use corpus: " << error << "\n";
+        return 1;
+    }
+
+    // Слияние файлов долей, записанных с теми же параметрами
+    if (options.has("merge")) {
+        std::vector<std::string> paths;
+        parseList(options.getString("merge", ""), paths,
+            [](const std::string& item, std::string& value) { value = item; return true; });
+        if (!sweep.mergeShards(paths, error)) {
+            std::cerr << "Cannot merge: " << error << "\n";
+            return 1;
+        }
+        sweep.printReport(std::cout);
+        return 0;
+    }
+
+    if (!sweep.resume(error)) {
+        std::cerr << "Cannot resume from " << config.checkpointPath << ": " << error << "\n";
+        return 1;
+    }
+    if (!sweep.run(error)) {
+        std::cerr << "Sweep stopped: " << error << "\n";
+        return 1;
+    }
+    sweep.printReport(std::cout);
+    return 0;
+}
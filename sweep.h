@@ -0,0 +1,244 @@
+#pragma once
+#include "corpus.h"
+#include "dealer.h"
+#include "deck.h"
+#include "simulator.h"
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// ==================== ОБЩИЕ ШУЗЫ ====================
+
+/**
+ * @brief Перетасовка одного шуза на все числа колод сетки
+ *
+ * Перемешивается шуз наибольшего числа колод; шуз из d колод - его карты
+ * из первых d колод в том же порядке. Подпоследовательность равномерной
+ * перестановки равномерна, поэтому каждый шуз перемешан честно, а одна
+ * перетасовка и одни случайные числа обслуживают всю сетку. Шузы
+ * переиспользуются между вызовами и не выделяют память.
+ */
+class SharedShoes {
+public:
+    /**
+     * @brief Конструктор
+     * @param deckCounts Числа колод сетки
+     * @param countSystem Система счета шузов
+     */
+    SharedShoes(const std::vector<size_t>& deckCounts, const CountSystem& countSystem);
+
+    /**
+     * @brief Перемешать и разложить шузы всех чисел колод
+     */
+    void shuffle(std::mt19937& generator);
+
+    /**
+     * @brief Взять шузы из файла вместо перетасовки
+     * @param corpus Файл шузов того же числа колод, что и все шузы сетки
+     * @param index Номер шуза в файле
+     * @return false если шуз в файле поврежден (шузы не меняются)
+     */
+    bool load(const ShoeCorpus& corpus, uint64_t index);
+
+    /**
+     * @brief Шуз i-го числа колод сетки (после shuffle())
+     */
+    const Deck& getShoe(size_t index) const { return shoes_[index]; }
+
+private:
+    Deck source_;                  ///< Несмешанный шуз наибольшего числа колод
+    std::vector<uint16_t> order_;  ///< Перестановка позиций source_
+    std::vector<Deck> shoes_;      ///< Шузы по числам колод сетки
+};
+
+// ==================== СЕТКА ПРАВИЛ ====================
+
+/**
+ * @brief Параметры прогона сетки правил
+ */
+struct SweepConfig {
+    std::vector<size_t> deckCounts = { 1, 2, 6, 8 };    ///< Числа колод
+    std::vector<DealerStrategy> dealers = {
+        DealerStrategy::Standard, DealerStrategy::Aggressive, DealerStrategy::Cautious }; ///< Стратегии дилера
+    std::vector<bool> hitSoft17 = { false, true };      ///< Правила мягких 17 (S17, H17)
+    double penetration = 0.75;                          ///< Доля шуза до перемешивания
+    PlayerPolicy playerPolicy = PlayerPolicy::Basic;    ///< Стратегия игрока
+    uint64_t shoes = 100000;                            ///< Шузов (с целевой точностью - наибольшее число)
+    double target = 0.0;                                ///< Целевая полуширина 95% интервала, % ставки (0 - все шузы)
+    size_t threads = 0;                                 ///< Рабочих потоков (0 - по числу ядер)
+    uint32_t seed = 1;                                  ///< Зерно (шуз i - свой поток чисел от seed и i)
+    std::string checkpointPath;                         ///< Файл контрольной точки (пусто - без них)
+    double checkpointSeconds = 60.0;                    ///< Период записи контрольной точки
+    size_t shardIndex = 0;                              ///< Доля пространства шузов (пачки с номером % shardCount)
+    size_t shardCount = 1;                              ///< Число долей (процессов)
+    std::string outputPath;                             ///< Файл результата доли для слияния (пусто - без него)
+};
+
+/**
+ * @brief Вариант правил сетки и его итоги
+ */
+struct SweepCell {
+    size_t deckIndex = 0;                             ///< Номер числа колод в SweepConfig::deckCounts
+    SimulationRules rules;                            ///< Правила варианта
+    RunningStats result;                              ///< Выигрыш игрока за раунд ставкой в одну единицу (Chips)
+    BatchMeans batches;                               ///< Тот же выигрыш по пачкам шузов (для ошибки)
+};
+
+/**
+ * @brief Состояние прогона из файла контрольной точки или результата доли
+ */
+struct SweepState {
+    std::vector<SweepCell> cells; ///< Итоги вариантов
+    uint64_t batches = 0;         ///< Слито пачек доли
+    double seconds = 0.0;         ///< Время прогона
+    size_t shardIndex = 0;        ///< Доля
+    size_t shardCount = 1;        ///< Число долей
+};
+
+/**
+ * @brief Преимущество казино для всей сетки правил за один прогон
+ *
+ * Шуз i засеян от (seed, i) и перемешивается один раз (SharedShoes);
+ * каждый вариант правил играет свою копию шуза того же числа колод
+ * до отрезной карты ровной ставкой. Варианты одного числа колод
+ * получают одни и те же карты, пока их раунды не разойдутся, поэтому
+ * разницы между ними точнее, чем при отдельных прогонах.
+ *
+ * Шузы играются пачками по BATCH_SHOES; ошибка считается методом средних
+ * по пачкам (BatchMeans). С целевой точностью прогон идет, пока полуширина
+ * 95% интервала каждого варианта не станет не больше цели: потоки
+ * сдают пачки, главный поток сливает их строго по номерам и после каждой
+ * проверяет точность. Остановка зависит только от номеров пачек, поэтому
+ * итог не зависит от числа потоков; пачки, досчитанные потоками после
+ * остановки, отбрасываются.
+ *
+ * Все состояние прогона - слитый префикс пачек: число пачек и суммы
+ * вариантов. Генераторы засеваются от номера шуза, поэтому позиция
+ * потока чисел - это номер следующей пачки, а незаконченные пачки потоков
+ * просто пересчитываются. Контрольная точка пишется периодически
+ * во временный файл и атомарно заменяет прежнюю; прогон, продолженный
+ * с нее (resume()), дает побитово тот же итог, что и непрерывный.
+ *
+ * Пространство шузов делится между процессами по номерам пачек: доля i
+ * из n играет пачки с номером % n == i и пишет итог в файл того же
+ * формата. Суммы точные, поэтому mergeShards() собирает из файлов всех
+ * долей отчет, совпадающий с прогоном в одном процессе.
+ *
+ * С файлом шузов (useCorpus()) шуз i берется из файла, а не перетасовывается:
+ * процессы и другие режимы играют те же последовательности карт.
+ */
+class RuleSweep {
+public:
+    static constexpr uint64_t BATCH_SHOES = 64; ///< Шузов в пачке
+    static constexpr uint64_t MIN_BATCHES = 32; ///< Пачек до первой проверки точности
+
+    explicit RuleSweep(const SweepConfig& config);
+
+    /**
+     * @brief Продолжить с контрольной точки config.checkpointPath, если файл есть
+     * @param error [out] Причина отказа
+     * @return false если файл поврежден или записан для других параметров
+     */
+    bool resume(std::string& error);
+
+    /**
+     * @brief Брать шузы из файла (файл должен жить дольше прогона)
+     * @param error [out] Причина отказа
+     * @return false если число колод сетки другое, шузов в файле меньше или они повреждены
+     */
+    bool useCorpus(const ShoeCorpus& corpus, std::string& error);
+
+    /**
+     * @brief Сыграть оставшиеся шузы всеми вариантами (все или до целевой точности)
+     * @param error [out] Причина отказа
+     * @return false если шуз из файла не разложился (слитые до него пачки сохранены в контрольной точке)
+     */
+    bool run(std::string& error);
+
+    /**
+     * @brief Собрать итог из файлов результатов всех долей
+     * @param paths Файлы долей 0..n-1 в любом порядке, записанные с теми же параметрами
+     * @param error [out] Причина отказа
+     * @return false если файл не читается, доля не закончена, повторена или пропущена
+     */
+    bool mergeShards(const std::vector<std::string>& paths, std::string& error);
+
+    /**
+     * @brief Записать контрольную точку атомарно (временный файл и замена)
+     * @return false при ошибке записи
+     */
+    bool saveCheckpoint(const std::string& path) const;
+
+    /**
+     * @brief Таблица преимущества казино по вариантам
+     */
+    void printReport(std::ostream& os) const;
+
+    const std::vector<SweepCell>& getCells() const { return cells_; }
+
+private:
+    /**
+     * @brief Сыграть шуз всеми вариантами
+     * @return false если шуз из файла поврежден
+     */
+    bool playShoe(uint64_t index, SharedShoes& shoes, std::vector<RoundSimulator>& simulators,
+        std::vector<RunningStats>& results) const;
+
+    /**
+     * @brief Учесть пачку (по порядку номеров)
+     */
+    void mergeBatch(const std::vector<RunningStats>& batch);
+
+    /**
+     * @brief Наибольшая полуширина 95% интервала среди вариантов, % ставки
+     */
+    double worstHalfWidth() const;
+
+    /**
+     * @brief Параметры, от которых зависит итог (без числа потоков и доли), одной строкой
+     */
+    std::string fingerprint() const;
+
+    /**
+     * @brief Прочитать файл контрольной точки или результата доли
+     */
+    bool readState(const std::string& path, SweepState& state, std::string& error) const;
+
+    /**
+     * @brief Номер пачки пространства шузов по номеру пачки доли
+     */
+    uint64_t globalBatch(uint64_t local) const;
+
+    /**
+     * @brief Пачек в доле
+     */
+    uint64_t shardBatches() const;
+
+    /**
+     * @brief Шузов в первых localBatches пачках доли
+     */
+    uint64_t shoesInBatches(uint64_t localBatches) const;
+
+    SweepConfig config_;           ///< Параметры
+    std::vector<SweepCell> cells_; ///< Варианты: число колод, стратегия дилера, мягкие 17
+    uint64_t batchesMerged_ = 0;   ///< Слито пачек доли (префикс по номерам)
+    uint64_t shoesPlayed_ = 0;     ///< Учтено шузов
+    bool targetReached_ = false;   ///< Остановились по целевой точности
+    bool resumed_ = false;         ///< Продолжен с контрольной точки
+    size_t mergedShards_ = 0;      ///< Собран из файлов долей
+    double seconds_ = 0.0;         ///< Время прогона (с учетом прогона до контрольной точки)
+    const ShoeCorpus* corpus_ = nullptr; ///< Файл шузов (nullptr - перетасовка)
+};
+
+/**
+ * @brief Точка входа режима сетки правил (--sweep)
+ * @param argc Число аргументов
+ * @param argv Аргументы: --decks (список), --dealers (список), --soft17 (stand, hit, both),
+ *             --player, --shoes, --target (% ставки), --penetration, --threads, --seed,
+ *             --checkpoint (файл), --checkpoint-every (секунд), --shard (i/n), --output (файл),
+ *             --merge (файлы через запятую), --corpus (файл шузов)
+ * @return 0 при успехе
+ */
+int runRuleSweep(int argc, char* argv[]);
@@ -0,0 +1,233 @@
+#include "table.h"
+#include "game.h"
+#include <cstring>
+#include <string>
+
+/**
+ * @brief Конструктор стола
+ * @param id Идентификатор стола
+ * @param seatCount Число мест
+ * @param seed Зерно генератора перемешивания
+ */
+Table::Table(uint32_t id, size_t seatCount, uint32_t seed)
+    : id_(id), seed_(seed) {
+    if (seatCount < 1) seatCount = 1;
+    if (seatCount > MAX_SEATS) seatCount = MAX_SEATS;
+
+    for (size_t i = 0; i < seatCount; ++i) {
+        seats_.emplace_back("Seat " + std::to_string(i + 1));
+        accounts_.push_back(ledger_.openAccount(STARTING_BANKROLL));
+    }
+    outcomes_.resize(seatCount, RoundOutcome::Push);
+    wagers_.assign(seatCount * Player::MAX_HANDS, NO_WAGER);
+    events_.reserve(PROTOCOL_MAX_DELTA_EVENTS);
+}
+
+// ==================== ХОД РАУНДА ====================
+
+void Table::startRound() {
+    ++roundId_;
+    roundOver_ = false;
+
+    // Новая колода на каждый раунд, как в Game::startGame()
+    generator_.seed(seed_ ^ (roundId_ * 0x9E3779B9u));
+    deck_ = Deck();
+    deck_.shuffle(generator_);
+
+    // Журнал от прошлого раунда, если его никто не забрал, больше не нужен
+    events_.clear();
+    logEvent(DeltaKind::RoundStarted, NO_ACTIVE_SEAT, 0);
+
+    // Ставки раунда; игроку без фишек на ставку - новый банкролл
+    for (uint8_t seat = 0; seat < seats_.size(); ++seat) {
+        seats_[seat].clearHand();
+        if (ledger_.getBalance(accounts_[seat]) < DEFAULT_BET) {
+            ledger_.deposit(accounts_[seat], STARTING_BANKROLL);
+        }
+        ledger_.placeBet(accounts_[seat], DEFAULT_BET, wagerOf(seat, 0));
+    }
+    dealer_.clearHand();
+    for (uint8_t seat = 0; seat < seats_.size(); ++seat) {
+        dealTo(seat);
+        dealTo(seat);
+    }
+    dealTo(DEALER_SEAT);
+    dealTo(DEALER_SEAT, true);
+
+    activeSeat_ = 0;
+}
+
+bool Table::applyDecision(uint8_t seat, uint8_t actionCode) {
+    if (roundOver_ || seat != activeSeat_) {
+        return false;
+    }
+
+    Player& player = seats_[seat];
+    PlayerAction action = player.convertNetworkAction(actionCode);
+    size_t wager = wagerOf(seat, 0);
+    if (action == PlayerAction::DoubleDown && wager != NO_WAGER && !ledger_.doubleBet(wager)) {
+        action = PlayerAction::Stand; // Не хватает фишек на удвоение
+    }
+    logEvent(DeltaKind::ActionTaken, seat,
+        static_cast<uint8_t>(action == PlayerAction::Split ? PlayerAction::Stand : action));
+
+    // Разделение требует отдельных рук у места - на сервере пока играется как Stand
+    switch (action) {
+    case PlayerAction::Hit:
+        dealTo(seat);
+        if (player.isBusted()) {
+            advanceSeat();
+        }
+        break;
+    case PlayerAction::DoubleDown:
+        dealTo(seat);
+        advanceSeat();
+        break;
+    case PlayerAction::Stand:
+    case PlayerAction::Split:
+        advanceSeat();
+        break;
+    }
+    return true;
+}
+
+void Table::advanceSeat() {
+    ++activeSeat_;
+    if (activeSeat_ >= seats_.size()) {
+        activeSeat_ = NO_ACTIVE_SEAT;
+        finishRound();
+    }
+}
+
+void Table::finishRound() {
+    logEvent(DeltaKind::HoleCardRevealed, DEALER_SEAT, encodeCard(dealer_.getHand()[1]));
+
+    // Дилер играет по своей стратегии
+    while (dealer_.mustDrawCard()) {
+        dealTo(DEALER_SEAT);
+    }
+
+    for (size_t i = 0; i < seats_.size(); ++i) {
+        Player& player = seats_[i];
+        WagerResult result = Game::settleHand(player, dealer_, outcomes_[i]);
+        switch (outcomes_[i]) {
+        case RoundOutcome::Win:  player.recordWin();  break;
+        case RoundOutcome::Loss: player.recordLoss(); break;
+        case RoundOutcome::Push: player.recordPush(); break;
+        }
+        player.updateMaxScore(player.calculateScore());
+        if (wagerOf(i, 0) != NO_WAGER) {
+            ledger_.setResult(wagerOf(i, 0), result);
+        }
+        logEvent(DeltaKind::SeatResult, static_cast<uint8_t>(i), static_cast<uint8_t>(outcomes_[i]));
+    }
+
+    // Все ставки стола закрываются одной пачкой
+    ledger_.settle();
+    wagers_.assign(seats_.size() * Player::MAX_HANDS, NO_WAGER);
+    roundOver_ = true;
+}
+
+void Table::dealTo(uint8_t seat, bool hidden) {
+    Player& target = (seat == DEALER_SEAT) ? dealer_ : seats_[seat];
+    target.takeCard(deck_);
+    logEvent(DeltaKind::CardDealt, seat, hidden ? CARD_HIDDEN : encodeCard(target.getHand().back()));
+}
+
+void Table::logEvent(DeltaKind kind, uint8_t seat, uint8_t value) {
+    TableEvent event;
+    event.kind = kind;
+    event.seat = seat;
+    event.value = value;
+    events_.push_back(event);
+}
+
+// ==================== СНИМКИ ====================
+
+void Table::saveSnapshot(GameSnapshot& snapshot) const {
+    std::memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.version = SNAPSHOT_VERSION;
+    snapshot.seatCount = static_cast<uint8_t>(seats_.size());
+    snapshot.activeSeat = activeSeat_;
+    snapshot.roundOver = roundOver_ ? 1 : 0;
+    snapshot.dealerStrategy = static_cast<uint8_t>(dealer_.getStrategy());
+    snapshot.tableId = id_;
+    snapshot.roundId = roundId_;
+    snapshot.seed = seed_;
+
+    saveDeck(snapshot, deck_);
+    saveHand(snapshot.dealer, dealer_.getHand());
+    for (size_t i = 0; i < seats_.size(); ++i) {
+        saveSeat(snapshot.seats[i], seats_[i]);
+        saveWagers(snapshot.seats[i], ledger_, accounts_[i], &wagers_[i * Player::MAX_HANDS]);
+        snapshot.outcomes[i] = static_cast<uint8_t>(outcomes_[i]);
+    }
+}
+
+bool Table::restoreSnapshot(const GameSnapshot& snapshot) {
+    if (!isValidSnapshot(snapshot) || snapshot.seatCount < 1 || snapshot.seatCount > MAX_SEATS) {
+        return false;
+    }
+
+    id_ = snapshot.tableId;
+    roundId_ = snapshot.roundId;
+    seed_ = snapshot.seed;
+    activeSeat_ = snapshot.activeSeat;
+    roundOver_ = snapshot.roundOver != 0;
+    dealer_.restoreStrategy(static_cast<DealerStrategy>(snapshot.dealerStrategy));
+
+    while (seats_.size() < snapshot.seatCount) {
+        seats_.emplace_back("Seat " + std::to_string(seats_.size() + 1));
+    }
+    seats_.resize(snapshot.seatCount, seats_.front());
+    outcomes_.resize(snapshot.seatCount, RoundOutcome::Push);
+
+    bool valid = restoreDeck(snapshot, deck_) && restoreHand(snapshot.dealer, dealer_);
+    for (size_t i = 0; i < seats_.size() && valid; ++i) {
+        valid = restoreSeat(snapshot.seats[i], seats_[i]);
+        outcomes_[i] = static_cast<RoundOutcome>(snapshot.outcomes[i]);
+    }
+
+    // Счета и ставки открываются заново в той же книге (емкость переиспользуется)
+    ledger_.reset();
+    accounts_.clear();
+    wagers_.assign(seats_.size() * Player::MAX_HANDS, NO_WAGER);
+    for (size_t i = 0; i < seats_.size(); ++i) {
+        accounts_.push_back(restoreWagers(snapshot.seats[i], ledger_, &wagers_[i * Player::MAX_HANDS]));
+    }
+    events_.clear();
+    return valid;
+}
+
+// ==================== КОДИРОВАНИЕ СООБЩЕНИЙ ====================
+
+size_t Table::encodeState(uint8_t* buffer, size_t capacity) const {
+    TableStateInfo info;
+    info.tableId = id_;
+    info.roundId = roundId_;
+    info.activeSeat = activeSeat_;
+    info.holeCardHidden = !roundOver_;
+    return encodeTableState(buffer, capacity, info, dealer_, seats_);
+}
+
+size_t Table::encodeActionRequest(uint8_t* buffer, size_t capacity) const {
+    if (activeSeat_ == NO_ACTIVE_SEAT) {
+        return 0;
+    }
+
+    // Split на сервере пока не поддерживается - убираем его из маски,
+    // как и Double Down, если на удвоение не хватает фишек
+    const Player& player = seats_[activeSeat_];
+    LegalActions legalActions = player.getLegalActions().without(PlayerAction::Split);
+    size_t wager = wagers_[activeSeat_ * Player::MAX_HANDS];
+    if (wager != NO_WAGER && ledger_.getBalance(accounts_[activeSeat_]) < ledger_.getWager(wager).stake) {
+        legalActions = legalActions.without(PlayerAction::DoubleDown);
+    }
+    return ::encodeActionRequest(buffer, capacity, id_, roundId_, activeSeat_,
+        player, dealer_.getHand()[0], legalActions);
+}
+
+size_t Table::encodeResult(uint8_t* buffer, size_t capacity) const {
+    return encodeRoundResult(buffer, capacity, id_, roundId_,
+        static_cast<uint8_t>(dealer_.calculateScore()), outcomes_, seats_);
+}
@@ -0,0 +1,152 @@
+#pragma once
+#include "player.h"
+#include "dealer.h"
+#include "deck.h"
+#include "ledger.h"
+#include "protocol.h"
+#include "snapshot.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/**
+ * @brief Неинтерактивный стол для сервера
+ *
+ * Ведет раунд по тем же правилам что и Game, но без консольного
+ * ввода-вывода: решения игроков приходят извне через applyDecision()
+ *
+ * У каждого места свой счет в книге фишек стола. В начале раунда место
+ * ставит DEFAULT_BET (счет без фишек на ставку пополняется стартовым
+ * банкроллом), а исходы и выплаты считаются Game::settleHand() и одним
+ * ChipLedger::settle() на раунд.
+ */
+class Table {
+public:
+    static constexpr size_t MAX_SEATS = 4; ///< Максимум мест (как в Game::setupPlayers)
+
+    /**
+     * @brief Конструктор стола
+     * @param id Идентификатор стола
+     * @param seatCount Число мест (1-MAX_SEATS)
+     * @param seed Зерно генератора перемешивания
+     */
+    Table(uint32_t id, size_t seatCount, uint32_t seed);
+
+    /**
+     * @brief Начать новый раунд: новая колода, раздача по 2 карты
+     *
+     * Генератор перезаряжается от зерна стола и номера раунда, поэтому
+     * перемешивания следующих раундов определяются снимком полностью
+     */
+    void startRound();
+
+    /**
+     * @brief Применить решение игрока
+     * @param seat Номер места
+     * @param actionCode Код действия из сообщения Decision
+     * @return true если место ожидало хода и решение применено
+     *
+     * Недопустимые действия превращаются в Stand (Player::convertNetworkAction),
+     * как и Double Down, на который не хватает фишек
+     */
+    bool applyDecision(uint8_t seat, uint8_t actionCode);
+
+    /**
+     * @brief Завершен ли текущий раунд (дилер сыграл, исходы подсчитаны)
+     */
+    bool isRoundOver() const { return roundOver_; }
+
+    /// @name Геттеры состояния
+    /// @{
+    uint32_t getId() const { return id_; }
+    uint32_t getRoundId() const { return roundId_; }
+    uint8_t getActiveSeat() const { return activeSeat_; }
+    size_t getSeatCount() const { return seats_.size(); }
+    const std::vector<Player>& getSeats() const { return seats_; }
+    const Dealer& getDealer() const { return dealer_; }
+    const Deck& getDeck() const { return deck_; }
+    const std::vector<RoundOutcome>& getOutcomes() const { return outcomes_; }
+    const ChipLedger& getLedger() const { return ledger_; }
+    Chips getBalance(uint8_t seat) const { return ledger_.getBalance(accounts_[seat]); } ///< Баланс места без ставки в игре
+    /// @}
+
+    /// @name Снимки состояния
+    /// @{
+
+    /**
+     * @brief Сохранить стол посреди раунда в плоский снимок
+     * @param snapshot [out] Снимок
+     */
+    void saveSnapshot(GameSnapshot& snapshot) const;
+
+    /**
+     * @brief Восстановить стол из снимка (на резервном процессе или в ветке "что если")
+     * @param snapshot Снимок
+     * @return false если снимок поврежден или мест больше MAX_SEATS
+     *
+     * После разогрева восстановление не выделяет память: руки и колода
+     * переиспользуют свою емкость
+     */
+    bool restoreSnapshot(const GameSnapshot& snapshot);
+    /// @}
+
+    /**
+     * @brief События стола с последнего clearEvents() (для дельт зрителям)
+     *
+     * Закрытая карта дилера записывается как CARD_HIDDEN и раскрывается
+     * событием HoleCardRevealed в конце раунда
+     */
+    const std::vector<TableEvent>& getEvents() const { return events_; }
+
+    /**
+     * @brief Очистить журнал событий
+     */
+    void clearEvents() { events_.clear(); }
+
+    /// @name Кодирование сообщений протокола
+    /// @{
+    size_t encodeState(uint8_t* buffer, size_t capacity) const;
+    size_t encodeActionRequest(uint8_t* buffer, size_t capacity) const;
+    size_t encodeResult(uint8_t* buffer, size_t capacity) const;
+    /// @}
+
+private:
+    /**
+     * @brief Перейти к следующему месту, ожидающему хода
+     */
+    void advanceSeat();
+
+    /**
+     * @brief Ход дилера, исходы по Game::settleHand() и расчет ставок раунда
+     */
+    void finishRound();
+
+    /**
+     * @brief Выдать карту месту или дилеру и записать событие
+     * @param seat Номер места или DEALER_SEAT
+     * @param hidden Карта закрыта (закрытая карта дилера)
+     */
+    void dealTo(uint8_t seat, bool hidden = false);
+
+    void logEvent(DeltaKind kind, uint8_t seat, uint8_t value);
+
+    /**
+     * @brief Номер ставки руки в книге фишек
+     */
+    size_t& wagerOf(size_t seat, size_t hand) { return wagers_[seat * Player::MAX_HANDS + hand]; }
+
+    uint32_t id_;                        ///< Идентификатор стола
+    uint32_t roundId_ = 0;               ///< Номер текущего раунда
+    uint32_t seed_;                      ///< Зерно стола
+    std::mt19937 generator_;             ///< Генератор перемешивания
+    Deck deck_;                          ///< Колода раунда
+    std::vector<Player> seats_;          ///< Игроки по местам
+    Dealer dealer_;                      ///< Дилер
+    std::vector<RoundOutcome> outcomes_; ///< Исходы последнего раунда
+    ChipLedger ledger_;                  ///< Счета мест и ставки раунда
+    std::vector<uint32_t> accounts_;     ///< Счет каждого места
+    std::vector<size_t> wagers_;         ///< Ставки рук (MAX_HANDS на место, NO_WAGER - без ставки)
+    uint8_t activeSeat_ = NO_ACTIVE_SEAT; ///< Место, ожидающее хода
+    bool roundOver_ = true;              ///< Раунд завершен
+    std::vector<TableEvent> events_;     ///< Журнал событий для дельт
+};
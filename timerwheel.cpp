@@ -0,0 +1,158 @@
+#include "timerwheel.h"
+
+constexpr uint64_t SLOT_MASK = TimerWheel::SLOTS - 1;
+constexpr uint64_t MAX_DELAY = (1ull << (TimerWheel::LEVELS * TimerWheel::SLOT_BITS)) - 1;
+
+TimerWheel::TimerWheel(uint64_t startTick)
+    : now_(startTick) {
+    for (auto& head : buckets_) {
+        head = NIL;
+    }
+}
+
+// ==================== ВСТАВКА И ОТМЕНА ====================
+
+TimerId TimerWheel::schedule(uint64_t deadline, uint64_t payload) {
+    uint32_t index;
+    if (freeList_ != NIL) {
+        index = freeList_;
+        freeList_ = nodes_[index].next;
+    }
+    else {
+        index = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+
+    // Прошедший срок - на ближайший тик, слишком дальний - ограничиваем верхним уровнем
+    if (deadline <= now_) deadline = now_ + 1;
+    if (deadline - now_ > MAX_DELAY) deadline = now_ + MAX_DELAY;
+
+    TimerNode& node = nodes_[index];
+    node.deadline = deadline;
+    node.payload = payload;
+    insert(index);
+    ++active_;
+
+    return (static_cast<uint64_t>(node.generation) << 32) | index;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    uint32_t index = static_cast<uint32_t>(id);
+    uint32_t generation = static_cast<uint32_t>(id >> 32);
+    if (id == NO_TIMER || index >= nodes_.size() ||
+        nodes_[index].generation != generation || nodes_[index].bucket == NIL) {
+        return false;
+    }
+
+    unlink(index);
+    release(index);
+    return true;
+}
+
+void TimerWheel::insert(uint32_t index) {
+    TimerNode& node = nodes_[index];
+    uint64_t delay = node.deadline - now_;
+
+    // Уровень - по величине задержки, ячейка - по битам срока
+    int level = 0;
+    while (level < LEVELS - 1 && delay >= (1ull << (SLOT_BITS * (level + 1)))) {
+        ++level;
+    }
+    uint32_t bucket = static_cast<uint32_t>(level * SLOTS +
+        ((node.deadline >> (SLOT_BITS * level)) & SLOT_MASK));
+
+    node.bucket = bucket;
+    levelCounts_[level]++;
+    node.prev = NIL;
+    node.next = buckets_[bucket];
+    if (node.next != NIL) {
+        nodes_[node.next].prev = index;
+    }
+    buckets_[bucket] = index;
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    TimerNode& node = nodes_[index];
+    if (node.prev != NIL) {
+        nodes_[node.prev].next = node.next;
+    }
+    else {
+        buckets_[node.bucket] = node.next;
+    }
+    if (node.next != NIL) {
+        nodes_[node.next].prev = node.prev;
+    }
+    levelCounts_[node.bucket / SLOTS]--;
+}
+
+void TimerWheel::release(uint32_t index) {
+    TimerNode& node = nodes_[index];
+    node.bucket = NIL;
+    node.generation++; // Старые идентификаторы больше не совпадут
+    if (node.generation == 0) node.generation = 1;
+    node.next = freeList_;
+    freeList_ = index;
+    --active_;
+}
+
+// ==================== ХОД ВРЕМЕНИ ====================
+
+void TimerWheel::cascade(int level) {
+    uint32_t bucket = static_cast<uint32_t>(level * SLOTS +
+        ((now_ >> (SLOT_BITS * level)) & SLOT_MASK));
+
+    // Забираем весь список ячейки и раскладываем по младшим уровням
+    uint32_t index = buckets_[bucket];
+    buckets_[bucket] = NIL;
+    while (index != NIL) {
+        uint32_t next = nodes_[index].next;
+        levelCounts_[level]--;
+        insert(index);
+        index = next;
+    }
+}
+
+void TimerWheel::advance(uint64_t now, std::vector<uint64_t>& expired) {
+    // Без таймеров просто переносим время
+    if (active_ == 0) {
+        if (now > now_) now_ = now;
+        return;
+    }
+
+    while (now_ < now) {
+        // Младший уровень пуст - перескакиваем сразу к концу его оборота
+        if (levelCounts_[0] == 0) {
+            uint64_t turnEnd = now_ | SLOT_MASK;
+            now_ = (turnEnd < now) ? turnEnd : now;
+            if (now_ == now) break;
+        }
+        ++now_;
+
+        // На границе оборота младшего уровня осыпаем старшие (сверху вниз)
+        if ((now_ & SLOT_MASK) == 0) {
+            int top = 1;
+            while (top < LEVELS - 1 && ((now_ >> (SLOT_BITS * top)) & SLOT_MASK) == 0) {
+                ++top;
+            }
+            for (int level = top; level >= 1; --level) {
+                cascade(level);
+            }
+        }
+
+        uint32_t bucket = static_cast<uint32_t>(now_ & SLOT_MASK);
+        uint32_t index = buckets_[bucket];
+        buckets_[bucket] = NIL;
+        while (index != NIL) {
+            uint32_t next = nodes_[index].next;
+            expired.push_back(nodes_[index].payload);
+            levelCounts_[0]--;
+            release(index);
+            index = next;
+        }
+
+        if (active_ == 0) {
+            now_ = now;
+            return;
+        }
+    }
+}
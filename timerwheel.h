@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+using TimerId = uint64_t;           ///< Идентификатор таймера (поколение << 32 | индекс)
+constexpr TimerId NO_TIMER = 0;     ///< "Нет таймера" (поколения начинаются с 1)
+
+/**
+ * @brief Иерархическое хешированное колесо таймеров
+ *
+ * Четыре уровня по 256 ячеек: уровень 0 покрывает 256 тиков, каждый
+ * следующий - в 256 раз больше (при тике 1 мс верхний уровень - ~49 дней).
+ * Таймер попадает в ячейку по битам своего срока; когда младший уровень
+ * проходит полный круг, ячейка старшего уровня "осыпается" на младшие.
+ *
+ * Вставка и отмена - O(1): узлы лежат в общем пуле и связаны в
+ * двусвязные списки по индексам, освобожденные узлы переиспользуются.
+ * Не требует отдельного потока или системного таймера на место -
+ * владелец сам вызывает advance() из своего цикла.
+ */
+class TimerWheel {
+public:
+    static constexpr int LEVELS = 4;          ///< Число уровней
+    static constexpr int SLOT_BITS = 8;       ///< Бит индекса ячейки
+    static constexpr int SLOTS = 1 << SLOT_BITS; ///< Ячеек на уровне
+
+    /**
+     * @brief Конструктор колеса
+     * @param startTick Текущий тик
+     */
+    explicit TimerWheel(uint64_t startTick = 0);
+
+    /**
+     * @brief Запланировать таймер
+     * @param deadline Тик срабатывания (прошедший срок сработает на следующем тике)
+     * @param payload Пользовательские данные, возвращаемые при срабатывании
+     * @return Идентификатор для отмены
+     */
+    TimerId schedule(uint64_t deadline, uint64_t payload);
+
+    /**
+     * @brief Отменить таймер
+     * @param id Идентификатор (устаревшие и сработавшие игнорируются)
+     * @return true если таймер был активен и отменен
+     */
+    bool cancel(TimerId id);
+
+    /**
+     * @brief Продвинуть время и собрать сработавшие таймеры
+     * @param now Текущий тик
+     * @param expired [out] Сюда добавляются payload сработавших таймеров
+     */
+    void advance(uint64_t now, std::vector<uint64_t>& expired);
+
+    /**
+     * @brief Число активных таймеров
+     */
+    size_t size() const { return active_; }
+
+    /**
+     * @brief Текущий тик колеса
+     */
+    uint64_t getCurrentTick() const { return now_; }
+
+private:
+    static constexpr uint32_t NIL = 0xFFFFFFFFu; ///< Пустая ссылка в списке
+
+    /**
+     * @brief Узел таймера в пуле
+     */
+    struct TimerNode {
+        uint64_t deadline = 0;    ///< Тик срабатывания
+        uint64_t payload = 0;     ///< Пользовательские данные
+        uint32_t next = NIL;      ///< Следующий узел в ячейке (или в списке свободных)
+        uint32_t prev = NIL;      ///< Предыдущий узел в ячейке
+        uint32_t generation = 1;  ///< Поколение узла (защита от устаревших идентификаторов)
+        uint32_t bucket = NIL;    ///< Ячейка (уровень * SLOTS + слот), NIL - узел свободен
+    };
+
+    void insert(uint32_t index);
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+    void cascade(int level);
+
+    std::vector<TimerNode> nodes_;          ///< Пул узлов
+    uint32_t buckets_[LEVELS * SLOTS];      ///< Головы списков ячеек
+    size_t levelCounts_[LEVELS] = {};       ///< Таймеров на каждом уровне
+    uint32_t freeList_ = NIL;               ///< Список свободных узлов
+    uint64_t now_;                          ///< Текущий тик
+    size_t active_ = 0;                     ///< Активных таймеров
+};